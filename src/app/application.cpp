@@ -48,6 +48,7 @@
 #include <QDir>
 #include <QLibraryInfo>
 #include <QProcess>
+#include <QTimer>
 
 #ifndef DISABLE_GUI
 #include <QMessageBox>
@@ -64,6 +65,7 @@
 #include "base/bittorrent/infohash.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrent.h"
+#include "base/bittorrent/torrentcreationmanager.h"
 #include "base/exceptions.h"
 #include "base/iconprovider.h"
 #include "base/logger.h"
@@ -116,6 +118,8 @@ namespace
 
     const QString LOG_FOLDER = QStringLiteral("logs");
     const QChar PARAMS_SEPARATOR = '|';
+    // max number of torrents sent to the running instance in a single message
+    const int PARAMS_BATCH_SIZE = 50;
 
     const QString DEFAULT_PORTABLE_MODE_PROFILE_DIR = QStringLiteral("profile");
 
@@ -305,10 +309,30 @@ void Application::processMessage(const QString &message)
     const QStringList params = message.split(PARAMS_SEPARATOR, Qt::SkipEmptyParts);
     // If Application is not running (i.e., other
     // components are not ready) store params
-    if (m_running)
-        processParams(params);
-    else
+    if (!m_running)
+    {
         m_paramsQueue.append(params);
+        return;
+    }
+
+    // Messages may arrive in quick succession when another instance sends
+    // a large number of torrents, so process them one per event loop iteration
+    // to keep the application responsive.
+    m_pendingParams.enqueue(params);
+    if (m_pendingParams.size() == 1)
+        QTimer::singleShot(0, this, &Application::processPendingParams);
+}
+
+void Application::processPendingParams()
+{
+    if (m_pendingParams.isEmpty())
+        return;
+
+    processParams(m_pendingParams.head());
+    m_pendingParams.dequeue();
+
+    if (!m_pendingParams.isEmpty())
+        QTimer::singleShot(0, this, &Application::processPendingParams);
 }
 
 void Application::runExternalProgram(const BitTorrent::Torrent *torrent) const
@@ -528,7 +552,22 @@ void Application::allTorrentsFinished()
 
 bool Application::sendParams(const QStringList &params)
 {
-    return m_instanceManager->sendMessage(params.join(PARAMS_SEPARATOR));
+    // Options are placed at the beginning of the list (see QBtCommandLineParameters::paramList())
+    // and apply to all the torrents so each batch of torrents is sent along with them.
+    int optionsCount = 0;
+    while ((optionsCount < params.size()) && params[optionsCount].startsWith(QLatin1Char('@')))
+        ++optionsCount;
+    const QStringList options = params.mid(0, optionsCount);
+
+    QStringList messages;
+    for (int i = optionsCount; i < params.size(); i += PARAMS_BATCH_SIZE)
+        messages.append((options + params.mid(i, PARAMS_BATCH_SIZE)).join(PARAMS_SEPARATOR));
+
+    // no torrents, running instance is just asked to show itself
+    if (messages.isEmpty())
+        messages.append(options.join(PARAMS_SEPARATOR));
+
+    return m_instanceManager->sendMessages(messages);
 }
 
 // As program parameters, we can get paths or urls.
@@ -622,6 +661,7 @@ int Application::exec(const QStringList &params)
         connect(BitTorrent::Session::instance(), &BitTorrent::Session::torrentFinished, this, &Application::torrentFinished);
         connect(BitTorrent::Session::instance(), &BitTorrent::Session::allTorrentsFinished, this, &Application::allTorrentsFinished, Qt::QueuedConnection);
 
+        BitTorrent::TorrentCreationManager::initInstance();
         Net::GeoIPManager::initInstance();
         TorrentFilesWatcher::initInstance();
 
@@ -820,6 +860,7 @@ void Application::cleanup()
     delete RSS::Session::instance();
 
     TorrentFilesWatcher::freeInstance();
+    BitTorrent::TorrentCreationManager::freeInstance();
     BitTorrent::Session::freeInstance();
     Net::GeoIPManager::freeInstance();
     Net::DownloadManager::freeInstance();
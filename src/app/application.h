@@ -30,6 +30,7 @@
 #pragma once
 
 #include <QPointer>
+#include <QQueue>
 #include <QStringList>
 #include <QTranslator>
 
@@ -139,9 +140,11 @@ private:
     QTranslator m_qtTranslator;
     QTranslator m_translator;
     QStringList m_paramsQueue;
+    QQueue<QStringList> m_pendingParams;
 
     void initializeTranslation();
     void processParams(const QStringList &params);
+    void processPendingParams();
     void runExternalProgram(const BitTorrent::Torrent *torrent) const;
     void sendNotificationEmail(const BitTorrent::Torrent *torrent);
 };
@@ -80,6 +80,11 @@ bool ApplicationInstanceManager::sendMessage(const QString &message, const int t
     return m_peer->sendMessage(message, timeout);
 }
 
+bool ApplicationInstanceManager::sendMessages(const QStringList &messages, const int timeout)
+{
+    return m_peer->sendMessages(messages, timeout);
+}
+
 QString ApplicationInstanceManager::appId() const
 {
     return m_peer->applicationId();
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <QObject>
+#include <QStringList>
 
 class QtLocalPeer;
 
@@ -45,6 +46,9 @@ public:
 
 public slots:
     bool sendMessage(const QString &message, int timeout = 5000);
+    // Sends the messages one by one over a single connection.
+    // 'timeout' applies to each message individually.
+    bool sendMessages(const QStringList &messages, int timeout = 5000);
 
 signals:
     void messageReceived(const QString &message);
@@ -80,6 +80,7 @@
 #include <QLocalServer>
 #include <QLocalSocket>
 #include <QRegularExpression>
+#include <QtEndian>
 
 #include "base/utils/misc.h"
 
@@ -95,6 +96,8 @@ namespace QtLP_Private
 }
 
 const char* QtLocalPeer::ack = "ack";
+// drop suspiciously large data
+const quint32 QtLocalPeer::maxMessageSize = 1024 * 1024;
 
 QtLocalPeer::QtLocalPeer(QObject *parent, const QString &appId)
     : QObject(parent)
@@ -167,6 +170,13 @@ bool QtLocalPeer::isClient()
 }
 
 bool QtLocalPeer::sendMessage(const QString &message, const int timeout)
+{
+    return sendMessages(QStringList(message), timeout);
+}
+
+// Messages are sent over a single connection, each of them is prefixed by its length
+// and is acknowledged by the receiver before the next one is sent.
+bool QtLocalPeer::sendMessages(const QStringList &messages, const int timeout)
 {
     if (!isClient())
         return false;
@@ -191,17 +201,32 @@ bool QtLocalPeer::sendMessage(const QString &message, const int timeout)
     if (!connOk)
         return false;
 
-    QByteArray uMsg(message.toUtf8());
+    const qint64 ackSize = qstrlen(ack);
     QDataStream ds(&socket);
-    ds.writeBytes(uMsg.constData(), uMsg.size());
-    bool res = socket.waitForBytesWritten(timeout);
-    if (res)
+    for (const QString &message : messages)
     {
-        res &= socket.waitForReadyRead(timeout);   // wait for ack
-        if (res)
-            res &= (socket.read(qstrlen(ack)) == ack);
+        const QByteArray uMsg(message.toUtf8());
+        if (static_cast<quint32>(uMsg.size()) > maxMessageSize)
+            return false;
+
+        ds.writeBytes(uMsg.constData(), uMsg.size());
+        if (!socket.waitForBytesWritten(timeout))
+            return false;
+
+        // wait for ack
+        while (socket.bytesAvailable() < ackSize)
+        {
+            if (!socket.waitForReadyRead(timeout))
+                return false;
+        }
+        if (socket.read(ackSize) != ack)
+            return false;
     }
-    return res;
+
+    socket.disconnectFromServer();
+    if (socket.state() != QLocalSocket::UnconnectedState)
+        socket.waitForDisconnected(timeout);
+    return true;
 }
 
 QString QtLocalPeer::applicationId() const
@@ -211,53 +236,41 @@ QString QtLocalPeer::applicationId() const
 
 void QtLocalPeer::receiveConnection()
 {
-    QLocalSocket* socket = server->nextPendingConnection();
-    if (!socket)
-        return;
+    // Connections are served asynchronously so a client sending
+    // a lot of messages doesn't block the event loop
+    while (QLocalSocket *socket = server->nextPendingConnection())
+    {
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { readMessages(socket); });
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        readMessages(socket);
+    }
+}
 
-    while (true)
+void QtLocalPeer::readMessages(QLocalSocket *socket)
+{
+    while (socket->bytesAvailable() >= qint64(sizeof(quint32)))
     {
-        if (socket->state() == QLocalSocket::UnconnectedState)
+        quint32 size = 0;
+        socket->peek(reinterpret_cast<char *>(&size), sizeof(size));
+        size = qFromBigEndian(size);
+        if (size > maxMessageSize)
         {
-            qWarning("QtLocalPeer: Peer disconnected");
-            delete socket;
+            qWarning("QtLocalPeer: Message is too large (%u bytes), dropping connection", size);
+            socket->abort();
+            socket->deleteLater();
             return;
         }
-        if (socket->bytesAvailable() >= qint64(sizeof(quint32)))
-            break;
-        socket->waitForReadyRead();
-    }
 
-    QDataStream ds(socket);
-    QByteArray uMsg;
-    quint32 remaining;
-    ds >> remaining;
-    if (remaining > 65535)
-    {
-        // drop suspiciously large data
-        delete socket;
-        return;
-    }
+        // wait for the rest of the message
+        if (socket->bytesAvailable() < qint64(sizeof(quint32) + size))
+            return;
 
-    uMsg.resize(remaining);
-    int got = 0;
-    char* uMsgBuf = uMsg.data();
-    do
-    {
-        got = ds.readRawData(uMsgBuf, remaining);
-        remaining -= got;
-        uMsgBuf += got;
-    } while (remaining && got >= 0 && socket->waitForReadyRead(2000));
-    if (got < 0)
-    {
-        qWarning("QtLocalPeer: Message reception failed %s", socket->errorString().toLatin1().constData());
-        delete socket;
-        return;
+        socket->skip(sizeof(quint32));
+        const QByteArray uMsg = socket->read(size);
+        socket->write(ack, qstrlen(ack));
+        emit messageReceived(QString::fromUtf8(uMsg));
     }
-    QString message(QString::fromUtf8(uMsg));
-    socket->write(ack, qstrlen(ack));
-    socket->waitForBytesWritten(1000);
-    socket->waitForDisconnected(1000); // make sure client reads ack
-    delete socket;
-    emit messageReceived(message); //### (might take a long time to return)
+
+    if (socket->state() == QLocalSocket::UnconnectedState)
+        socket->deleteLater();
 }
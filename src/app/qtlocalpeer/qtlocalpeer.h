@@ -68,9 +68,12 @@
 
 #pragma once
 
+#include <QStringList>
+
 #include "qtlockedfile.h"
 
 class QLocalServer;
+class QLocalSocket;
 
 class QtLocalPeer : public QObject
 {
@@ -82,6 +85,7 @@ public:
 
     bool isClient();
     bool sendMessage(const QString &message, int timeout);
+    bool sendMessages(const QStringList &messages, int timeout);
     QString applicationId() const;
 
 signals:
@@ -90,6 +94,9 @@ signals:
 protected slots:
     void receiveConnection();
 
+protected:
+    void readMessages(QLocalSocket *socket);
+
 protected:
     QString id;
     QString socketName;
@@ -98,4 +105,5 @@ protected:
 
 private:
     static const char* ack;
+    static const quint32 maxMessageSize;
 };
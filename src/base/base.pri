@@ -22,6 +22,7 @@ HEADERS += \
     $$PWD/bittorrent/peeraddress.h \
     $$PWD/bittorrent/peerinfo.h \
     $$PWD/bittorrent/portforwarderimpl.h \
+    $$PWD/bittorrent/recheckscheduler.h \
     $$PWD/bittorrent/resumedatastorage.h \
     $$PWD/bittorrent/scheduler/bandwidthscheduler.h \
     $$PWD/bittorrent/scheduler/scheduleday.h \
@@ -32,11 +33,14 @@ HEADERS += \
     $$PWD/bittorrent/statistics.h \
     $$PWD/bittorrent/torrent.h \
     $$PWD/bittorrent/torrentcontentlayout.h \
+    $$PWD/bittorrent/torrentcreationmanager.h \
     $$PWD/bittorrent/torrentcreatorthread.h \
+    $$PWD/bittorrent/torrentfileworker.h \
     $$PWD/bittorrent/torrentimpl.h \
     $$PWD/bittorrent/torrentinfo.h \
     $$PWD/bittorrent/tracker.h \
     $$PWD/bittorrent/trackerentry.h \
+    $$PWD/bittorrent/transferhistory.h \
     $$PWD/digest32.h \
     $$PWD/exceptions.h \
     $$PWD/global.h \
@@ -50,7 +54,9 @@ HEADERS += \
     $$PWD/http/types.h \
     $$PWD/iconprovider.h \
     $$PWD/indexrange.h \
+    $$PWD/latencystats.h \
     $$PWD/logger.h \
+    $$PWD/memorystats.h \
     $$PWD/net/dnsupdater.h \
     $$PWD/net/downloadhandlerimpl.h \
     $$PWD/net/downloadmanager.h \
@@ -65,6 +71,7 @@ HEADERS += \
     $$PWD/profile.h \
     $$PWD/profile_p.h \
     $$PWD/rss/rss_article.h \
+    $$PWD/rss/rss_articlestorage.h \
     $$PWD/rss/rss_autodownloader.h \
     $$PWD/rss/rss_autodownloadrule.h \
     $$PWD/rss/rss_feed.h \
@@ -83,6 +90,7 @@ HEADERS += \
     $$PWD/torrentfilter.h \
     $$PWD/types.h \
     $$PWD/unicodestrings.h \
+    $$PWD/utils/bitfield.h \
     $$PWD/utils/bytearray.h \
     $$PWD/utils/compare.h \
     $$PWD/utils/foreignapps.h \
@@ -113,6 +121,7 @@ SOURCES += \
     $$PWD/bittorrent/peeraddress.cpp \
     $$PWD/bittorrent/peerinfo.cpp \
     $$PWD/bittorrent/portforwarderimpl.cpp \
+    $$PWD/bittorrent/recheckscheduler.cpp \
     $$PWD/bittorrent/scheduler/bandwidthscheduler.cpp \
     $$PWD/bittorrent/scheduler/scheduleday.cpp \
     $$PWD/bittorrent/scheduler/scheduleentry.cpp \
@@ -120,11 +129,14 @@ SOURCES += \
     $$PWD/bittorrent/speedmonitor.cpp \
     $$PWD/bittorrent/statistics.cpp \
     $$PWD/bittorrent/torrent.cpp \
+    $$PWD/bittorrent/torrentcreationmanager.cpp \
     $$PWD/bittorrent/torrentcreatorthread.cpp \
+    $$PWD/bittorrent/torrentfileworker.cpp \
     $$PWD/bittorrent/torrentimpl.cpp \
     $$PWD/bittorrent/torrentinfo.cpp \
     $$PWD/bittorrent/tracker.cpp \
     $$PWD/bittorrent/trackerentry.cpp \
+    $$PWD/bittorrent/transferhistory.cpp \
     $$PWD/exceptions.cpp \
     $$PWD/http/connection.cpp \
     $$PWD/http/httperror.cpp \
@@ -133,7 +145,9 @@ SOURCES += \
     $$PWD/http/responsegenerator.cpp \
     $$PWD/http/server.cpp \
     $$PWD/iconprovider.cpp \
+    $$PWD/latencystats.cpp \
     $$PWD/logger.cpp \
+    $$PWD/memorystats.cpp \
     $$PWD/net/dnsupdater.cpp \
     $$PWD/net/downloadhandlerimpl.cpp \
     $$PWD/net/downloadmanager.cpp \
@@ -147,6 +161,7 @@ SOURCES += \
     $$PWD/profile.cpp \
     $$PWD/profile_p.cpp \
     $$PWD/rss/rss_article.cpp \
+    $$PWD/rss/rss_articlestorage.cpp \
     $$PWD/rss/rss_autodownloader.cpp \
     $$PWD/rss/rss_autodownloadrule.cpp \
     $$PWD/rss/rss_feed.cpp \
@@ -162,6 +177,7 @@ SOURCES += \
     $$PWD/torrentfileguard.cpp \
     $$PWD/torrentfileswatcher.cpp \
     $$PWD/torrentfilter.cpp \
+    $$PWD/utils/bitfield.cpp \
     $$PWD/utils/bytearray.cpp \
     $$PWD/utils/compare.cpp \
     $$PWD/utils/foreignapps.cpp \
@@ -35,12 +35,18 @@
 #include <libtorrent/write_resume_data.hpp>
 
 #include <QByteArray>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QMutex>
 #include <QRegularExpression>
+#include <QSet>
 #include <QThread>
+#include <QThreadPool>
 
 #include "base/algorithm.h"
 #include "base/exceptions.h"
 #include "base/global.h"
+#include "base/latencystats.h"
 #include "base/logger.h"
 #include "base/profile.h"
 #include "base/tagset.h"
@@ -59,7 +65,8 @@ namespace BitTorrent
     public:
         explicit Worker(const QDir &resumeDataDir);
 
-        void store(const TorrentID &id, const LoadTorrentParams &resumeData) const;
+        bool store(const TorrentID &id, const LoadTorrentParams &resumeData) const;
+        QSet<TorrentID> storeBatch(const QHash<TorrentID, LoadTorrentParams> &resumeData, const QDeadlineTimer &deadline) const;
         void remove(const TorrentID &id) const;
         void storeQueue(const QVector<TorrentID> &queue) const;
 
@@ -241,14 +248,31 @@ std::optional<BitTorrent::LoadTorrentParams> BitTorrent::BencodeResumeDataStorag
     return torrentParams;
 }
 
-void BitTorrent::BencodeResumeDataStorage::store(const TorrentID &id, const LoadTorrentParams &resumeData) const
+void BitTorrent::BencodeResumeDataStorage::store(const TorrentID &id, const LoadTorrentParams &resumeData)
 {
     QMetaObject::invokeMethod(m_asyncWorker, [this, id, resumeData]()
     {
-        m_asyncWorker->store(id, resumeData);
+        const bool isStored = m_asyncWorker->store(id, resumeData);
+        QMetaObject::invokeMethod(this, [this, id, isStored]()
+        {
+            emit resumeDataStored(id, isStored);
+        });
     });
 }
 
+QSet<BitTorrent::TorrentID> BitTorrent::BencodeResumeDataStorage::storeBatch(const QHash<TorrentID, LoadTorrentParams> &resumeData
+    , const QDeadlineTimer &deadline) const
+{
+    // It is queued after the pending jobs, so they are applied in the right order
+    QSet<TorrentID> storedTorrents;
+    QMetaObject::invokeMethod(m_asyncWorker, [this, &resumeData, &deadline, &storedTorrents]()
+    {
+        storedTorrents = m_asyncWorker->storeBatch(resumeData, deadline);
+    }, Qt::BlockingQueuedConnection);
+
+    return storedTorrents;
+}
+
 void BitTorrent::BencodeResumeDataStorage::remove(const TorrentID &id) const
 {
     QMetaObject::invokeMethod(m_asyncWorker, [this, id]()
@@ -303,8 +327,10 @@ BitTorrent::BencodeResumeDataStorage::Worker::Worker(const QDir &resumeDataDir)
 {
 }
 
-void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, const LoadTorrentParams &resumeData) const
+bool BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, const LoadTorrentParams &resumeData) const
 {
+    QBT_MEASURE_LATENCY("resumeData/store");
+
     // We need to adjust native libtorrent resume data
     lt::add_torrent_params p = resumeData.ltAddTorrentParams;
     p.save_path = Profile::instance()->toPortablePath(QString::fromStdString(p.save_path)).toStdString();
@@ -347,7 +373,7 @@ void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, co
         {
             LogMsg(tr("Couldn't save torrent metadata to '%1'. Error: %2.")
                    .arg(torrentFilepath, result.error()), Log::CRITICAL);
-            return;
+            return false;
         }
     }
 
@@ -367,7 +393,36 @@ void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, co
     {
         LogMsg(tr("Couldn't save torrent resume data to '%1'. Error: %2.")
                .arg(resumeFilepath, result.error()), Log::CRITICAL);
+        return false;
+    }
+
+    return true;
+}
+
+QSet<BitTorrent::TorrentID> BitTorrent::BencodeResumeDataStorage::Worker::storeBatch(const QHash<TorrentID, LoadTorrentParams> &resumeData
+    , const QDeadlineTimer &deadline) const
+{
+    // Every torrent has its own files, so they can be written simultaneously
+    QSet<TorrentID> storedTorrents;
+    QMutex mutex;
+    QThreadPool threadPool;
+    for (auto it = resumeData.cbegin(); it != resumeData.cend(); ++it)
+    {
+        threadPool.start([this, it, &deadline, &storedTorrents, &mutex]()
+        {
+            if (deadline.hasExpired())
+                return;
+
+            if (store(it.key(), it.value()))
+            {
+                const QMutexLocker locker {&mutex};
+                storedTorrents.insert(it.key());
+            }
+        });
     }
+    threadPool.waitForDone();
+
+    return storedTorrents;
 }
 
 void BitTorrent::BencodeResumeDataStorage::Worker::remove(const TorrentID &id) const
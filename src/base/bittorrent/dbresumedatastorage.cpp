@@ -36,16 +36,20 @@
 #include <libtorrent/write_resume_data.hpp>
 
 #include <QByteArray>
+#include <QDeadlineTimer>
 #include <QFile>
+#include <QHash>
 #include <QSet>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QThread>
+#include <QThreadPool>
 #include <QVector>
 
 #include "base/exceptions.h"
 #include "base/global.h"
+#include "base/latencystats.h"
 #include "base/logger.h"
 #include "base/profile.h"
 #include "base/utils/fs.h"
@@ -165,11 +169,22 @@ namespace BitTorrent
         void openDatabase() const;
         void closeDatabase() const;
 
-        void store(const TorrentID &id, const LoadTorrentParams &resumeData) const;
+        bool store(const TorrentID &id, const LoadTorrentParams &resumeData) const;
+        QSet<TorrentID> storeBatch(const QHash<TorrentID, LoadTorrentParams> &resumeData, const QDeadlineTimer &deadline) const;
         void remove(const TorrentID &id) const;
         void storeQueue(const QVector<TorrentID> &queue) const;
 
     private:
+        struct EncodedResumeData
+        {
+            QByteArray resumeData;
+            QByteArray metadata;
+        };
+
+        // Can be called from any thread
+        std::optional<EncodedResumeData> encode(const LoadTorrentParams &resumeData) const;
+        bool write(const TorrentID &id, const LoadTorrentParams &resumeData, const EncodedResumeData &encodedData) const;
+
         const QString m_path;
         const QString m_connectionName;
     };
@@ -305,14 +320,31 @@ std::optional<BitTorrent::LoadTorrentParams> BitTorrent::DBResumeDataStorage::lo
     return resumeData;
 }
 
-void BitTorrent::DBResumeDataStorage::store(const TorrentID &id, const LoadTorrentParams &resumeData) const
+void BitTorrent::DBResumeDataStorage::store(const TorrentID &id, const LoadTorrentParams &resumeData)
 {
     QMetaObject::invokeMethod(m_asyncWorker, [this, id, resumeData]()
     {
-        m_asyncWorker->store(id, resumeData);
+        const bool isStored = m_asyncWorker->store(id, resumeData);
+        QMetaObject::invokeMethod(this, [this, id, isStored]()
+        {
+            emit resumeDataStored(id, isStored);
+        });
     });
 }
 
+QSet<BitTorrent::TorrentID> BitTorrent::DBResumeDataStorage::storeBatch(const QHash<TorrentID, LoadTorrentParams> &resumeData
+    , const QDeadlineTimer &deadline) const
+{
+    // It is queued after the pending jobs, so they are applied in the right order
+    QSet<TorrentID> storedTorrents;
+    QMetaObject::invokeMethod(m_asyncWorker, [this, &resumeData, &deadline, &storedTorrents]()
+    {
+        storedTorrents = m_asyncWorker->storeBatch(resumeData, deadline);
+    }, Qt::BlockingQueuedConnection);
+
+    return storedTorrents;
+}
+
 void BitTorrent::DBResumeDataStorage::remove(const BitTorrent::TorrentID &id) const
 {
     QMetaObject::invokeMethod(m_asyncWorker, [this, id]()
@@ -410,7 +442,63 @@ void BitTorrent::DBResumeDataStorage::Worker::closeDatabase() const
     QSqlDatabase::removeDatabase(m_connectionName);
 }
 
-void BitTorrent::DBResumeDataStorage::Worker::store(const TorrentID &id, const LoadTorrentParams &resumeData) const
+bool BitTorrent::DBResumeDataStorage::Worker::store(const TorrentID &id, const LoadTorrentParams &resumeData) const
+{
+    QBT_MEASURE_LATENCY("resumeData/store");
+
+    const std::optional<EncodedResumeData> encodedData = encode(resumeData);
+    if (!encodedData)
+        return false;
+
+    return write(id, resumeData, *encodedData);
+}
+
+QSet<BitTorrent::TorrentID> BitTorrent::DBResumeDataStorage::Worker::storeBatch(const QHash<TorrentID, LoadTorrentParams> &resumeData
+    , const QDeadlineTimer &deadline) const
+{
+    // Encoding is the expensive part and it doesn't need the database, so it is done simultaneously
+    const QVector<TorrentID> torrentIDs = resumeData.keys().toVector();
+    QVector<std::optional<EncodedResumeData>> encodedData(torrentIDs.size());
+    std::optional<EncodedResumeData> *encodedDataItems = encodedData.data();
+    QThreadPool threadPool;
+    for (int i = 0; i < torrentIDs.size(); ++i)
+    {
+        const LoadTorrentParams &torrentResumeData = resumeData.constFind(torrentIDs[i]).value();
+        threadPool.start([this, &torrentResumeData, &deadline, encodedDataItem = (encodedDataItems + i)]()
+        {
+            if (!deadline.hasExpired())
+                *encodedDataItem = encode(torrentResumeData);
+        });
+    }
+    threadPool.waitForDone();
+
+    // All the rows are written in a single transaction
+    QSet<TorrentID> storedTorrents;
+    auto db = QSqlDatabase::database(m_connectionName);
+    if (!db.transaction())
+    {
+        LogMsg(tr("Couldn't begin transaction. Error: %1").arg(db.lastError().text()), Log::CRITICAL);
+        return storedTorrents;
+    }
+
+    for (int i = 0; i < torrentIDs.size(); ++i)
+    {
+        const TorrentID &torrentID = torrentIDs[i];
+        if (encodedData[i] && write(torrentID, resumeData.constFind(torrentID).value(), *encodedData[i]))
+            storedTorrents.insert(torrentID);
+    }
+
+    if (!db.commit())
+    {
+        LogMsg(tr("Couldn't store resume data. Error: %1").arg(db.lastError().text()), Log::CRITICAL);
+        db.rollback();
+        return {};
+    }
+
+    return storedTorrents;
+}
+
+std::optional<BitTorrent::DBResumeDataStorage::Worker::EncodedResumeData> BitTorrent::DBResumeDataStorage::Worker::encode(const LoadTorrentParams &resumeData) const
 {
     // We need to adjust native libtorrent resume data
     lt::add_torrent_params p = resumeData.ltAddTorrentParams;
@@ -435,26 +523,11 @@ void BitTorrent::DBResumeDataStorage::Worker::store(const TorrentID &id, const L
         }
     }
 
-    QVector<Column> columns {
-        DB_COLUMN_TORRENT_ID,
-        DB_COLUMN_NAME,
-        DB_COLUMN_CATEGORY,
-        DB_COLUMN_TAGS,
-        DB_COLUMN_TARGET_SAVE_PATH,
-        DB_COLUMN_CONTENT_LAYOUT,
-        DB_COLUMN_RATIO_LIMIT,
-        DB_COLUMN_SEEDING_TIME_LIMIT,
-        DB_COLUMN_HAS_OUTER_PIECES_PRIORITY,
-        DB_COLUMN_HAS_SEED_STATUS,
-        DB_COLUMN_OPERATING_MODE,
-        DB_COLUMN_STOPPED,
-        DB_COLUMN_RESUMEDATA
-    };
-
     lt::entry data = lt::write_resume_data(p);
 
+    EncodedResumeData encodedData;
+
     // metadata is stored in separate column
-    QByteArray bencodedMetadata;
     if (p.ti)
     {
         lt::entry::dictionary_type &dataDict = data.dict();
@@ -467,22 +540,43 @@ void BitTorrent::DBResumeDataStorage::Worker::store(const TorrentID &id, const L
 
         try
         {
-            bencodedMetadata.reserve(512 * 1024);
-            lt::bencode(std::back_inserter(bencodedMetadata), metadata);
+            encodedData.metadata.reserve(512 * 1024);
+            lt::bencode(std::back_inserter(encodedData.metadata), metadata);
         }
         catch (const std::exception &err)
         {
             LogMsg(tr("Couldn't save torrent metadata. Error: %1.")
                    .arg(QString::fromLocal8Bit(err.what())), Log::CRITICAL);
-            return;
+            return std::nullopt;
         }
-
-        columns.append(DB_COLUMN_METADATA);
     }
 
-    QByteArray bencodedResumeData;
-    bencodedResumeData.reserve(256 * 1024);
-    lt::bencode(std::back_inserter(bencodedResumeData), data);
+    encodedData.resumeData.reserve(256 * 1024);
+    lt::bencode(std::back_inserter(encodedData.resumeData), data);
+
+    return encodedData;
+}
+
+bool BitTorrent::DBResumeDataStorage::Worker::write(const TorrentID &id, const LoadTorrentParams &resumeData
+    , const EncodedResumeData &encodedData) const
+{
+    QVector<Column> columns {
+        DB_COLUMN_TORRENT_ID,
+        DB_COLUMN_NAME,
+        DB_COLUMN_CATEGORY,
+        DB_COLUMN_TAGS,
+        DB_COLUMN_TARGET_SAVE_PATH,
+        DB_COLUMN_CONTENT_LAYOUT,
+        DB_COLUMN_RATIO_LIMIT,
+        DB_COLUMN_SEEDING_TIME_LIMIT,
+        DB_COLUMN_HAS_OUTER_PIECES_PRIORITY,
+        DB_COLUMN_HAS_SEED_STATUS,
+        DB_COLUMN_OPERATING_MODE,
+        DB_COLUMN_STOPPED,
+        DB_COLUMN_RESUMEDATA
+    };
+    if (!encodedData.metadata.isEmpty())
+        columns.append(DB_COLUMN_METADATA);
 
     const QString insertTorrentStatement = makeInsertStatement(DB_TABLE_TORRENTS, columns)
             + makeOnConflictUpdateStatement(DB_COLUMN_TORRENT_ID, columns);
@@ -507,9 +601,9 @@ void BitTorrent::DBResumeDataStorage::Worker::store(const TorrentID &id, const L
         query.bindValue(DB_COLUMN_HAS_SEED_STATUS.placeholder, resumeData.hasSeedStatus);
         query.bindValue(DB_COLUMN_OPERATING_MODE.placeholder, Utils::String::fromEnum(resumeData.operatingMode));
         query.bindValue(DB_COLUMN_STOPPED.placeholder, resumeData.stopped);
-        query.bindValue(DB_COLUMN_RESUMEDATA.placeholder, bencodedResumeData);
-        if (!bencodedMetadata.isEmpty())
-            query.bindValue(DB_COLUMN_METADATA.placeholder, bencodedMetadata);
+        query.bindValue(DB_COLUMN_RESUMEDATA.placeholder, encodedData.resumeData);
+        if (!encodedData.metadata.isEmpty())
+            query.bindValue(DB_COLUMN_METADATA.placeholder, encodedData.metadata);
 
         if (!query.exec())
             throw RuntimeError(query.lastError().text());
@@ -518,7 +612,10 @@ void BitTorrent::DBResumeDataStorage::Worker::store(const TorrentID &id, const L
     {
         LogMsg(tr("Couldn't store resume data for torrent '%1'. Error: %2")
             .arg(id.toString(), err.message()), Log::CRITICAL);
+        return false;
     }
+
+    return true;
 }
 
 void BitTorrent::DBResumeDataStorage::Worker::remove(const TorrentID &id) const
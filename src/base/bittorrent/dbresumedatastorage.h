@@ -45,7 +45,8 @@ namespace BitTorrent
 
         QVector<TorrentID> registeredTorrents() const override;
         std::optional<LoadTorrentParams> load(const TorrentID &id) const override;
-        void store(const TorrentID &id, const LoadTorrentParams &resumeData) const override;
+        void store(const TorrentID &id, const LoadTorrentParams &resumeData) override;
+        QSet<TorrentID> storeBatch(const QHash<TorrentID, LoadTorrentParams> &resumeData, const QDeadlineTimer &deadline) const override;
         void remove(const TorrentID &id) const override;
         void storeQueue(const QVector<TorrentID> &queue) const override;
 
@@ -29,41 +29,157 @@
 #include "filesearcher.h"
 
 #include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutexLocker>
+#include <QStringList>
 
 #include "base/bittorrent/common.h"
 #include "base/bittorrent/infohash.h"
+#include "base/global.h"
+
+namespace
+{
+    const int MAX_CONCURRENT_SEARCHES = 4;
+    const int MAX_CACHED_DIRECTORIES = 4096;
+    // Coarsest modification time resolution of the common file systems (FAT), in ms
+    const qint64 MAX_MTIME_GRANULARITY = 2000;
+
+    QString toEntryKey(const QString &fileName, const bool isCaseSensitive)
+    {
+        return isCaseSensitive ? fileName : fileName.toLower();
+    }
+
+    QString swapCase(QString name)
+    {
+        for (QChar &c : name)
+            c = c.isUpper() ? c.toLower() : c.toUpper();
+        return name;
+    }
+
+    // Case sensitivity depends on the file system (and even on its options)
+    // rather than on the OS, so it is checked by looking up one of the directory
+    // entries with the case of its letters swapped
+    bool isCaseSensitiveDir(const QString &dirPath, const QStringList &entryNames)
+    {
+        for (const QString &entryName : entryNames)
+        {
+            const QString swappedName = swapCase(entryName);
+            if (swappedName == entryName)
+                continue;
+
+            // case-insensitive file system can't contain both of them
+            if (entryNames.contains(swappedName))
+                return true;
+
+            return !QFileInfo::exists(dirPath + QLatin1Char('/') + swappedName);
+        }
+
+        // there are no names whose lookup would depend on the case
+        return true;
+    }
+}
+
+FileSearcher::FileSearcher()
+    : m_directoryCache {MAX_CACHED_DIRECTORIES}
+{
+    m_threadPool.setMaxThreadCount(MAX_CONCURRENT_SEARCHES);
+}
+
+FileSearcher::~FileSearcher()
+{
+    m_threadPool.clear();
+    m_threadPool.waitForDone();
+}
 
 void FileSearcher::search(const BitTorrent::TorrentID &id, const QStringList &originalFileNames
                           , const QString &completeSavePath, const QString &incompleteSavePath)
 {
-    const auto findInDir = [](const QString &dirPath, QStringList &fileNames) -> bool
+    m_threadPool.start([this, id, originalFileNames, completeSavePath, incompleteSavePath]()
     {
-        const QDir dir {dirPath};
-        bool found = false;
-        for (QString &fileName : fileNames)
+        QString savePath = completeSavePath;
+        QStringList adjustedFileNames = originalFileNames;
+        const bool found = findInDir(savePath, adjustedFileNames);
+        if (!found && !incompleteSavePath.isEmpty())
         {
-            if (dir.exists(fileName))
-            {
-                found = true;
-            }
-            else if (dir.exists(fileName + QB_EXT))
-            {
-                found = true;
-                fileName += QB_EXT;
-            }
+            savePath = incompleteSavePath;
+            findInDir(savePath, adjustedFileNames);
         }
 
-        return found;
-    };
+        emit searchFinished(id, savePath, adjustedFileNames);
+    });
+}
+
+bool FileSearcher::findInDir(const QString &dirPath, QStringList &fileNames)
+{
+    // Every directory is listed once instead of checking each file separately
+    QHash<QString, DirectoryListing> listings;
+    bool found = false;
+    for (QString &fileName : fileNames)
+    {
+        const int separatorPos = fileName.lastIndexOf(QLatin1Char('/'));
+        const QString parentPath = (separatorPos >= 0)
+            ? (dirPath + QLatin1Char('/') + fileName.left(separatorPos)) : dirPath;
+
+        auto listingIter = listings.find(parentPath);
+        if (listingIter == listings.end())
+            listingIter = listings.insert(parentPath, listDirectory(parentPath));
+
+        const QString entryName = fileName.mid(separatorPos + 1);
+        const bool isCaseSensitive = listingIter->isCaseSensitive;
+        if (listingIter->entryNames.contains(toEntryKey(entryName, isCaseSensitive)))
+        {
+            found = true;
+        }
+        else if (listingIter->entryNames.contains(toEntryKey((entryName + QB_EXT), isCaseSensitive)))
+        {
+            found = true;
+            fileName += QB_EXT;
+        }
+    }
+
+    return found;
+}
+
+FileSearcher::DirectoryListing FileSearcher::listDirectory(const QString &dirPath)
+{
+    const QFileInfo dirInfo {dirPath};
+    if (!dirInfo.isDir())
+        return {};
+
+    const QDateTime lastModified = dirInfo.lastModified();
+    {
+        const QMutexLocker locker {&m_directoryCacheMutex};
+        const DirectoryListing *cachedListing = m_directoryCache.object(dirPath);
+        if (cachedListing && (cachedListing->lastModified == lastModified))
+            return *cachedListing;
+    }
+
+    const QDateTime listingTime = QDateTime::currentDateTimeUtc();
+
+    QStringList fileNames;
+    QDirIterator dirIter {dirPath, (QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot)};
+    while (dirIter.hasNext())
+    {
+        dirIter.next();
+        fileNames.append(dirIter.fileName());
+    }
+
+    DirectoryListing listing;
+    listing.lastModified = lastModified;
+    listing.isCaseSensitive = isCaseSensitiveDir(dirPath, fileNames);
+    listing.entryNames.reserve(fileNames.size());
+    for (const QString &fileName : asConst(fileNames))
+        listing.entryNames.insert(toEntryKey(fileName, listing.isCaseSensitive));
 
-    QString savePath = completeSavePath;
-    QStringList adjustedFileNames = originalFileNames;
-    const bool found = findInDir(savePath, adjustedFileNames);
-    if (!found && !incompleteSavePath.isEmpty())
+    // Entries added later within the same modification time tick wouldn't change it,
+    // so such a listing can't be validated by the modification time
+    if (lastModified.msecsTo(listingTime) > MAX_MTIME_GRANULARITY)
     {
-        savePath = incompleteSavePath;
-        findInDir(savePath, adjustedFileNames);
+        const QMutexLocker locker {&m_directoryCacheMutex};
+        m_directoryCache.insert(dirPath, new DirectoryListing {listing});
     }
 
-    emit searchFinished(id, savePath, adjustedFileNames);
+    return listing;
 }
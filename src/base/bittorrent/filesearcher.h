@@ -28,7 +28,12 @@
 
 #pragma once
 
+#include <QCache>
+#include <QDateTime>
+#include <QMutex>
 #include <QObject>
+#include <QSet>
+#include <QThreadPool>
 
 namespace BitTorrent
 {
@@ -41,7 +46,8 @@ class FileSearcher final : public QObject
     Q_DISABLE_COPY_MOVE(FileSearcher)
 
 public:
-    FileSearcher() = default;
+    FileSearcher();
+    ~FileSearcher() override;
 
 public slots:
     void search(const BitTorrent::TorrentID &id, const QStringList &originalFileNames
@@ -49,4 +55,22 @@ public slots:
 
 signals:
     void searchFinished(const BitTorrent::TorrentID &id, const QString &savePath, const QStringList &fileNames);
+
+private:
+    struct DirectoryListing
+    {
+        QDateTime lastModified;
+        // Entry names are lowercased if the file system ignores case
+        bool isCaseSensitive = true;
+        QSet<QString> entryNames;
+    };
+
+    bool findInDir(const QString &dirPath, QStringList &fileNames);
+    DirectoryListing listDirectory(const QString &dirPath);
+
+    // Searches of different torrents run concurrently
+    QThreadPool m_threadPool;
+    // Directory listings are reused while the directory is unchanged
+    QMutex m_directoryCacheMutex;
+    QCache<QString, DirectoryListing> m_directoryCache;
 };
@@ -28,14 +28,55 @@
 
 #include "filterparserthread.h"
 
+#include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <utility>
+#include <vector>
 
 #include <libtorrent/error_code.hpp>
 
+#include <QByteArray>
 #include <QDataStream>
+#include <QDateTime>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QThreadPool>
 
 #include "base/logger.h"
+#include "base/profile.h"
+#include "base/utils/io.h"
+
+// Blocked ranges collected from the filter file
+struct IPFilterRanges
+{
+    using IPv4Range = std::pair<quint32, quint32>;
+    using IPv6Range = std::pair<lt::address_v6::bytes_type, lt::address_v6::bytes_type>;
+
+    std::vector<IPv4Range> v4;
+    std::vector<IPv6Range> v6;
+    int ruleCount = 0;
+
+    void addIPv4(const quint32 first, const quint32 last)
+    {
+        v4.emplace_back(first, last);
+        ++ruleCount;
+    }
+
+    void add(const lt::address &first, const lt::address &last)
+    {
+        if (first.is_v4())
+        {
+            addIPv4(first.to_v4().to_uint(), last.to_v4().to_uint());
+        }
+        else
+        {
+            v6.emplace_back(first.to_v6().to_bytes(), last.to_v6().to_bytes());
+            ++ruleCount;
+        }
+    }
+};
 
 namespace
 {
@@ -104,338 +145,302 @@ namespace
         return !ec;
     }
 
-    const int BUFFER_SIZE = 2 * 1024 * 1024; // 2 MiB
     const int MAX_LOGGED_ERRORS = 5;
-}
+    // Text filter files are split into chunks of at least this size to be parsed in parallel
+    const int MIN_CHUNK_SIZE = 1024 * 1024; // 1 MiB
 
-FilterParserThread::FilterParserThread(QObject *parent)
-    : QThread(parent)
-    , m_abort(false)
-{
-}
-
-FilterParserThread::~FilterParserThread()
-{
-    m_abort = true;
-    wait();
-}
-
-// Parser for eMule ip filter in DAT format
-int FilterParserThread::parseDATFilterFile()
-{
-    int ruleCount = 0;
-    QFile file(m_filePath);
-    if (!file.exists()) return ruleCount;
+    const char CACHE_FILE_NAME[] = "ipfilter.cache";
+    const char CACHE_MAGIC[] = "qBittorrent IP filter cache";
+    const qint32 CACHE_VERSION = 1;
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    enum class LineStatus
     {
-        LogMsg(tr("I/O Error: Could not open IP filter file in read mode."), Log::CRITICAL);
-        return ruleCount;
-    }
+        Valid,
+        Ignored,
+        Malformed,
+        MalformedStartIP,
+        MalformedEndIP,
+        MixedIPVersions
+    };
 
-    std::vector<char> buffer(BUFFER_SIZE, 0); // seems a bit faster than QVector
-    qint64 bytesRead = 0;
-    int offset = 0;
-    int start = 0;
-    int endOfLine = -1;
-    int nbLine = 0;
-    int parseErrorCount = 0;
-    const auto addLog = [&parseErrorCount](const QString &msg)
+    using LineParser = LineStatus (*)(char *line, int length, lt::address &first, lt::address &last);
+
+    struct ChunkParsingResult
     {
-        if (parseErrorCount <= MAX_LOGGED_ERRORS)
-            LogMsg(msg, Log::CRITICAL);
+        IPFilterRanges ranges;
+        int lineCount = 0;
+        std::vector<std::pair<int, LineStatus>> errors; // <line number within chunk, error>
     };
 
-    while (true)
+    int findAndNullDelimiter(char *const data, const char delimiter, const int start, const int end, const bool reverse = false)
     {
-        bytesRead = file.read(buffer.data() + offset, BUFFER_SIZE - offset - 1);
-        if (bytesRead < 0)
-            break;
-        const int dataSize = bytesRead + offset;
-        if ((bytesRead == 0) && (dataSize == 0))
-            break;
-
-        for (start = 0; start < dataSize; ++start)
+        if (!reverse)
         {
-            endOfLine = -1;
-            // The file might have ended without the last line having a newline
-            if (!((bytesRead == 0) && (dataSize > 0)))
+            for (int i = start; i <= end; ++i)
             {
-                for (int i = start; i < dataSize; ++i)
+                if (data[i] == delimiter)
                 {
-                    if (buffer[i] == '\n')
-                    {
-                        endOfLine = i;
-                        // We need to NULL the newline in case the line has only an IP range.
-                        // In that case the parser won't work for the end IP, because it ends
-                        // with the newline and not with a number.
-                        buffer[i] = '\0';
-                        break;
-                    }
+                    data[i] = '\0';
+                    return i;
                 }
             }
-            else
-            {
-                endOfLine = dataSize;
-                buffer[dataSize] = '\0';
-            }
-
-            if (endOfLine == -1)
+        }
+        else
+        {
+            for (int i = end; i >= start; --i)
             {
-                // read the next chunk from file
-                // but first move(copy) the leftover data to the front of the buffer
-                offset = dataSize - start;
-                memmove(buffer.data(), buffer.data() + start, offset);
-                break;
-            }
-
-            ++nbLine;
-
-            if ((buffer[start] == '#')
-                || ((buffer[start] == '/') && ((start + 1 < dataSize) && (buffer[start + 1] == '/'))))
+                if (data[i] == delimiter)
                 {
-                start = endOfLine;
-                continue;
+                    data[i] = '\0';
+                    return i;
+                }
             }
+        }
 
-            // Each line should follow this format:
-            // 001.009.096.105 - 001.009.096.105 , 000 , Some organization
-            // The 3rd entry is access level and if above 127 the IP range isn't blocked.
-            const int firstComma = findAndNullDelimiter(buffer.data(), ',', start, endOfLine);
-            if (firstComma != -1)
-                findAndNullDelimiter(buffer.data(), ',', firstComma + 1, endOfLine);
+        return -1;
+    }
 
-            // Check if there is an access value (apparently not mandatory)
-            if (firstComma != -1)
-            {
-                // There is possibly one
-                const long int nbAccess = strtol(buffer.data() + firstComma + 1, nullptr, 10);
-                // Ignoring this rule because access value is too high
-                if (nbAccess > 127L)
-                {
-                    start = endOfLine;
-                    continue;
-                }
-            }
+    int trim(char *const data, const int start, const int end)
+    {
+        if (start >= end) return start;
+        int newStart = start;
 
-            // IP Range should be split by a dash
-            const int endOfIPRange = ((firstComma == -1) ? (endOfLine - 1) : (firstComma - 1));
-            const int delimIP = findAndNullDelimiter(buffer.data(), '-', start, endOfIPRange);
-            if (delimIP == -1)
+        for (int i = start; i <= end; ++i)
+        {
+            if (isspace(data[i]) != 0)
             {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
+                data[i] = '\0';
             }
-
-            lt::address startAddr;
-            int newStart = trim(buffer.data(), start, delimIP - 1);
-            if (!parseIPAddress(buffer.data() + newStart, startAddr))
+            else
             {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. Start IP of the range is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
+                newStart = i;
+                break;
             }
+        }
 
-            lt::address endAddr;
-            newStart = trim(buffer.data(), delimIP + 1, endOfIPRange);
-            if (!parseIPAddress(buffer.data() + newStart, endAddr))
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. End IP of the range is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+        for (int i = end; i >= start; --i)
+        {
+            if (isspace(data[i]) != 0)
+                data[i] = '\0';
+            else
+                break;
+        }
 
-            if ((startAddr.is_v4() != endAddr.is_v4())
-                || (startAddr.is_v6() != endAddr.is_v6()))
-                {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. One IP is IPv4 and the other is IPv6!").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+        return newStart;
+    }
 
-            start = endOfLine;
+    LineStatus parseIPRange(char *const line, const int start, const int end, lt::address &first, lt::address &last)
+    {
+        // IP Range should be split by a dash
+        const int delimIP = findAndNullDelimiter(line, '-', start, end);
+        if (delimIP == -1)
+            return LineStatus::Malformed;
 
-            // Now Add to the filter
-            try
-            {
-                m_filter.add_rule(startAddr, endAddr, lt::ip_filter::blocked);
-                ++ruleCount;
-            }
-            catch (const std::exception &e)
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter exception thrown for line %1. Exception is: %2")
-                       .arg(nbLine).arg(QString::fromLocal8Bit(e.what())));
-            }
-        }
+        int newStart = trim(line, start, delimIP - 1);
+        if (!parseIPAddress(line + newStart, first))
+            return LineStatus::MalformedStartIP;
 
-        if (start >= dataSize)
-            offset = 0;
-    }
+        newStart = trim(line, delimIP + 1, end);
+        if (!parseIPAddress(line + newStart, last))
+            return LineStatus::MalformedEndIP;
 
-    if (parseErrorCount > MAX_LOGGED_ERRORS)
-        LogMsg(tr("%1 extra IP filter parsing errors occurred.", "513 extra IP filter parsing errors occurred.")
-               .arg(parseErrorCount - MAX_LOGGED_ERRORS), Log::CRITICAL);
-    return ruleCount;
-}
+        if ((first.is_v4() != last.is_v4()) || (first.is_v6() != last.is_v6()))
+            return LineStatus::MixedIPVersions;
 
-// Parser for PeerGuardian ip filter in p2p format
-int FilterParserThread::parseP2PFilterFile()
-{
-    int ruleCount = 0;
-    QFile file(m_filePath);
-    if (!file.exists()) return ruleCount;
+        return LineStatus::Valid;
+    }
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    // Parser for eMule ip filter in DAT format
+    LineStatus parseDATLine(char *const line, const int length, lt::address &first, lt::address &last)
     {
-        LogMsg(tr("I/O Error: Could not open IP filter file in read mode."), Log::CRITICAL);
-        return ruleCount;
+        // Each line should follow this format:
+        // 001.009.096.105 - 001.009.096.105 , 000 , Some organization
+        // The 3rd entry is access level and if above 127 the IP range isn't blocked.
+        const int firstComma = findAndNullDelimiter(line, ',', 0, length);
+        if (firstComma != -1)
+        {
+            findAndNullDelimiter(line, ',', firstComma + 1, length);
+
+            // There is possibly an access value (apparently not mandatory)
+            const long int nbAccess = strtol(line + firstComma + 1, nullptr, 10);
+            // Ignoring this rule because access value is too high
+            if (nbAccess > 127L)
+                return LineStatus::Ignored;
+        }
+
+        const int endOfIPRange = ((firstComma == -1) ? (length - 1) : (firstComma - 1));
+        return parseIPRange(line, 0, endOfIPRange, first, last);
     }
 
-    std::vector<char> buffer(BUFFER_SIZE, 0); // seems a bit faster than QVector
-    qint64 bytesRead = 0;
-    int offset = 0;
-    int start = 0;
-    int endOfLine = -1;
-    int nbLine = 0;
-    int parseErrorCount = 0;
-    const auto addLog = [&parseErrorCount](const QString &msg)
+    // Parser for PeerGuardian ip filter in p2p format
+    LineStatus parseP2PLine(char *const line, const int length, lt::address &first, lt::address &last)
     {
-        if (parseErrorCount <= MAX_LOGGED_ERRORS)
-            LogMsg(msg, Log::CRITICAL);
-    };
+        // Each line should follow this format:
+        // Some organization:1.0.0.0-1.255.255.255
+        // The "Some organization" part might contain a ':' char itself so we find the last occurrence
+        const int partsDelimiter = findAndNullDelimiter(line, ':', 0, length, true);
+        if (partsDelimiter == -1)
+            return LineStatus::Malformed;
+
+        return parseIPRange(line, (partsDelimiter + 1), length, first, last);
+    }
 
-    while (true)
+    void parseChunk(char *const begin, char *const end, const LineParser parseLine, ChunkParsingResult &result)
     {
-        bytesRead = file.read(buffer.data() + offset, BUFFER_SIZE - offset - 1);
-        if (bytesRead < 0)
-            break;
-        const int dataSize = bytesRead + offset;
-        if ((bytesRead == 0) && (dataSize == 0))
-            break;
-
-        for (start = 0; start < dataSize; ++start)
+        char *line = begin;
+        while (line < end)
         {
-            endOfLine = -1;
+            auto *endOfLine = static_cast<char *>(memchr(line, '\n', (end - line)));
             // The file might have ended without the last line having a newline
-            if (!((bytesRead == 0) && (dataSize > 0)))
+            if (!endOfLine)
+                endOfLine = end;
+            // We need to NULL the newline in case the line has only an IP range.
+            // In that case the parser won't work for the end IP, because it ends
+            // with the newline and not with a number.
+            *endOfLine = '\0';
+            ++result.lineCount;
+
+            const int length = (endOfLine - line);
+            const bool isComment = (line[0] == '#') || ((line[0] == '/') && (line[1] == '/'));
+            if ((length > 0) && !isComment)
             {
-                for (int i = start; i < dataSize; ++i)
-                {
-                    if (buffer[i] == '\n')
-                    {
-                        endOfLine = i;
-                        // We need to NULL the newline in case the line has only an IP range.
-                        // In that case the parser won't work for the end IP, because it ends
-                        // with the newline and not with a number.
-                        buffer[i] = '\0';
-                        break;
-                    }
-                }
+                lt::address first;
+                lt::address last;
+                const LineStatus status = parseLine(line, length, first, last);
+                if (status == LineStatus::Valid)
+                    result.ranges.add(first, last);
+                else if (status != LineStatus::Ignored)
+                    result.errors.emplace_back(result.lineCount, status);
             }
+
+            line = endOfLine + 1;
+        }
+    }
+
+    QString lineErrorMessage(const LineStatus status, const int lineNumber)
+    {
+        switch (status)
+        {
+        case LineStatus::MalformedStartIP:
+            return FilterParserThread::tr("IP filter line %1 is malformed. Start IP of the range is malformed.").arg(lineNumber);
+        case LineStatus::MalformedEndIP:
+            return FilterParserThread::tr("IP filter line %1 is malformed. End IP of the range is malformed.").arg(lineNumber);
+        case LineStatus::MixedIPVersions:
+            return FilterParserThread::tr("IP filter line %1 is malformed. One IP is IPv4 and the other is IPv6!").arg(lineNumber);
+        default:
+            return FilterParserThread::tr("IP filter line %1 is malformed.").arg(lineNumber);
+        }
+    }
+
+    // Sorts the ranges and coalesces overlapping (and adjacent) ones
+    template <typename Range, typename IsAdjacent>
+    void mergeRanges(std::vector<Range> &ranges, IsAdjacent isAdjacent)
+    {
+        ranges.erase(std::remove_if(ranges.begin(), ranges.end(), [](const Range &range)
+        {
+            return (range.second < range.first);
+        }), ranges.end());
+        if (ranges.empty())
+            return;
+
+        std::sort(ranges.begin(), ranges.end());
+
+        auto merged = ranges.begin();
+        for (auto it = std::next(ranges.begin()); it != ranges.end(); ++it)
+        {
+            if (!(merged->second < it->first) || isAdjacent(merged->second, it->first))
+                merged->second = std::max(merged->second, it->second);
             else
-            {
-                endOfLine = dataSize;
-                buffer[dataSize] = '\0';
-            }
+                *(++merged) = *it;
+        }
 
-            if (endOfLine == -1)
-            {
-                // read the next chunk from file
-                // but first move(copy) the leftover data to the front of the buffer
-                offset = dataSize - start;
-                memmove(buffer.data(), buffer.data() + start, offset);
-                break;
-            }
+        ranges.erase(std::next(merged), ranges.end());
+    }
 
-            ++nbLine;
+    void mergeRanges(IPFilterRanges &ranges)
+    {
+        mergeRanges(ranges.v4, [](const quint32 last, const quint32 next) { return ((next - last) == 1); });
+        mergeRanges(ranges.v6, [](const auto &, const auto &) { return false; });
+    }
+}
 
-            if ((buffer[start] == '#')
-                || ((buffer[start] == '/') && ((start + 1 < dataSize) && (buffer[start + 1] == '/'))))
-                {
-                start = endOfLine;
-                continue;
-            }
+FilterParserThread::FilterParserThread(QObject *parent)
+    : QThread(parent)
+    , m_abort(false)
+{
+}
 
-            // Each line should follow this format:
-            // Some organization:1.0.0.0-1.255.255.255
-            // The "Some organization" part might contain a ':' char itself so we find the last occurrence
-            const int partsDelimiter = findAndNullDelimiter(buffer.data(), ':', start, endOfLine, true);
-            if (partsDelimiter == -1)
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+FilterParserThread::~FilterParserThread()
+{
+    m_abort = true;
+    wait();
+}
 
-            // IP Range should be split by a dash
-            const int delimIP = findAndNullDelimiter(buffer.data(), '-', partsDelimiter + 1, endOfLine);
-            if (delimIP == -1)
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+// Parser for text (DAT and P2P) filter files
+// The file is read at once and split into chunks at line boundaries which are parsed in parallel
+void FilterParserThread::parseTextFilterFile(const bool isP2P, IPFilterRanges &ranges)
+{
+    QFile file(m_filePath);
+    if (!file.exists()) return;
 
-            lt::address startAddr;
-            int newStart = trim(buffer.data(), partsDelimiter + 1, delimIP - 1);
-            if (!parseIPAddress(buffer.data() + newStart, startAddr))
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. Start IP of the range is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        LogMsg(tr("I/O Error: Could not open IP filter file in read mode."), Log::CRITICAL);
+        return;
+    }
 
-            lt::address endAddr;
-            newStart = trim(buffer.data(), delimIP + 1, endOfLine);
-            if (!parseIPAddress(buffer.data() + newStart, endAddr))
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. End IP of the range is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+    QByteArray data = file.readAll();
+    if (data.isEmpty()) return;
 
-            if ((startAddr.is_v4() != endAddr.is_v4())
-                || (startAddr.is_v6() != endAddr.is_v6()))
-                {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. One IP is IPv4 and the other is IPv6!").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+    char *const begin = data.data();
+    char *const end = begin + data.size();
+
+    const int chunkCount = std::clamp((data.size() / MIN_CHUNK_SIZE), 1, QThread::idealThreadCount());
+    std::vector<char *> boundaries {begin};
+    for (int i = 1; i < chunkCount; ++i)
+    {
+        char *approxBoundary = std::max((begin + (static_cast<qint64>(data.size()) * i / chunkCount)), boundaries.back());
+        auto *newLine = static_cast<char *>(memchr(approxBoundary, '\n', (end - approxBoundary)));
+        if (!newLine)
+            break;
+        boundaries.push_back(newLine + 1);
+    }
+    boundaries.push_back(end);
 
-            start = endOfLine;
+    const LineParser parseLine = (isP2P ? parseP2PLine : parseDATLine);
+    std::vector<ChunkParsingResult> results(boundaries.size() - 1);
 
-            try
-            {
-                m_filter.add_rule(startAddr, endAddr, lt::ip_filter::blocked);
-                ++ruleCount;
-            }
-            catch (const std::exception &e)
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter exception thrown for line %1. Exception is: %2")
-                       .arg(nbLine).arg(QString::fromLocal8Bit(e.what())));
-            }
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(static_cast<int>(results.size()));
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        threadPool.start([&boundaries, &results, parseLine, i]()
+        {
+            parseChunk(boundaries[i], boundaries[i + 1], parseLine, results[i]);
+        });
+    }
+    threadPool.waitForDone();
+
+    int lineOffset = 0;
+    int parseErrorCount = 0;
+    for (const ChunkParsingResult &result : results)
+    {
+        for (const auto &[lineNumber, status] : result.errors)
+        {
+            ++parseErrorCount;
+            if (parseErrorCount <= MAX_LOGGED_ERRORS)
+                LogMsg(lineErrorMessage(status, (lineOffset + lineNumber)), Log::CRITICAL);
         }
 
-        if (start >= dataSize)
-            offset = 0;
+        ranges.v4.insert(ranges.v4.end(), result.ranges.v4.cbegin(), result.ranges.v4.cend());
+        ranges.v6.insert(ranges.v6.end(), result.ranges.v6.cbegin(), result.ranges.v6.cend());
+        ranges.ruleCount += result.ranges.ruleCount;
+        lineOffset += result.lineCount;
     }
 
     if (parseErrorCount > MAX_LOGGED_ERRORS)
         LogMsg(tr("%1 extra IP filter parsing errors occurred.", "513 extra IP filter parsing errors occurred.")
                .arg(parseErrorCount - MAX_LOGGED_ERRORS), Log::CRITICAL);
-    return ruleCount;
 }
 
 int FilterParserThread::getlineInStream(QDataStream &stream, std::string &name, const char delim)
@@ -465,17 +470,16 @@ int FilterParserThread::getlineInStream(QDataStream &stream, std::string &name,
     return totalRead;
 }
 
-// Parser for PeerGuardian ip filter in p2p format
-int FilterParserThread::parseP2BFilterFile()
+// Parser for PeerGuardian ip filter in p2b format
+void FilterParserThread::parseP2BFilterFile(IPFilterRanges &ranges)
 {
-    int ruleCount = 0;
     QFile file(m_filePath);
-    if (!file.exists()) return ruleCount;
+    if (!file.exists()) return;
 
     if (!file.open(QIODevice::ReadOnly))
     {
         LogMsg(tr("I/O Error: Could not open IP filter file in read mode."), Log::CRITICAL);
-        return ruleCount;
+        return;
     }
 
     QDataStream stream(&file);
@@ -487,7 +491,7 @@ int FilterParserThread::parseP2BFilterFile()
         || !stream.readRawData(reinterpret_cast<char*>(&version), sizeof(version)))
         {
         LogMsg(tr("Parsing Error: The filter file is not a valid PeerGuardian P2B file."), Log::CRITICAL);
-        return ruleCount;
+        return;
     }
 
     if ((version == 1) || (version == 2))
@@ -502,21 +506,11 @@ int FilterParserThread::parseP2BFilterFile()
                 || !stream.readRawData(reinterpret_cast<char*>(&end), sizeof(end)))
                 {
                 LogMsg(tr("Parsing Error: The filter file is not a valid PeerGuardian P2B file."), Log::CRITICAL);
-                return ruleCount;
+                return;
             }
 
             // Network byte order to Host byte order
-            // asio address_v4 constructor expects it
-            // that way
-            const lt::address_v4 first(ntohl(start));
-            const lt::address_v4 last(ntohl(end));
-            // Apply to bittorrent session
-            try
-            {
-                m_filter.add_rule(first, last, lt::ip_filter::blocked);
-                ++ruleCount;
-            }
-            catch (const std::exception &) {}
+            ranges.addIPv4(ntohl(start), ntohl(end));
         }
     }
     else if (version == 3)
@@ -526,7 +520,7 @@ int FilterParserThread::parseP2BFilterFile()
         if (!stream.readRawData(reinterpret_cast<char*>(&namecount), sizeof(namecount)))
         {
             LogMsg(tr("Parsing Error: The filter file is not a valid PeerGuardian P2B file."), Log::CRITICAL);
-            return ruleCount;
+            return;
         }
 
         namecount = ntohl(namecount);
@@ -537,10 +531,10 @@ int FilterParserThread::parseP2BFilterFile()
             if (!getlineInStream(stream, name, '\0'))
             {
                 LogMsg(tr("Parsing Error: The filter file is not a valid PeerGuardian P2B file."), Log::CRITICAL);
-                return ruleCount;
+                return;
             }
 
-            if (m_abort) return ruleCount;
+            if (m_abort) return;
         }
 
         // Reading the ranges
@@ -548,7 +542,7 @@ int FilterParserThread::parseP2BFilterFile()
         if (!stream.readRawData(reinterpret_cast<char*>(&rangecount), sizeof(rangecount)))
         {
             LogMsg(tr("Parsing Error: The filter file is not a valid PeerGuardian P2B file."), Log::CRITICAL);
-            return ruleCount;
+            return;
         }
 
         rangecount = ntohl(rangecount);
@@ -560,31 +554,107 @@ int FilterParserThread::parseP2BFilterFile()
                 || !stream.readRawData(reinterpret_cast<char*>(&end), sizeof(end)))
                 {
                 LogMsg(tr("Parsing Error: The filter file is not a valid PeerGuardian P2B file."), Log::CRITICAL);
-                return ruleCount;
+                return;
             }
 
             // Network byte order to Host byte order
-            // asio address_v4 constructor expects it
-            // that way
-            const lt::address_v4 first(ntohl(start));
-            const lt::address_v4 last(ntohl(end));
-            // Apply to bittorrent session
-            try
-            {
-                m_filter.add_rule(first, last, lt::ip_filter::blocked);
-                ++ruleCount;
-            }
-            catch (const std::exception &) {}
+            ranges.addIPv4(ntohl(start), ntohl(end));
 
-            if (m_abort) return ruleCount;
+            if (m_abort) return;
         }
     }
     else
     {
         LogMsg(tr("Parsing Error: The filter file is not a valid PeerGuardian P2B file."), Log::CRITICAL);
     }
+}
+
+// The cache holds merged ranges of the last parsed filter file.
+// It is valid as long as the file isn't modified.
+bool FilterParserThread::loadCache(IPFilterRanges &ranges) const
+{
+    const QFileInfo fileInfo {m_filePath};
+    QFile cacheFile {m_cacheFilePath};
+    if (!fileInfo.exists() || !cacheFile.open(QIODevice::ReadOnly))
+        return false;
+
+    const QByteArray data = cacheFile.readAll();
+    QDataStream in {data};
+    in.setVersion(QDataStream::Qt_5_15);
+
+    QByteArray magic;
+    qint32 version = 0;
+    QString filePath;
+    qint64 fileSize = 0;
+    qint64 lastModified = 0;
+    in >> magic >> version >> filePath >> fileSize >> lastModified;
+    if ((in.status() != QDataStream::Ok) || (magic != CACHE_MAGIC) || (version != CACHE_VERSION)
+        || (filePath != fileInfo.absoluteFilePath()) || (fileSize != fileInfo.size())
+        || (lastModified != fileInfo.lastModified().toMSecsSinceEpoch()))
+    {
+        return false;
+    }
 
-    return ruleCount;
+    qint32 ruleCount = 0;
+    quint32 v4Count = 0;
+    in >> ruleCount >> v4Count;
+    if ((in.status() != QDataStream::Ok) || (v4Count > (data.size() / (2 * sizeof(quint32)))))
+        return false;
+
+    IPFilterRanges cachedRanges;
+    cachedRanges.ruleCount = ruleCount;
+    cachedRanges.v4.resize(v4Count);
+    for (auto &[first, last] : cachedRanges.v4)
+        in >> first >> last;
+
+    quint32 v6Count = 0;
+    in >> v6Count;
+    if ((in.status() != QDataStream::Ok) || (v6Count > (data.size() / sizeof(IPFilterRanges::IPv6Range))))
+        return false;
+
+    cachedRanges.v6.resize(v6Count);
+    for (auto &[first, last] : cachedRanges.v6)
+    {
+        if ((in.readRawData(reinterpret_cast<char *>(first.data()), first.size()) != static_cast<int>(first.size()))
+            || (in.readRawData(reinterpret_cast<char *>(last.data()), last.size()) != static_cast<int>(last.size())))
+        {
+            return false;
+        }
+    }
+
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    ranges = std::move(cachedRanges);
+    return true;
+}
+
+void FilterParserThread::storeCache(const IPFilterRanges &ranges) const
+{
+    const QFileInfo fileInfo {m_filePath};
+
+    QByteArray data;
+    QDataStream out {&data, QIODevice::WriteOnly};
+    out.setVersion(QDataStream::Qt_5_15);
+    out << QByteArray(CACHE_MAGIC) << CACHE_VERSION << fileInfo.absoluteFilePath() << fileInfo.size()
+        << fileInfo.lastModified().toMSecsSinceEpoch() << static_cast<qint32>(ranges.ruleCount);
+
+    out << static_cast<quint32>(ranges.v4.size());
+    for (const auto &[first, last] : ranges.v4)
+        out << first << last;
+
+    out << static_cast<quint32>(ranges.v6.size());
+    for (const auto &[first, last] : ranges.v6)
+    {
+        out.writeRawData(reinterpret_cast<const char *>(first.data()), first.size());
+        out.writeRawData(reinterpret_cast<const char *>(last.data()), last.size());
+    }
+
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(m_cacheFilePath, data);
+    if (!result)
+    {
+        LogMsg(tr("Couldn't save IP filter cache. Reason: %1").arg(result.error()), Log::WARNING);
+    }
 }
 
 // Process ip filter file
@@ -603,6 +673,7 @@ void FilterParserThread::processFilterFile(const QString &filePath)
 
     m_abort = false;
     m_filePath = filePath;
+    m_cacheFilePath = QDir(specialFolderLocation(SpecialFolder::Cache)).absoluteFilePath(CACHE_FILE_NAME);
     m_filter = lt::ip_filter();
     // Run it
     start();
@@ -616,28 +687,42 @@ lt::ip_filter FilterParserThread::IPfilter()
 void FilterParserThread::run()
 {
     qDebug("Processing filter file");
-    int ruleCount = 0;
-    if (m_filePath.endsWith(".p2p", Qt::CaseInsensitive))
-    {
-        // PeerGuardian p2p file
-        ruleCount = parseP2PFilterFile();
-    }
-    else if (m_filePath.endsWith(".p2b", Qt::CaseInsensitive))
-    {
-        // PeerGuardian p2b file
-        ruleCount = parseP2BFilterFile();
-    }
-    else if (m_filePath.endsWith(".dat", Qt::CaseInsensitive))
+    IPFilterRanges ranges;
+    if (!loadCache(ranges))
     {
-        // eMule DAT format
-        ruleCount = parseDATFilterFile();
+        if (m_filePath.endsWith(".p2p", Qt::CaseInsensitive))
+        {
+            // PeerGuardian p2p file
+            parseTextFilterFile(true, ranges);
+        }
+        else if (m_filePath.endsWith(".p2b", Qt::CaseInsensitive))
+        {
+            // PeerGuardian p2b file
+            parseP2BFilterFile(ranges);
+        }
+        else if (m_filePath.endsWith(".dat", Qt::CaseInsensitive))
+        {
+            // eMule DAT format
+            parseTextFilterFile(false, ranges);
+        }
+
+        if (m_abort) return;
+
+        mergeRanges(ranges);
+        if (ranges.ruleCount > 0)
+            storeCache(ranges);
     }
 
     if (m_abort) return;
 
     try
     {
-        emit IPFilterParsed(ruleCount);
+        for (const auto &[first, last] : ranges.v4)
+            m_filter.add_rule(lt::address_v4(first), lt::address_v4(last), lt::ip_filter::blocked);
+        for (const auto &[first, last] : ranges.v6)
+            m_filter.add_rule(lt::address_v6(first), lt::address_v6(last), lt::ip_filter::blocked);
+
+        emit IPFilterParsed(ranges.ruleCount);
     }
     catch (const std::exception &)
     {
@@ -646,60 +731,3 @@ void FilterParserThread::run()
 
     qDebug("IP Filter thread: finished parsing, filter applied");
 }
-
-int FilterParserThread::findAndNullDelimiter(char *const data, const char delimiter, const int start, const int end, const bool reverse)
-{
-    if (!reverse)
-    {
-        for (int i = start; i <= end; ++i)
-        {
-            if (data[i] == delimiter)
-            {
-                data[i] = '\0';
-                return i;
-            }
-        }
-    }
-    else
-    {
-        for (int i = end; i >= start; --i)
-        {
-            if (data[i] == delimiter)
-            {
-                data[i] = '\0';
-                return i;
-            }
-        }
-    }
-
-    return -1;
-}
-
-int FilterParserThread::trim(char *const data, const int start, const int end)
-{
-    if (start >= end) return start;
-    int newStart = start;
-
-    for (int i = start; i <= end; ++i)
-    {
-        if (isspace(data[i]) != 0)
-        {
-            data[i] = '\0';
-        }
-        else
-        {
-            newStart = i;
-            break;
-        }
-    }
-
-    for (int i = end; i >= start; --i)
-    {
-        if (isspace(data[i]) != 0)
-            data[i] = '\0';
-        else
-            break;
-    }
-
-    return newStart;
-}
@@ -34,6 +34,8 @@
 
 class QDataStream;
 
+struct IPFilterRanges;
+
 class FilterParserThread final : public QThread
 {
     Q_OBJECT
@@ -52,14 +54,14 @@ protected:
     void run() override;
 
 private:
-    int findAndNullDelimiter(char *const data, char delimiter, int start, int end, bool reverse = false);
-    int trim(char *const data, int start, int end);
-    int parseDATFilterFile();
-    int parseP2PFilterFile();
+    void parseTextFilterFile(bool isP2P, IPFilterRanges &ranges);
     int getlineInStream(QDataStream &stream, std::string &name, char delim);
-    int parseP2BFilterFile();
+    void parseP2BFilterFile(IPFilterRanges &ranges);
+    bool loadCache(IPFilterRanges &ranges) const;
+    void storeCache(const IPFilterRanges &ranges) const;
 
     bool m_abort;
     QString m_filePath;
+    QString m_cacheFilePath;
     lt::ip_filter m_filter;
 };
@@ -28,19 +28,21 @@
 
 #include "peerinfo.h"
 
+#include <libtorrent/bitfield.hpp>
+
 #include <QBitArray>
 
-#include "base/bittorrent/torrent.h"
 #include "base/net/geoipmanager.h"
 #include "base/unicodestrings.h"
+#include "base/utils/bitfield.h"
 #include "peeraddress.h"
 
 using namespace BitTorrent;
 
-PeerInfo::PeerInfo(const Torrent *torrent, const lt::peer_info &nativeInfo)
+PeerInfo::PeerInfo(const lt::peer_info &nativeInfo, const lt::bitfield &allPieces)
     : m_nativeInfo(nativeInfo)
 {
-    calcRelevance(torrent);
+    calcRelevance(allPieces);
     determineFlags();
 }
 
@@ -207,13 +209,7 @@ qlonglong PeerInfo::totalDownload() const
 
 QBitArray PeerInfo::pieces() const
 {
-    QBitArray result(m_nativeInfo.pieces.size());
-    for (int i = 0; i < result.size(); ++i)
-    {
-        if (m_nativeInfo.pieces[lt::piece_index_t {i}])
-            result.setBit(i, true);
-    }
-    return result;
+    return Utils::Bitfield::toQBitArray(m_nativeInfo.pieces);
 }
 
 QString PeerInfo::connectionType() const
@@ -226,23 +222,10 @@ QString PeerInfo::connectionType() const
         : QLatin1String {"Web"};
 }
 
-void PeerInfo::calcRelevance(const Torrent *torrent)
+void PeerInfo::calcRelevance(const lt::bitfield &allPieces)
 {
-    const QBitArray allPieces = torrent->pieces();
-    const QBitArray peerPieces = pieces();
-
-    int localMissing = 0;
-    int remoteHaves = 0;
-
-    for (int i = 0; i < allPieces.size(); ++i)
-    {
-        if (!allPieces[i])
-        {
-            ++localMissing;
-            if (peerPieces[i])
-                ++remoteHaves;
-        }
-    }
+    const int localMissing = allPieces.size() - allPieces.count();
+    const int remoteHaves = Utils::Bitfield::countAndNot(m_nativeInfo.pieces, allPieces);
 
     if (localMissing == 0)
         m_relevance = 0.0;
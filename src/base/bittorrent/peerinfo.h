@@ -36,7 +36,6 @@ class QBitArray;
 
 namespace BitTorrent
 {
-    class Torrent;
     struct PeerAddress;
 
     class PeerInfo
@@ -45,7 +44,7 @@ namespace BitTorrent
 
     public:
         PeerInfo() = default;
-        PeerInfo(const Torrent *torrent, const lt::peer_info &nativeInfo);
+        PeerInfo(const lt::peer_info &nativeInfo, const lt::bitfield &allPieces);
 
         bool fromDHT() const;
         bool fromPeX() const;
@@ -92,7 +91,7 @@ namespace BitTorrent
         int downloadingPieceIndex() const;
 
     private:
-        void calcRelevance(const Torrent *torrent);
+        void calcRelevance(const lt::bitfield &allPieces);
         void determineFlags();
 
         lt::peer_info m_nativeInfo = {};
@@ -0,0 +1,264 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "recheckscheduler.h"
+
+#include <algorithm>
+
+#include "base/global.h"
+#include "base/utils/fs.h"
+#include "torrentimpl.h"
+
+namespace
+{
+    // libtorrent may report the torrent as not checking right after
+    // the check is requested, so such checks are given some time to start
+    const qint64 CHECK_START_TIMEOUT = 5000;
+}
+
+using namespace BitTorrent;
+
+RecheckScheduler::RecheckScheduler(QObject *parent)
+    : QObject(parent)
+{
+}
+
+int RecheckScheduler::maxConcurrentChecksPerDevice() const
+{
+    return m_maxConcurrentChecksPerDevice;
+}
+
+void RecheckScheduler::setMaxConcurrentChecksPerDevice(const int value)
+{
+    m_maxConcurrentChecksPerDevice = std::max(1, value);
+    startJobs();
+}
+
+void RecheckScheduler::enqueue(TorrentImpl *torrent)
+{
+    const auto isSameTorrent = [torrent](const Job &job) { return job.torrent == torrent; };
+    if (std::any_of(m_queuedJobs.cbegin(), m_queuedJobs.cend(), isSameTorrent))
+        return;
+
+    // A running check is restarted from the beginning when it is requested again
+    const auto runningJobIter = std::find_if(m_runningJobs.cbegin(), m_runningJobs.cend(), isSameTorrent);
+    if (runningJobIter != m_runningJobs.cend())
+        finishJob(runningJobIter - m_runningJobs.cbegin());
+
+    if (m_queuedJobs.isEmpty() && m_runningJobs.isEmpty())
+    {
+        m_batchTimer.start();
+        m_finishedCount = 0;
+        m_batchSize = 0;
+        m_finishedSize = 0;
+    }
+
+    // The check started by libtorrent is restarted by the scheduler
+    const auto externalJobIter = std::find_if(m_externalJobs.cbegin(), m_externalJobs.cend(), isSameTorrent);
+    if (externalJobIter != m_externalJobs.cend())
+        finishExternalJob(externalJobIter - m_externalJobs.cbegin());
+
+    const Job job = makeJob(torrent);
+    const auto insertPos = std::upper_bound(m_queuedJobs.begin(), m_queuedJobs.end(), job.size
+        , [](const qint64 size, const Job &other) { return size < other.size; });
+    m_queuedJobs.insert(insertPos, job);
+    m_batchSize += job.size;
+
+    startJobs();
+}
+
+void RecheckScheduler::remove(TorrentImpl *torrent)
+{
+    const auto isSameTorrent = [torrent](const Job &job) { return job.torrent == torrent; };
+
+    const auto queuedJobIter = std::find_if(m_queuedJobs.cbegin(), m_queuedJobs.cend(), isSameTorrent);
+    if (queuedJobIter != m_queuedJobs.cend())
+    {
+        m_batchSize -= queuedJobIter->size;
+        m_queuedJobs.erase(queuedJobIter);
+    }
+
+    const auto runningJobIter = std::find_if(m_runningJobs.cbegin(), m_runningJobs.cend(), isSameTorrent);
+    if (runningJobIter != m_runningJobs.cend())
+    {
+        m_batchSize -= runningJobIter->size;
+        m_finishedSize -= runningJobIter->size;
+        --m_finishedCount;
+        finishJob(runningJobIter - m_runningJobs.cbegin());
+    }
+
+    const auto externalJobIter = std::find_if(m_externalJobs.cbegin(), m_externalJobs.cend(), isSameTorrent);
+    if (externalJobIter != m_externalJobs.cend())
+        finishExternalJob(externalJobIter - m_externalJobs.cbegin());
+}
+
+bool RecheckScheduler::isQueued(const TorrentImpl *torrent) const
+{
+    return std::any_of(m_queuedJobs.cbegin(), m_queuedJobs.cend()
+        , [torrent](const Job &job) { return job.torrent == torrent; });
+}
+
+void RecheckScheduler::handleTorrentChecked(TorrentImpl *torrent)
+{
+    const auto isSameTorrent = [torrent](const Job &job) { return job.torrent == torrent; };
+
+    const auto runningJobIter = std::find_if(m_runningJobs.cbegin(), m_runningJobs.cend(), isSameTorrent);
+    if (runningJobIter != m_runningJobs.cend())
+        finishJob(runningJobIter - m_runningJobs.cbegin());
+
+    const auto externalJobIter = std::find_if(m_externalJobs.cbegin(), m_externalJobs.cend(), isSameTorrent);
+    if (externalJobIter != m_externalJobs.cend())
+        finishExternalJob(externalJobIter - m_externalJobs.cbegin());
+}
+
+void RecheckScheduler::handleTorrentsUpdated(const QVector<TorrentImpl *> &checkingTorrents)
+{
+    for (int i = m_runningJobs.size() - 1; i >= 0; --i)
+    {
+        const Job &job = m_runningJobs[i];
+        if (!job.torrent->isChecking() && job.runningTime.hasExpired(CHECK_START_TIMEOUT))
+            finishJob(i);
+    }
+
+    for (int i = m_externalJobs.size() - 1; i >= 0; --i)
+    {
+        if (!m_externalJobs[i].torrent->isCheckingFiles())
+            finishExternalJob(i);
+    }
+
+    for (TorrentImpl *torrent : checkingTorrents)
+    {
+        // The checks that libtorrent only queued don't use the device yet
+        if (!torrent->isCheckingFiles())
+            continue;
+
+        const auto isSameTorrent = [torrent](const Job &job) { return job.torrent == torrent; };
+        if (std::any_of(m_queuedJobs.cbegin(), m_queuedJobs.cend(), isSameTorrent)
+            || std::any_of(m_runningJobs.cbegin(), m_runningJobs.cend(), isSameTorrent)
+            || std::any_of(m_externalJobs.cbegin(), m_externalJobs.cend(), isSameTorrent))
+        {
+            continue;
+        }
+
+        const Job job = makeJob(torrent);
+        ++m_runningJobsPerDevice[job.deviceID];
+        m_externalJobs.append(job);
+    }
+}
+
+RecheckStatus RecheckScheduler::status() const
+{
+    RecheckStatus status;
+    status.queuedCount = m_queuedJobs.size();
+    status.runningCount = m_runningJobs.size();
+    status.finishedCount = m_finishedCount;
+    status.totalSize = m_batchSize;
+
+    status.checkedSize = m_finishedSize;
+    for (const Job &job : asConst(m_runningJobs))
+    {
+        if (job.torrent->isChecking())
+            status.checkedSize += static_cast<qint64>(job.torrent->progress() * job.size);
+    }
+
+    const qint64 elapsedSecs = (m_batchTimer.isValid() ? (m_batchTimer.elapsed() / 1000) : 0);
+    if ((elapsedSecs > 0) && (status.checkedSize > 0))
+    {
+        status.speed = status.checkedSize / elapsedSecs;
+        if ((status.queuedCount + status.runningCount) > 0)
+            status.eta = (status.totalSize - status.checkedSize) / std::max<qint64>(1, status.speed);
+        else
+            status.eta = 0;
+    }
+
+    return status;
+}
+
+RecheckScheduler::Job RecheckScheduler::makeJob(TorrentImpl *torrent) const
+{
+    Job job;
+    job.torrent = torrent;
+    job.deviceID = Utils::Fs::storageDeviceID(torrent->actualStorageLocation());
+    job.size = torrent->totalSize();
+    return job;
+}
+
+void RecheckScheduler::startJobs()
+{
+    bool hasStartedJobs = false;
+    for (int i = 0; i < m_queuedJobs.size(); )
+    {
+        const Job &job = m_queuedJobs[i];
+        int &runningJobsOnDevice = m_runningJobsPerDevice[job.deviceID];
+        if (runningJobsOnDevice >= m_maxConcurrentChecksPerDevice)
+        {
+            ++i;
+            continue;
+        }
+
+        ++runningJobsOnDevice;
+        Job runningJob = m_queuedJobs.takeAt(i);
+        runningJob.runningTime.start();
+        runningJob.torrent->startRecheck();
+        m_runningJobs.append(runningJob);
+        hasStartedJobs = true;
+    }
+
+    if (hasStartedJobs)
+        emitRunningCountChanged();
+}
+
+void RecheckScheduler::finishJob(const int runningJobIndex)
+{
+    const Job job = m_runningJobs.takeAt(runningJobIndex);
+    releaseDevice(job.deviceID);
+
+    ++m_finishedCount;
+    m_finishedSize += job.size;
+
+    emitRunningCountChanged();
+    startJobs();
+}
+
+void RecheckScheduler::finishExternalJob(const int externalJobIndex)
+{
+    releaseDevice(m_externalJobs.takeAt(externalJobIndex).deviceID);
+    startJobs();
+}
+
+void RecheckScheduler::releaseDevice(const QString &deviceID)
+{
+    const auto deviceIter = m_runningJobsPerDevice.find(deviceID);
+    if ((deviceIter != m_runningJobsPerDevice.end()) && (--deviceIter.value() <= 0))
+        m_runningJobsPerDevice.erase(deviceIter);
+}
+
+void RecheckScheduler::emitRunningCountChanged()
+{
+    emit runningCountChanged(m_runningJobs.size());
+}
@@ -0,0 +1,116 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+namespace BitTorrent
+{
+    class TorrentImpl;
+
+    struct RecheckStatus
+    {
+        int queuedCount = 0;
+        int runningCount = 0;
+        int finishedCount = 0;
+        // Sizes of all the torrents of the current batch
+        qint64 totalSize = 0;
+        qint64 checkedSize = 0;
+        // Bytes per second since the batch was started
+        qint64 speed = 0;
+        // Seconds, -1 if unknown
+        qint64 eta = -1;
+    };
+
+    // Runs forced rechecks grouped by the storage device of the torrents,
+    // so that torrents on different devices are checked concurrently.
+    // Smaller torrents are checked first.
+    // The rechecks queued while others are running form a single batch
+    // that is reported by status().
+    class RecheckScheduler final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(RecheckScheduler)
+
+    public:
+        explicit RecheckScheduler(QObject *parent = nullptr);
+
+        int maxConcurrentChecksPerDevice() const;
+        void setMaxConcurrentChecksPerDevice(int value);
+
+        void enqueue(TorrentImpl *torrent);
+        void remove(TorrentImpl *torrent);
+        bool isQueued(const TorrentImpl *torrent) const;
+
+        void handleTorrentChecked(TorrentImpl *torrent);
+        // Releases the running checks that were interrupted (e.g. by pausing the torrent)
+        // and accounts the devices used by the checks that libtorrent runs by itself
+        void handleTorrentsUpdated(const QVector<TorrentImpl *> &checkingTorrents);
+
+        RecheckStatus status() const;
+
+    signals:
+        // Only the checks started by the scheduler are counted
+        void runningCountChanged(int count);
+
+    private:
+        struct Job
+        {
+            TorrentImpl *torrent = nullptr;
+            QString deviceID;
+            qint64 size = 0;
+            QElapsedTimer runningTime;
+        };
+
+        Job makeJob(TorrentImpl *torrent) const;
+        void startJobs();
+        void finishJob(int runningJobIndex);
+        void finishExternalJob(int externalJobIndex);
+        void releaseDevice(const QString &deviceID);
+        void emitRunningCountChanged();
+
+        int m_maxConcurrentChecksPerDevice = 1;
+        QVector<Job> m_queuedJobs;
+        QVector<Job> m_runningJobs;
+        // Checks run by libtorrent itself (e.g. of the added torrents).
+        // They aren't limited by the scheduler but occupy their devices.
+        // libtorrent runs them within its own active_checking limit.
+        QVector<Job> m_externalJobs;
+        QHash<QString, int> m_runningJobsPerDevice;
+
+        // Current batch
+        QElapsedTimer m_batchTimer;
+        int m_finishedCount = 0;
+        qint64 m_batchSize = 0;
+        qint64 m_finishedSize = 0;
+    };
+}
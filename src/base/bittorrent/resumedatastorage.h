@@ -33,9 +33,12 @@
 #include <QtContainerFwd>
 #include <QObject>
 
+#include "infohash.h"
+
+class QDeadlineTimer;
+
 namespace BitTorrent
 {
-    class TorrentID;
     struct LoadTorrentParams;
 
     class ResumeDataStorage : public QObject
@@ -48,8 +51,15 @@ namespace BitTorrent
 
         virtual QVector<TorrentID> registeredTorrents() const = 0;
         virtual std::optional<LoadTorrentParams> load(const TorrentID &id) const = 0;
-        virtual void store(const TorrentID &id, const LoadTorrentParams &resumeData) const = 0;
+        // Stores the resume data asynchronously, resumeDataStored() is emitted once it is done
+        virtual void store(const TorrentID &id, const LoadTorrentParams &resumeData) = 0;
+        // Synchronously stores the resume data of many torrents, using several threads where possible.
+        // The data that wasn't stored before the deadline is dropped. Returns the IDs of the stored torrents.
+        virtual QSet<TorrentID> storeBatch(const QHash<TorrentID, LoadTorrentParams> &resumeData, const QDeadlineTimer &deadline) const = 0;
         virtual void remove(const TorrentID &id) const = 0;
         virtual void storeQueue(const QVector<TorrentID> &queue) const = 0;
+
+    signals:
+        void resumeDataStored(const BitTorrent::TorrentID &id, bool success);
     };
 }
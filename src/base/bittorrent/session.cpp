@@ -30,7 +30,9 @@
 #include "session.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
+#include <iterator>
 #include <queue>
 #include <string>
 #include <utility>
@@ -48,14 +50,17 @@
 #include <libtorrent/extensions/ut_pex.hpp>
 #include <libtorrent/ip_filter.hpp>
 #include <libtorrent/magnet_uri.hpp>
+#include <libtorrent/performance_counters.hpp>
 #include <libtorrent/session.hpp>
 #include <libtorrent/session_stats.hpp>
 #include <libtorrent/session_status.hpp>
 #include <libtorrent/torrent_info.hpp>
 
+#include <QDeadlineTimer>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QHostAddress>
 #include <QNetworkAddressEntry>
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
@@ -71,7 +76,9 @@
 #include "base/algorithm.h"
 #include "base/bittorrent/scheduler/bandwidthscheduler.h"
 #include "base/global.h"
+#include "base/latencystats.h"
 #include "base/logger.h"
+#include "base/memorystats.h"
 #include "base/net/downloadmanager.h"
 #include "base/net/proxyconfigurationmanager.h"
 #include "base/profile.h"
@@ -96,9 +103,12 @@
 #include "magneturi.h"
 #include "nativesessionextension.h"
 #include "portforwarderimpl.h"
+#include "recheckscheduler.h"
 #include "statistics.h"
+#include "torrentfileworker.h"
 #include "torrentimpl.h"
 #include "tracker.h"
+#include "transferhistory.h"
 
 using namespace BitTorrent;
 
@@ -107,6 +117,9 @@ namespace
     const char PEER_ID[] = "qB";
     const char USER_AGENT[] = "qBittorrent/" QBT_VERSION_2;
 
+    // Maximum time spent loading torrents before returning to the event loop during startup
+    const int STARTUP_BATCH_DURATION = 50; // milliseconds
+
     void torrentQueuePositionUp(const lt::torrent_handle &handle)
     {
         try
@@ -316,6 +329,36 @@ namespace
         return {};
     }
 #endif
+
+    // Parses valid addresses into sorted set
+    std::vector<lt::address> toSortedAddresses(const QStringList &ips)
+    {
+        std::vector<lt::address> addresses;
+        addresses.reserve(ips.size());
+        for (const QString &ip : ips)
+        {
+            lt::error_code ec;
+            const lt::address addr = lt::make_address(ip.toLatin1().constData(), ec);
+            if (!ec)
+                addresses.push_back(addr);
+        }
+
+        std::sort(addresses.begin(), addresses.end());
+        addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+        return addresses;
+    }
+
+#ifdef QBT_LATENCY_STATS
+    LatencyStats::Histogram *alertLatencyHistogram(const lt::alert *a)
+    {
+        static std::array<LatencyStats::Histogram *, lt::num_alert_types> histograms {};
+
+        LatencyStats::Histogram *&histogram = histograms[a->type()];
+        if (!histogram)
+            histogram = LatencyStats::histogram(QLatin1String("alert/") + QLatin1String(a->what()));
+        return histogram;
+    }
+#endif
 }
 
 const int addTorrentParamsId = qRegisterMetaType<AddTorrentParams>();
@@ -407,6 +450,11 @@ Session::Session(QObject *parent)
     , m_isAltGlobalSpeedLimitEnabled(BITTORRENT_SESSION_KEY("UseAlternativeGlobalSpeedLimit"), false)
     , m_isBandwidthSchedulerEnabled(BITTORRENT_SESSION_KEY("BandwidthSchedulerEnabled"), false)
     , m_saveResumeDataInterval(BITTORRENT_SESSION_KEY("SaveResumeDataInterval"), 60)
+    , m_shutdownTimeout(BITTORRENT_SESSION_KEY("ShutdownTimeout"), 60, lowerLimited(1))
+    , m_memoryBudget(BITTORRENT_SESSION_KEY("MemoryBudget"), 0, lowerLimited(0))
+    , m_metadataUnloadDelay(BITTORRENT_SESSION_KEY("MetadataUnloadDelay"), 0, lowerLimited(0))
+    , m_maxConcurrentMovesPerDevice(BITTORRENT_SESSION_KEY("MaxConcurrentMovesPerDevice"), 1, lowerLimited(1))
+    , m_maxConcurrentChecksPerDevice(BITTORRENT_SESSION_KEY("MaxConcurrentChecksPerDevice"), 1, lowerLimited(1))
     , m_port(BITTORRENT_SESSION_KEY("Port"), -1)
     , m_networkInterface(BITTORRENT_SESSION_KEY("Interface"))
     , m_networkInterfaceName(BITTORRENT_SESSION_KEY("InterfaceName"))
@@ -432,22 +480,17 @@ Session::Session(QObject *parent)
     , m_peerTurnover(BITTORRENT_SESSION_KEY("PeerTurnover"), 4)
     , m_peerTurnoverCutoff(BITTORRENT_SESSION_KEY("PeerTurnoverCutOff"), 90)
     , m_peerTurnoverInterval(BITTORRENT_SESSION_KEY("PeerTurnoverInterval"), 300)
-    , m_bannedIPs("State/BannedIPs"
-                  , QStringList()
-                  , [](const QStringList &value)
-                        {
-                            QStringList tmp = value;
-                            tmp.sort();
-                            return tmp;
-                        }
-                 )
+    , m_bannedIPs("State/BannedIPs")
     , m_resumeDataStorageType(BITTORRENT_SESSION_KEY("ResumeDataStorageType"), ResumeDataStorageType::Legacy)
 #if defined(Q_OS_WIN)
     , m_OSMemoryPriority(BITTORRENT_KEY("OSMemoryPriority"), OSMemoryPriority::BelowNormal)
 #endif
     , m_seedingLimitTimer {new QTimer {this}}
     , m_resumeDataTimer {new QTimer {this}}
+    , m_memoryBudgetTimer {new QTimer {this}}
+    , m_metadataUnloadTimer {new QTimer {this}}
     , m_statistics {new Statistics {this}}
+    , m_transferHistory {new TransferHistory {this}}
     , m_ioThread {new QThread {this}}
     , m_recentErroredTorrentsTimer {new QTimer {this}}
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
@@ -457,6 +500,8 @@ Session::Session(QObject *parent)
     if (port() < 0)
         m_port = Utils::Random::rand(1024, 65535);
 
+    m_bannedAddresses = toSortedAddresses(m_bannedIPs);
+
     m_recentErroredTorrentsTimer->setSingleShot(true);
     m_recentErroredTorrentsTimer->setInterval(1000);
     connect(m_recentErroredTorrentsTimer, &QTimer::timeout
@@ -507,8 +552,24 @@ Session::Session(QObject *parent)
     connect(m_ioThread, &QThread::finished, m_fileSearcher, &QObject::deleteLater);
     connect(m_fileSearcher, &FileSearcher::searchFinished, this, &Session::fileSearchFinished);
 
+    m_torrentFileWorker = new TorrentFileWorker;
+    m_torrentFileWorker->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_torrentFileWorker, &QObject::deleteLater);
+    connect(m_torrentFileWorker, &TorrentFileWorker::torrentFilesFound, this, &Session::handleTorrentFilesFound);
+
     m_ioThread->start();
 
+    m_recheckScheduler = new RecheckScheduler(this);
+    m_recheckScheduler->setMaxConcurrentChecksPerDevice(m_maxConcurrentChecksPerDevice);
+    connect(m_recheckScheduler, &RecheckScheduler::runningCountChanged, this, [this](const int count)
+    {
+        // The scheduled checks are limited by us, so libtorrent should run all of them at once.
+        // The checks libtorrent runs by itself aren't counted, so they don't raise the limit.
+        lt::settings_pack settingsPack;
+        settingsPack.set_int(lt::settings_pack::active_checking, std::max(1, count));
+        m_nativeSession->apply_settings(settingsPack);
+    });
+
     // Regular saving of fastresume data
     connect(m_resumeDataTimer, &QTimer::timeout, this, [this]() { generateResumeData(); });
     const int saveInterval = saveResumeDataInterval();
@@ -518,6 +579,33 @@ Session::Session(QObject *parent)
         m_resumeDataTimer->start();
     }
 
+    const auto torrentsMemoryUsage = [this](qint64 (TorrentImpl::*sizeFunc)() const)
+    {
+        return [this, sizeFunc]()
+        {
+            qint64 size = 0;
+            for (const TorrentImpl *torrent : asConst(m_torrents))
+                size += (torrent->*sizeFunc)();
+            return size;
+        };
+    };
+    MemoryStats::registerProvider(QLatin1String("torrents/resumeData"), tr("Cached resume data")
+        , torrentsMemoryUsage(&TorrentImpl::resumeDataCacheSize));
+    MemoryStats::registerProvider(QLatin1String("torrents/status"), tr("Cached torrent status")
+        , torrentsMemoryUsage(&TorrentImpl::statusCacheSize));
+    MemoryStats::registerProvider(QLatin1String("torrents/metadata"), tr("Torrent metadata")
+        , torrentsMemoryUsage(&TorrentImpl::metadataSize));
+
+    m_memoryBudgetTimer->setInterval(30 * 1000);
+    connect(m_memoryBudgetTimer, &QTimer::timeout, this, &Session::enforceMemoryBudget);
+    if (memoryBudget() > 0)
+        m_memoryBudgetTimer->start();
+
+    m_metadataUnloadTimer->setInterval(60 * 1000);
+    connect(m_metadataUnloadTimer, &QTimer::timeout, this, &Session::unloadInactiveMetadata);
+    if (metadataUnloadDelay() > 0)
+        m_metadataUnloadTimer->start();
+
     // initialize PortForwarder instance
     new PortForwarderImpl {m_nativeSession};
 
@@ -966,6 +1054,13 @@ void Session::setGlobalMaxSeedingMinutes(int minutes)
 // Main destructor
 Session::~Session()
 {
+    MemoryStats::unregisterProvider(QLatin1String("torrents/resumeData"));
+    MemoryStats::unregisterProvider(QLatin1String("torrents/status"));
+    MemoryStats::unregisterProvider(QLatin1String("torrents/metadata"));
+
+    if (m_startupStorage)
+        finishStartup();
+
     // Do some BT related saving
     saveResumeData();
 
@@ -1123,15 +1218,19 @@ void Session::initializeNativeSession()
 
 void Session::processBannedIPs(lt::ip_filter &filter)
 {
-    // First, import current filter
-    for (const QString &ip : asConst(m_bannedIPs.get()))
-    {
-        lt::error_code ec;
-        const lt::address addr = lt::make_address(ip.toLatin1().constData(), ec);
-        Q_ASSERT(!ec);
-        if (!ec)
-            filter.add_rule(addr, addr, lt::ip_filter::blocked);
-    }
+    for (const lt::address &addr : m_bannedAddresses)
+        filter.add_rule(addr, addr, lt::ip_filter::blocked);
+}
+
+void Session::setBannedAddresses(std::vector<lt::address> addresses)
+{
+    m_bannedAddresses = std::move(addresses);
+
+    QStringList bannedIPs;
+    bannedIPs.reserve(static_cast<int>(m_bannedAddresses.size()));
+    for (const lt::address &addr : m_bannedAddresses)
+        bannedIPs.append(QString::fromStdString(addr.to_string()));
+    m_bannedIPs = bannedIPs;
 }
 
 void Session::adjustLimits(lt::settings_pack &settingsPack) const
@@ -1192,6 +1291,19 @@ void Session::initMetrics()
     m_metricIndices.disk.hashJobs = findMetricIndex("disk.num_blocks_hashed");
     m_metricIndices.disk.queuedDiskJobs = findMetricIndex("disk.queued_disk_jobs");
     m_metricIndices.disk.diskJobTime = findMetricIndex("disk.disk_job_time");
+
+    const std::vector<lt::stats_metric> metrics = lt::session_stats_metrics();
+    m_sessionStatsMetrics.resize(lt::counters::num_counters);
+    for (const lt::stats_metric &metric : metrics)
+    {
+        if ((metric.value_index < 0) || (metric.value_index >= m_sessionStatsMetrics.size()))
+            continue;
+
+        SessionStatsMetric &sessionStatsMetric = m_sessionStatsMetrics[metric.value_index];
+        sessionStatsMetric.name = metric.name;
+        sessionStatsMetric.isGauge = (metric.type == lt::metric_type_t::gauge);
+    }
+    m_sessionStatsCounters.fill(0, m_sessionStatsMetrics.size());
 }
 
 void Session::loadLTSettings(lt::settings_pack &settingsPack)
@@ -1759,10 +1871,7 @@ bool Session::hasActiveTorrents() const
 
 bool Session::hasUnfinishedTorrents() const
 {
-    return std::any_of(m_torrents.begin(), m_torrents.end(), [](const TorrentImpl *torrent)
-    {
-        return (!torrent->isSeed() && !torrent->isPaused() && !torrent->isErrored());
-    });
+    return !m_unfinishedTorrents.isEmpty();
 }
 
 bool Session::hasRunningSeed() const
@@ -1775,21 +1884,48 @@ bool Session::hasRunningSeed() const
 
 void Session::banIP(const QString &ip)
 {
-    QStringList bannedIPs = m_bannedIPs;
-    if (!bannedIPs.contains(ip))
+    banIPs({ip});
+}
+
+void Session::banIPs(const QStringList &ips)
+{
+    std::vector<lt::address> newAddresses = toSortedAddresses(ips);
+    newAddresses.erase(std::remove_if(newAddresses.begin(), newAddresses.end(), [this](const lt::address &addr)
     {
-        lt::ip_filter filter = m_nativeSession->get_ip_filter();
-        lt::error_code ec;
-        const lt::address addr = lt::make_address(ip.toLatin1().constData(), ec);
-        Q_ASSERT(!ec);
-        if (ec) return;
+        return std::binary_search(m_bannedAddresses.cbegin(), m_bannedAddresses.cend(), addr);
+    }), newAddresses.end());
+    if (newAddresses.empty())
+        return;
+
+    // The new bans are just added to the current filter
+    lt::ip_filter filter = m_nativeSession->get_ip_filter();
+    for (const lt::address &addr : newAddresses)
         filter.add_rule(addr, addr, lt::ip_filter::blocked);
-        m_nativeSession->set_ip_filter(filter);
+    m_nativeSession->set_ip_filter(filter);
 
-        bannedIPs << ip;
-        bannedIPs.sort();
-        m_bannedIPs = bannedIPs;
-    }
+    std::vector<lt::address> bannedAddresses;
+    bannedAddresses.reserve(m_bannedAddresses.size() + newAddresses.size());
+    std::merge(m_bannedAddresses.cbegin(), m_bannedAddresses.cend(), newAddresses.cbegin(), newAddresses.cend()
+        , std::back_inserter(bannedAddresses));
+    setBannedAddresses(std::move(bannedAddresses));
+}
+
+void Session::unbanIPs(const QStringList &ips)
+{
+    const std::vector<lt::address> addresses = toSortedAddresses(ips);
+
+    std::vector<lt::address> bannedAddresses;
+    bannedAddresses.reserve(m_bannedAddresses.size());
+    std::set_difference(m_bannedAddresses.cbegin(), m_bannedAddresses.cend(), addresses.cbegin(), addresses.cend()
+        , std::back_inserter(bannedAddresses));
+    if (bannedAddresses.size() == m_bannedAddresses.size())
+        return;
+
+    setBannedAddresses(std::move(bannedAddresses));
+    // The unbanned addresses might still be blocked by the IP filter file
+    // so the filter has to be recreated
+    m_IPFilteringConfigured = false;
+    configureDeferred();
 }
 
 // Delete a torrent from the session, given its hash
@@ -1799,6 +1935,13 @@ bool Session::deleteTorrent(const TorrentID &id, const DeleteOption deleteOption
     TorrentImpl *const torrent = m_torrents.take(id);
     if (!torrent) return false;
 
+    // libtorrent needs to know the files to delete them
+    if (deleteOption == DeleteTorrentAndFiles)
+        torrent->loadMetadata();
+
+    m_unfinishedTorrents.remove(id);
+    m_recheckScheduler->remove(torrent);
+
     qDebug("Deleting torrent with ID: %s", qUtf8Printable(torrent->id().toString()));
     emit torrentAboutToBeRemoved(torrent);
 
@@ -1836,18 +1979,15 @@ bool Session::deleteTorrent(const TorrentID &id, const DeleteOption deleteOption
 
         m_removingTorrents[torrent->id()] = {torrent->name(), rootPath, deleteOption};
 
-        if (m_moveStorageQueue.size() > 1)
+        // Delete "move storage job" for the deleted torrent
+        // (note: we shouldn't delete active job)
+        const auto iter = std::find_if(m_moveStorageQueue.begin(), m_moveStorageQueue.end()
+                                 , [torrent](const MoveStorageJob &job)
         {
-            // Delete "move storage job" for the deleted torrent
-            // (note: we shouldn't delete active job)
-            const auto iter = std::find_if(m_moveStorageQueue.begin() + 1, m_moveStorageQueue.end()
-                                     , [torrent](const MoveStorageJob &job)
-            {
-                return job.torrentHandle == torrent->nativeHandle();
-            });
-            if (iter != m_moveStorageQueue.end())
-                m_moveStorageQueue.erase(iter);
-        }
+            return !job.isActive && (job.torrentHandle == torrent->nativeHandle());
+        });
+        if (iter != m_moveStorageQueue.end())
+            m_moveStorageQueue.erase(iter);
 
         m_nativeSession->remove_torrent(torrent->nativeHandle(), lt::session::delete_files);
     }
@@ -2112,7 +2252,7 @@ bool Session::addTorrent_impl(const std::variant<MagnetUri, TorrentInfo> &source
 
     // We should not add the torrent if it is already
     // processed or is pending to add to session
-    if (m_loadingTorrents.contains(id))
+    if (m_loadingTorrents.contains(id) || m_pendingStartupTorrents.contains(id))
         return false;
 
     TorrentImpl *const torrent = m_torrents.value(id);
@@ -2249,6 +2389,16 @@ void Session::findIncompleteFiles(const TorrentInfo &torrentInfo, const QString
     });
 }
 
+std::optional<LoadTorrentParams> Session::loadTorrentResumeData(const TorrentID &id) const
+{
+    std::optional<LoadTorrentParams> resumeData = m_resumeDataStorage->load(id);
+#ifndef QBT_USES_LIBTORRENT2
+    if (resumeData)
+        resumeData->ltAddTorrentParams.storage = customStorageConstructor;
+#endif
+    return resumeData;
+}
+
 // Add a torrent to libtorrent session in hidden mode
 // and force it to download its metadata
 bool Session::downloadMetadata(const MagnetUri &magnetUri)
@@ -2310,31 +2460,25 @@ bool Session::downloadMetadata(const MagnetUri &magnetUri)
 
 void Session::exportTorrentFile(const TorrentInfo &torrentInfo, const QString &folderPath, const QString &baseName)
 {
-    const QString validName = Utils::Fs::toValidFileSystemName(baseName);
-    QString torrentExportFilename = QString::fromLatin1("%1.torrent").arg(validName);
-    const QDir exportDir {folderPath};
-    if (exportDir.exists() || exportDir.mkpath(exportDir.absolutePath()))
+    QMetaObject::invokeMethod(m_torrentFileWorker, [=]()
     {
-        QString newTorrentPath = exportDir.absoluteFilePath(torrentExportFilename);
-        int counter = 0;
-        while (QFile::exists(newTorrentPath))
-        {
-            // Append number to torrent name to make it unique
-            torrentExportFilename = QString::fromLatin1("%1 %2.torrent").arg(validName).arg(++counter);
-            newTorrentPath = exportDir.absoluteFilePath(torrentExportFilename);
-        }
+        m_torrentFileWorker->exportTorrentFile(torrentInfo, folderPath, baseName);
+    });
+}
 
-        const nonstd::expected<void, QString> result = torrentInfo.saveToFile(newTorrentPath);
-        if (!result)
-        {
-            LogMsg(tr("Couldn't export torrent metadata file '%1'. Reason: %2.")
-                   .arg(newTorrentPath, result.error()), Log::WARNING);
-        }
-    }
+void Session::exportTorrentFile(const lt::torrent_handle &nativeHandle, const QString &folderPath, const QString &baseName)
+{
+    // Retrieving the metadata from libtorrent can be expensive so it is done by the worker as well
+    QMetaObject::invokeMethod(m_torrentFileWorker, [=]()
+    {
+        m_torrentFileWorker->exportTorrentFile(nativeHandle, folderPath, baseName);
+    });
 }
 
 void Session::generateResumeData()
 {
+    QBT_MEASURE_LATENCY("session/generateResumeData");
+
     for (TorrentImpl *const torrent : asConst(m_torrents))
     {
         if (!torrent->isValid()) continue;
@@ -2350,23 +2494,30 @@ void Session::generateResumeData()
 // Called on exit
 void Session::saveResumeData()
 {
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+    const QDeadlineTimer deadline {std::chrono::seconds {shutdownTimeout()}};
+
     // Pause session
     m_nativeSession->pause();
 
     if (isQueueingSystemEnabled())
         saveTorrentsQueue();
-    generateResumeData();
 
-    while (m_numResumeData > 0)
+    QSet<TorrentID> dirtyTorrents;
+    for (const TorrentImpl *torrent : asConst(m_torrents))
     {
-        const std::vector<lt::alert *> alerts = getPendingAlerts(lt::seconds {30});
-        if (alerts.empty())
-        {
-            LogMsg(tr("Error: Aborted saving resume data for %1 outstanding torrents.").arg(QString::number(m_numResumeData))
-                , Log::CRITICAL);
-            break;
-        }
+        if (torrent->isValid() && torrent->needSaveResumeData())
+            dirtyTorrents.insert(torrent->id());
+    }
+
+    // The resume data are stored at once when they are generated for all the torrents
+    m_isCollectingResumeData = true;
+    generateResumeData();
 
+    while ((m_numResumeData > 0) && !deadline.hasExpired())
+    {
+        const std::vector<lt::alert *> alerts = getPendingAlerts(lt::milliseconds {deadline.remainingTime()});
         for (const lt::alert *a : alerts)
         {
             switch (a->type())
@@ -2378,6 +2529,63 @@ void Session::saveResumeData()
             }
         }
     }
+
+    m_isCollectingResumeData = false;
+
+    // Writing has a deadline of its own, so the resume data generated
+    // late within the shutdown timeout isn't dropped
+    const QDeadlineTimer writeDeadline {std::chrono::seconds {shutdownTimeout()}};
+    const QSet<TorrentID> storedTorrents = m_resumeDataStorage->storeBatch(m_collectedResumeData, writeDeadline);
+
+    QStringList ungeneratedTorrentNames;
+    QStringList unstoredTorrentNames;
+    for (const TorrentID &torrentID : asConst(dirtyTorrents))
+    {
+        if (!m_collectedResumeData.contains(torrentID))
+            ungeneratedTorrentNames.append(m_torrents.value(torrentID)->name());
+    }
+    for (auto it = m_collectedResumeData.cbegin(); it != m_collectedResumeData.cend(); ++it)
+    {
+        if (!storedTorrents.contains(it.key()))
+            unstoredTorrentNames.append(m_torrents.value(it.key())->name());
+    }
+    m_collectedResumeData.clear();
+
+    if (ungeneratedTorrentNames.isEmpty() && unstoredTorrentNames.isEmpty())
+    {
+        LogMsg(tr("Saved resume data of %1 torrents in %2 ms.")
+            .arg(QString::number(storedTorrents.size()), QString::number(elapsedTimer.elapsed())));
+        return;
+    }
+
+    const auto joinNames = [](QStringList names) -> QString
+    {
+        const int MAX_REPORTED_NAMES = 20;
+        if (names.size() > MAX_REPORTED_NAMES)
+        {
+            names.erase((names.begin() + MAX_REPORTED_NAMES), names.end());
+            names.append(QLatin1String("..."));
+        }
+        return names.join(QLatin1String(", "));
+    };
+
+    if (!ungeneratedTorrentNames.isEmpty())
+    {
+        LogMsg(tr("Error: Resume data of %1 torrents wasn't generated within %2 seconds. Torrents: %3")
+            .arg(QString::number(ungeneratedTorrentNames.size()), QString::number(shutdownTimeout())
+                , joinNames(ungeneratedTorrentNames))
+            , Log::CRITICAL);
+    }
+
+    if (!unstoredTorrentNames.isEmpty())
+    {
+        LogMsg(tr("Error: Resume data of %1 torrents couldn't be written within %2 seconds. Torrents: %3")
+            .arg(QString::number(unstoredTorrentNames.size()), QString::number(shutdownTimeout())
+                , joinNames(unstoredTorrentNames))
+            , Log::CRITICAL);
+    }
+
+    LogMsg(tr("Saved resume data of %1 torrents.").arg(QString::number(storedTorrents.size())));
 }
 
 void Session::saveTorrentsQueue() const
@@ -2746,11 +2954,139 @@ void Session::setBandwidthSchedulerEnabled(const bool enabled)
     }
 }
 
+int Session::maxConcurrentMovesPerDevice() const
+{
+    return m_maxConcurrentMovesPerDevice;
+}
+
+void Session::setMaxConcurrentMovesPerDevice(const int value)
+{
+    if (value == m_maxConcurrentMovesPerDevice)
+        return;
+
+    m_maxConcurrentMovesPerDevice = value;
+    startMoveStorageJobs();
+}
+
+int Session::maxConcurrentChecksPerDevice() const
+{
+    return m_maxConcurrentChecksPerDevice;
+}
+
+void Session::setMaxConcurrentChecksPerDevice(const int value)
+{
+    if (value == m_maxConcurrentChecksPerDevice)
+        return;
+
+    m_maxConcurrentChecksPerDevice = value;
+    m_recheckScheduler->setMaxConcurrentChecksPerDevice(value);
+}
+
 int Session::saveResumeDataInterval() const
 {
     return m_saveResumeDataInterval;
 }
 
+int Session::shutdownTimeout() const
+{
+    return m_shutdownTimeout;
+}
+
+void Session::setShutdownTimeout(const int value)
+{
+    m_shutdownTimeout = value;
+}
+
+int Session::memoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+void Session::setMemoryBudget(const int value)
+{
+    if (value == m_memoryBudget)
+        return;
+
+    m_memoryBudget = value;
+
+    if (value > 0)
+        m_memoryBudgetTimer->start();
+    else
+        m_memoryBudgetTimer->stop();
+}
+
+int Session::metadataUnloadDelay() const
+{
+    return m_metadataUnloadDelay;
+}
+
+void Session::setMetadataUnloadDelay(const int value)
+{
+    if (value == m_metadataUnloadDelay)
+        return;
+
+    m_metadataUnloadDelay = value;
+
+    if (value > 0)
+        m_metadataUnloadTimer->start();
+    else
+        m_metadataUnloadTimer->stop();
+}
+
+void Session::unloadInactiveMetadata()
+{
+    const int delay = metadataUnloadDelay() * 60;
+    if (delay <= 0)
+        return;
+
+    int count = 0;
+    for (TorrentImpl *const torrent : asConst(m_torrents))
+    {
+        if (torrent->unloadMetadata(delay))
+            ++count;
+    }
+
+    if (count > 0)
+        LogMsg(tr("Unloading metadata of %1 inactive torrents.").arg(count));
+}
+
+void Session::enforceMemoryBudget()
+{
+    const qint64 budget = static_cast<qint64>(memoryBudget()) * 1024 * 1024;
+    if (budget <= 0)
+        return;
+
+    // Prefer the actual usage of the process since libtorrent and Qt allocate a lot of memory
+    // which isn't accounted. The resident size isn't suitable since it includes the pages of
+    // the torrent files mapped by libtorrent 2.0, which the OS reclaims by itself.
+    // Note that the private memory includes the libtorrent disk cache and freed heap memory
+    // the allocator keeps, so releasing the cached data may not bring it below the budget.
+    qint64 usage = MemoryStats::processPrivateSize();
+    if (usage < 0)
+        usage = MemoryStats::totalSize(MemoryStats::snapshot());
+    if (usage < (budget / 10 * 9))
+        return;
+
+    int releasedCount = 0;
+    qint64 releasedSize = 0;
+    for (TorrentImpl *const torrent : asConst(m_torrents))
+    {
+        const qint64 size = torrent->releaseResumeDataCache();
+        if (size > 0)
+        {
+            ++releasedCount;
+            releasedSize += size;
+        }
+    }
+
+    if (releasedCount > 0)
+    {
+        LogMsg(tr("Memory usage (%1) is approaching the budget (%2). Released cached data of %3 idle torrents (%4).")
+            .arg(Utils::Misc::friendlyUnit(usage), Utils::Misc::friendlyUnit(budget)
+                , QString::number(releasedCount), Utils::Misc::friendlyUnit(releasedSize)), Log::INFO);
+    }
+}
+
 void Session::setSaveResumeDataInterval(const int value)
 {
     if (value == m_saveResumeDataInterval)
@@ -2946,10 +3282,7 @@ void Session::setBannedIPs(const QStringList &newList)
     {
         if (Utils::Net::isValidIP(ip))
         {
-            // the same IPv6 addresses could be written in different forms;
-            // QHostAddress::toString() result format follows RFC5952;
-            // thus we avoid duplicate entries pointing to the same address
-            filteredList << QHostAddress(ip).toString();
+            filteredList << ip;
         }
         else
         {
@@ -2958,16 +3291,16 @@ void Session::setBannedIPs(const QStringList &newList)
                 , Log::WARNING);
         }
     }
-    // now we have to sort IPs and make them unique
-    filteredList.sort();
-    filteredList.removeDuplicates();
+    // the same IPv6 addresses could be written in different forms
+    // thus we compare parsed addresses to avoid duplicate entries pointing to the same address
+    std::vector<lt::address> bannedAddresses = toSortedAddresses(filteredList);
     // Again ensure that the new list is different from the stored one.
-    if (filteredList == m_bannedIPs)
+    if (bannedAddresses == m_bannedAddresses)
         return; // do nothing
     // store to session settings
     // also here we have to recreate filter list including 3rd party ban file
     // and install it again into m_session
-    m_bannedIPs = filteredList;
+    setBannedAddresses(std::move(bannedAddresses));
     m_IPFilteringConfigured = false;
     configureDeferred();
 }
@@ -3841,6 +4174,7 @@ bool Session::isKnownTorrent(const TorrentID &id) const
 {
     return (m_torrents.contains(id)
             || m_loadingTorrents.contains(id)
+            || m_pendingStartupTorrents.contains(id)
             || m_downloadedMetadata.contains(id));
 }
 
@@ -3933,14 +4267,7 @@ void Session::handleTorrentMetadataReceived(TorrentImpl *const torrent)
 {
     // Copy the torrent file to the export folder
     if (!torrentExportDirectory().isEmpty())
-    {
-#ifdef QBT_USES_LIBTORRENT2
-        const TorrentInfo torrentInfo {torrent->nativeHandle().torrent_file_with_hashes()};
-#else
-        const TorrentInfo torrentInfo {torrent->nativeHandle().torrent_file()};
-#endif
-        exportTorrentFile(torrentInfo, torrentExportDirectory(), torrent->name());
-    }
+        exportTorrentFile(torrent->nativeHandle(), torrentExportDirectory(), torrent->name());
 
     emit torrentMetadataReceived(torrent);
 }
@@ -3957,6 +4284,7 @@ void Session::handleTorrentResumed(TorrentImpl *const torrent)
 
 void Session::handleTorrentChecked(TorrentImpl *const torrent)
 {
+    m_recheckScheduler->handleTorrentChecked(torrent);
     emit torrentFinishedChecking(torrent);
 }
 
@@ -3964,49 +4292,91 @@ void Session::handleTorrentFinished(TorrentImpl *const torrent)
 {
     emit torrentFinished(torrent);
 
-    qDebug("Checking if the torrent contains torrent files to download");
-    // Check if there are torrent files inside
+    // Check if there are torrent files inside.
+    // They are decoded in the I/O thread, see handleTorrentFilesFound()
+    QStringList torrentFilePaths;
     for (const QString &torrentRelpath : asConst(torrent->filePaths()))
     {
         if (torrentRelpath.endsWith(".torrent", Qt::CaseInsensitive))
+            torrentFilePaths.append(torrent->savePath(true) + '/' + torrentRelpath);
+    }
+
+    if (!torrentFilePaths.isEmpty())
+    {
+        const TorrentID id = torrent->id();
+        QMetaObject::invokeMethod(m_torrentFileWorker, [this, id, torrentFilePaths]()
         {
-            qDebug("Found possible recursive torrent download.");
-            const QString torrentFullpath = torrent->savePath(true) + '/' + torrentRelpath;
-            qDebug("Full subtorrent path is %s", qUtf8Printable(torrentFullpath));
-            if (TorrentInfo::loadFromFile(torrentFullpath))
-            {
-                qDebug("emitting recursiveTorrentDownloadPossible()");
-                emit recursiveTorrentDownloadPossible(torrent);
-                break;
-            }
-            else
-            {
-                qDebug("Caught error loading torrent");
-                LogMsg(tr("Unable to decode '%1' torrent file.").arg(Utils::Fs::toNativePath(torrentFullpath)), Log::CRITICAL);
-            }
-        }
+            m_torrentFileWorker->findTorrentFiles(id, torrentFilePaths);
+        });
     }
 
     // Move .torrent file to another folder
     if (!finishedTorrentExportDirectory().isEmpty())
+        exportTorrentFile(torrent->nativeHandle(), finishedTorrentExportDirectory(), torrent->name());
+
+    if (!isStartupFinished() || !m_loadingTorrents.isEmpty())
     {
-#ifdef QBT_USES_LIBTORRENT2
-        const TorrentInfo torrentInfo {torrent->nativeHandle().torrent_file_with_hashes()};
-#else
-        const TorrentInfo torrentInfo {torrent->nativeHandle().torrent_file()};
-#endif
-        exportTorrentFile(torrentInfo, finishedTorrentExportDirectory(), torrent->name());
+        // the torrents that are not loaded yet may be unfinished
+        m_isAllTorrentsFinishedDeferred = true;
+        return;
     }
 
     if (!hasUnfinishedTorrents())
         emit allTorrentsFinished();
 }
 
+void Session::handleTorrentUnfinishedStateChanged(TorrentImpl *const torrent, const bool isUnfinished)
+{
+    if (isUnfinished)
+        m_unfinishedTorrents.insert(torrent->id());
+    else
+        m_unfinishedTorrents.remove(torrent->id());
+}
+
+void Session::handleTorrentFilesFound(const TorrentID &id)
+{
+    TorrentImpl *const torrent = m_torrents.value(id);
+    if (torrent)
+        emit recursiveTorrentDownloadPossible(torrent);
+}
+
 void Session::handleTorrentResumeDataReady(TorrentImpl *const torrent, const LoadTorrentParams &data)
 {
     --m_numResumeData;
 
-    m_resumeDataStorage->store(torrent->id(), data);
+    if (m_isCollectingResumeData)
+        m_collectedResumeData[torrent->id()] = data;
+    else
+        storeResumeData(torrent->id(), data);
+}
+
+void Session::storeResumeData(const TorrentID &id, const LoadTorrentParams &resumeData)
+{
+    ++m_pendingResumeDataStores[id];
+    m_resumeDataStorage->store(id, resumeData);
+}
+
+void Session::handleResumeDataStored(const TorrentID &id, const bool success)
+{
+    const auto iter = m_pendingResumeDataStores.find(id);
+    if (iter == m_pendingResumeDataStores.end())
+        return;
+
+    // The stores are completed in order, so the torrent is notified of the latest one only
+    if (--iter.value() > 0)
+        return;
+
+    m_pendingResumeDataStores.erase(iter);
+
+    TorrentImpl *const torrent = m_torrents.value(id);
+    if (torrent)
+        torrent->handleResumeDataStored(success);
+}
+
+void Session::handleTorrentResumeDataFailed(const TorrentImpl *torrent)
+{
+    Q_UNUSED(torrent);
+    --m_numResumeData;
 }
 
 void Session::handleTorrentTrackerReply(TorrentImpl *const torrent, const QString &trackerUrl)
@@ -4026,27 +4396,30 @@ bool Session::addMoveTorrentStorageJob(TorrentImpl *torrent, const QString &newP
     const lt::torrent_handle torrentHandle = torrent->nativeHandle();
     const QString currentLocation = torrent->actualStorageLocation();
 
-    if (m_moveStorageQueue.size() > 1)
+    const auto iter = std::find_if(m_moveStorageQueue.begin(), m_moveStorageQueue.end()
+                             , [&torrentHandle](const MoveStorageJob &job)
     {
-        const auto iter = std::find_if(m_moveStorageQueue.begin() + 1, m_moveStorageQueue.end()
-                                 , [&torrentHandle](const MoveStorageJob &job)
-        {
-            return job.torrentHandle == torrentHandle;
-        });
+        return !job.isActive && (job.torrentHandle == torrentHandle);
+    });
 
-        if (iter != m_moveStorageQueue.end())
-        {
-            // remove existing inactive job
-            m_moveStorageQueue.erase(iter);
-            LogMsg(tr("Cancelled moving \"%1\" from \"%2\" to \"%3\".").arg(torrent->name(), currentLocation, iter->path));
-        }
+    if (iter != m_moveStorageQueue.end())
+    {
+        // remove existing inactive job
+        LogMsg(tr("Cancelled moving \"%1\" from \"%2\" to \"%3\".").arg(torrent->name(), currentLocation, iter->path));
+        m_moveStorageQueue.erase(iter);
     }
 
-    if (!m_moveStorageQueue.isEmpty() && (m_moveStorageQueue.first().torrentHandle == torrentHandle))
+    const auto activeJobIter = std::find_if(m_moveStorageQueue.cbegin(), m_moveStorageQueue.cend()
+                                      , [&torrentHandle](const MoveStorageJob &job)
+    {
+        return job.isActive && (job.torrentHandle == torrentHandle);
+    });
+
+    if (activeJobIter != m_moveStorageQueue.cend())
     {
         // if there is active job for this torrent prevent creating meaningless
         // job that will move torrent to the same location as current one
-        if (QDir {m_moveStorageQueue.first().path} == QDir {newPath})
+        if (QDir {activeJobIter->path} == QDir {newPath})
         {
             LogMsg(tr("Couldn't enqueue move of \"%1\" to \"%2\". Torrent is currently moving to the same destination location.")
                    .arg(torrent->name(), newPath));
@@ -4063,16 +4436,125 @@ bool Session::addMoveTorrentStorageJob(TorrentImpl *torrent, const QString &newP
         }
     }
 
-    const MoveStorageJob moveStorageJob {torrentHandle, newPath, mode};
+    // the files will be moved from the destination of the active job, if any
+    const QString sourcePath = ((activeJobIter != m_moveStorageQueue.cend()) ? activeJobIter->path : currentLocation);
+    const MoveStorageJob moveStorageJob {torrentHandle, newPath, mode, sourcePath
+        , Utils::Fs::storageDeviceID(sourcePath), Utils::Fs::storageDeviceID(newPath), torrent->totalSize()};
     m_moveStorageQueue << moveStorageJob;
     LogMsg(tr("Enqueued to move \"%1\" from \"%2\" to \"%3\".").arg(torrent->name(), currentLocation, newPath));
 
-    if (m_moveStorageQueue.size() == 1)
-        moveTorrentStorage(moveStorageJob);
+    startMoveStorageJobs();
 
     return true;
 }
 
+QVector<MoveStorageJobStatus> Session::moveStorageJobs()
+{
+    // Progress is polled by the clients, so sample it
+    // at most once per interval and report the last sample
+    const int sampleInterval = 2000; // ms
+    if (!m_isSamplingMovedStorageSizes
+        && (!m_movedStorageSizesSampleTimer.isValid() || m_movedStorageSizesSampleTimer.hasExpired(sampleInterval)))
+    {
+        sampleMovedStorageSizes();
+    }
+
+    QVector<MoveStorageJobStatus> jobs;
+    jobs.reserve(m_moveStorageQueue.size());
+
+    for (const MoveStorageJob &job : asConst(m_moveStorageQueue))
+    {
+#ifdef QBT_USES_LIBTORRENT2
+        const auto id = TorrentID::fromInfoHash(job.torrentHandle.info_hashes());
+#else
+        const auto id = TorrentID::fromInfoHash(job.torrentHandle.info_hash());
+#endif
+        const TorrentImpl *torrent = m_torrents.value(id);
+        const qint64 movedSize = (job.isActive ? m_movedStorageSizes.value(id) : 0);
+
+        jobs.append({id, (torrent ? torrent->name() : id.toString()), job.sourcePath, job.path
+            , job.totalSize, std::min(movedSize, job.totalSize), job.isActive});
+    }
+
+    return jobs;
+}
+
+void Session::sampleMovedStorageSizes()
+{
+    struct FileEntry
+    {
+        QString path;
+        qint64 size;
+    };
+
+    QHash<TorrentID, QVector<FileEntry>> activeJobFiles;
+    for (const MoveStorageJob &job : asConst(m_moveStorageQueue))
+    {
+        if (!job.isActive)
+            continue;
+
+#ifdef QBT_USES_LIBTORRENT2
+        const auto id = TorrentID::fromInfoHash(job.torrentHandle.info_hashes());
+#else
+        const auto id = TorrentID::fromInfoHash(job.torrentHandle.info_hash());
+#endif
+        const TorrentImpl *torrent = m_torrents.value(id);
+        if (!torrent || !torrent->hasMetadata())
+            continue;
+
+        QVector<FileEntry> &files = activeJobFiles[id];
+        files.reserve(torrent->filesCount());
+        for (int i = 0; i < torrent->filesCount(); ++i)
+            files.append({(job.path + QLatin1Char('/') + torrent->filePath(i)), torrent->fileSize(i)});
+    }
+
+    m_movedStorageSizesSampleTimer.start();
+    if (activeJobFiles.isEmpty())
+    {
+        m_movedStorageSizes.clear();
+        return;
+    }
+
+    m_isSamplingMovedStorageSizes = true;
+    QMetaObject::invokeMethod(m_fileSearcher, [this, activeJobFiles]()
+    {
+        QHash<TorrentID, qint64> movedSizes;
+        for (auto iter = activeJobFiles.cbegin(); iter != activeJobFiles.cend(); ++iter)
+        {
+            qint64 movedSize = 0;
+            for (const FileEntry &file : iter.value())
+            {
+                QFileInfo fileInfo {file.path};
+                if (!fileInfo.exists())
+                    fileInfo.setFile(file.path + QB_EXT);
+                movedSize += std::min(fileInfo.size(), file.size);
+            }
+            movedSizes.insert(iter.key(), movedSize);
+        }
+
+        QMetaObject::invokeMethod(this, [this, movedSizes]()
+        {
+            m_movedStorageSizes = movedSizes;
+            m_isSamplingMovedStorageSizes = false;
+        }, Qt::QueuedConnection);
+    });
+}
+
+void Session::enqueueRecheck(TorrentImpl *torrent)
+{
+    m_recheckScheduler->enqueue(torrent);
+}
+
+bool Session::isRecheckQueued(const TorrentImpl *torrent) const
+{
+    return m_recheckScheduler->isQueued(torrent);
+}
+
+RecheckStatus Session::recheckStatus() const
+{
+    return m_recheckScheduler->status();
+}
+
 void Session::moveTorrentStorage(const MoveStorageJob &job) const
 {
 #ifdef QBT_USES_LIBTORRENT2
@@ -4089,11 +4571,61 @@ void Session::moveTorrentStorage(const MoveStorageJob &job) const
                             ? lt::move_flags_t::always_replace_files : lt::move_flags_t::dont_replace));
 }
 
-void Session::handleMoveTorrentStorageJobFinished()
+void Session::startMoveStorageJobs()
 {
-    const MoveStorageJob finishedJob = m_moveStorageQueue.takeFirst();
-    if (!m_moveStorageQueue.isEmpty())
-        moveTorrentStorage(m_moveStorageQueue.first());
+    const int maxJobsPerDevice = maxConcurrentMovesPerDevice();
+    // a torrent is moved by one job at a time
+    std::vector<lt::torrent_handle> busyTorrents;
+
+    for (MoveStorageJob &job : m_moveStorageQueue)
+    {
+        const bool isTorrentBusy = (std::find(busyTorrents.cbegin(), busyTorrents.cend(), job.torrentHandle) != busyTorrents.cend());
+        if (!isTorrentBusy)
+            busyTorrents.push_back(job.torrentHandle);
+
+        if (job.isActive || isTorrentBusy)
+            continue;
+
+        if ((m_activeMoveStorageJobsPerDevice.value(job.sourceDeviceID) >= maxJobsPerDevice)
+            || (m_activeMoveStorageJobsPerDevice.value(job.destinationDeviceID) >= maxJobsPerDevice))
+        {
+            continue;
+        }
+
+        job.isActive = true;
+        ++m_activeMoveStorageJobsPerDevice[job.sourceDeviceID];
+        if (job.destinationDeviceID != job.sourceDeviceID)
+            ++m_activeMoveStorageJobsPerDevice[job.destinationDeviceID];
+
+        moveTorrentStorage(job);
+    }
+}
+
+void Session::handleMoveTorrentStorageJobFinished(const lt::torrent_handle &torrentHandle)
+{
+    const auto finishedJobIter = std::find_if(m_moveStorageQueue.begin(), m_moveStorageQueue.end()
+                                        , [&torrentHandle](const MoveStorageJob &job)
+    {
+        return job.isActive && (job.torrentHandle == torrentHandle);
+    });
+    Q_ASSERT(finishedJobIter != m_moveStorageQueue.end());
+    if (finishedJobIter == m_moveStorageQueue.end())
+        return;
+
+    const MoveStorageJob finishedJob = *finishedJobIter;
+    m_moveStorageQueue.erase(finishedJobIter);
+
+    const auto releaseDevice = [this](const QString &deviceID)
+    {
+        const auto deviceIter = m_activeMoveStorageJobsPerDevice.find(deviceID);
+        if ((deviceIter != m_activeMoveStorageJobsPerDevice.end()) && (--deviceIter.value() <= 0))
+            m_activeMoveStorageJobsPerDevice.erase(deviceIter);
+    };
+    releaseDevice(finishedJob.sourceDeviceID);
+    if (finishedJob.destinationDeviceID != finishedJob.sourceDeviceID)
+        releaseDevice(finishedJob.destinationDeviceID);
+
+    startMoveStorageJobs();
 
     const auto iter = std::find_if(m_moveStorageQueue.cbegin(), m_moveStorageQueue.cend()
                                    , [&finishedJob](const MoveStorageJob &job)
@@ -4216,6 +4748,26 @@ const CacheStatus &Session::cacheStatus() const
     return m_cacheStatus;
 }
 
+const QVector<SessionStatsMetric> &Session::sessionStatsMetrics() const
+{
+    return m_sessionStatsMetrics;
+}
+
+const QVector<qint64> &Session::sessionStatsCounters() const
+{
+    return m_sessionStatsCounters;
+}
+
+quint64 Session::droppedAlertsCount() const
+{
+    return m_droppedAlertsCount;
+}
+
+int Session::pendingResumeDataCount() const
+{
+    return m_numResumeData;
+}
+
 void Session::startUpTorrents()
 {
     qDebug("Initializing torrents resume data storage...");
@@ -4224,7 +4776,6 @@ void Session::startUpTorrents()
                 specialFolderLocation(SpecialFolder::Data) + QLatin1String("torrents.db"));
     const bool dbStorageExists = QFile::exists(dbPath);
 
-    ResumeDataStorage *startupStorage = nullptr;
     if (resumeDataStorageType() == ResumeDataStorageType::SQLite)
     {
         m_resumeDataStorage = new DBResumeDataStorage(dbPath, this);
@@ -4233,7 +4784,7 @@ void Session::startUpTorrents()
         {
             const QString dataPath = Utils::Fs::expandPathAbs(
                         specialFolderLocation(SpecialFolder::Data) + QLatin1String("BT_backup"));
-            startupStorage = new BencodeResumeDataStorage(dataPath, this);
+            m_startupStorage = new BencodeResumeDataStorage(dataPath, this);
         }
     }
     else
@@ -4243,55 +4794,134 @@ void Session::startUpTorrents()
         m_resumeDataStorage = new BencodeResumeDataStorage(dataPath, this);
 
         if (dbStorageExists)
-            startupStorage = new DBResumeDataStorage(dbPath, this);
+            m_startupStorage = new DBResumeDataStorage(dbPath, this);
     }
 
-    if (!startupStorage)
-        startupStorage = m_resumeDataStorage;
+    connect(m_resumeDataStorage, &ResumeDataStorage::resumeDataStored, this, &Session::handleResumeDataStored);
+
+    if (!m_startupStorage)
+        m_startupStorage = m_resumeDataStorage;
 
     qDebug("Starting up torrents...");
 
-    const QVector<TorrentID> torrents = startupStorage->registeredTorrents();
-    int resumedTorrentsCount = 0;
-    QVector<TorrentID> queue;
-    for (const TorrentID &torrentID : torrents)
-    {
-        const std::optional<LoadTorrentParams> resumeData = startupStorage->load(torrentID);
-        if (resumeData)
-        {
-            if (m_resumeDataStorage != startupStorage)
-            {
-                m_resumeDataStorage->store(torrentID, *resumeData);
-                if (isQueueingSystemEnabled() && !resumeData->hasSeedStatus)
-                    queue.append(torrentID);
-            }
+    m_startupTimer.start();
+    m_startupTorrents = m_startupStorage->registeredTorrents();
+    m_pendingStartupTorrents = QSet<TorrentID>(m_startupTorrents.cbegin(), m_startupTorrents.cend());
 
-            qDebug() << "Starting up torrent" << torrentID.toString() << "...";
-            if (!loadTorrent(*resumeData))
-                LogMsg(tr("Unable to resume torrent '%1'.", "e.g: Unable to resume torrent 'hash'.")
-                           .arg(torrentID.toString()), Log::CRITICAL);
+    // Torrents are loaded from the event loop, so the UIs can serve the already loaded ones meanwhile
+    QTimer::singleShot(0, this, &Session::loadStartupTorrents);
+}
 
-            // process add torrent messages before message queue overflow
-            if ((resumedTorrentsCount % 100) == 0) readAlerts();
+void Session::loadStartupTorrents()
+{
+    QElapsedTimer batchTimer;
+    batchTimer.start();
 
-            ++resumedTorrentsCount;
-        }
-        else
+    while ((m_startupLoadedCount < m_startupTorrents.size()) && (batchTimer.elapsed() < STARTUP_BATCH_DURATION))
+    {
+        const TorrentID torrentID = m_startupTorrents.at(m_startupLoadedCount);
+        m_pendingStartupTorrents.remove(torrentID);
+        ++m_startupLoadedCount;
+
+        const std::optional<LoadTorrentParams> resumeData = m_startupStorage->load(torrentID);
+        if (!resumeData)
         {
             LogMsg(tr("Unable to resume torrent '%1'.", "e.g: Unable to resume torrent 'hash'.")
                        .arg(torrentID.toString()), Log::CRITICAL);
+            continue;
         }
+
+        if (m_resumeDataStorage != m_startupStorage)
+        {
+            storeResumeData(torrentID, *resumeData);
+            if (isQueueingSystemEnabled() && !resumeData->hasSeedStatus)
+                m_startupQueue.append(torrentID);
+        }
+
+        qDebug() << "Starting up torrent" << torrentID.toString() << "...";
+        if (!loadTorrent(*resumeData))
+            LogMsg(tr("Unable to resume torrent '%1'.", "e.g: Unable to resume torrent 'hash'.")
+                       .arg(torrentID.toString()), Log::CRITICAL);
+
+        // process add torrent messages before message queue overflow
+        if ((m_startupLoadedCount % 100) == 0) readAlerts();
     }
 
-    if (m_resumeDataStorage != startupStorage)
+    if (m_startupLoadedCount < m_startupTorrents.size())
     {
-        delete startupStorage;
+        QTimer::singleShot(0, this, &Session::loadStartupTorrents);
+        return;
+    }
+
+    finishStartup();
+
+    LogMsg(tr("Loaded %1 torrents of the previous session in %2 ms")
+        .arg(QString::number(m_startupTorrents.size()), QString::number(m_startupTimer.elapsed())));
+    emit startupFinished();
+
+    emitDeferredAllTorrentsFinished();
+}
+
+void Session::emitDeferredAllTorrentsFinished()
+{
+    // The last batch of the startup torrents is still being added by libtorrent
+    // after the startup is finished
+    if (!m_isAllTorrentsFinishedDeferred || !isStartupFinished() || !m_loadingTorrents.isEmpty())
+        return;
+
+    m_isAllTorrentsFinishedDeferred = false;
+    if (!hasUnfinishedTorrents())
+        emit allTorrentsFinished();
+}
+
+void Session::finishStartup()
+{
+    if (m_resumeDataStorage != m_startupStorage)
+    {
+        // The resume data are being migrated to another storage, so it must be completed
+        // even if the torrents weren't loaded, otherwise the rest of them would be lost
+        for (int i = m_startupLoadedCount; i < m_startupTorrents.size(); ++i)
+        {
+            const TorrentID &torrentID = m_startupTorrents.at(i);
+            const std::optional<LoadTorrentParams> resumeData = m_startupStorage->load(torrentID);
+            if (!resumeData)
+                continue;
+
+            storeResumeData(torrentID, *resumeData);
+            if (isQueueingSystemEnabled() && !resumeData->hasSeedStatus)
+                m_startupQueue.append(torrentID);
+        }
+
+        delete m_startupStorage;
         if (resumeDataStorageType() == ResumeDataStorageType::Legacy)
-            Utils::Fs::forceRemove(dbPath);
+        {
+            Utils::Fs::forceRemove(Utils::Fs::expandPathAbs(
+                        specialFolderLocation(SpecialFolder::Data) + QLatin1String("torrents.db")));
+        }
 
         if (isQueueingSystemEnabled())
-            m_resumeDataStorage->storeQueue(queue);
+            m_resumeDataStorage->storeQueue(m_startupQueue);
     }
+
+    m_startupStorage = nullptr;
+    m_pendingStartupTorrents.clear();
+    m_startupQueue.clear();
+    m_isStartupFinished = true;
+}
+
+bool Session::isStartupFinished() const
+{
+    return m_isStartupFinished;
+}
+
+int Session::startupTorrentsCount() const
+{
+    return m_startupTorrents.size();
+}
+
+int Session::startupLoadedTorrentsCount() const
+{
+    return m_startupLoadedCount;
 }
 
 quint64 Session::getAlltimeDL() const
@@ -4304,6 +4934,11 @@ quint64 Session::getAlltimeUL() const
     return m_statistics->getAlltimeUL();
 }
 
+TransferHistory *Session::transferHistory() const
+{
+    return m_transferHistory;
+}
+
 void Session::enqueueRefresh()
 {
     Q_ASSERT(!m_refreshEnqueued);
@@ -4362,6 +4997,8 @@ void Session::setTorrentContentLayout(const TorrentContentLayout value)
 // Read alerts sent by the BitTorrent session
 void Session::readAlerts()
 {
+    QBT_MEASURE_LATENCY("session/readAlerts");
+
     const std::vector<lt::alert *> alerts = getPendingAlerts();
     for (const lt::alert *a : alerts)
         handleAlert(a);
@@ -4369,6 +5006,8 @@ void Session::readAlerts()
 
 void Session::handleAlert(const lt::alert *a)
 {
+    QBT_MEASURE_LATENCY_OF(alertLatencyHistogram(a));
+
     try
     {
         switch (a->type())
@@ -4496,7 +5135,7 @@ void Session::createTorrent(const lt::torrent_handle &nativeHandle)
     }
     else
     {
-        m_resumeDataStorage->store(torrent->id(), params);
+        storeResumeData(torrent->id(), params);
 
         // The following is useless for newly added magnet
         if (hasMetadata)
@@ -4552,6 +5191,8 @@ void Session::handleAddTorrentAlert(const lt::add_torrent_alert *p)
     {
         createTorrent(p->handle);
     }
+
+    emitDeferredAllTorrentsFinished();
 }
 
 void Session::handleTorrentRemovedAlert(const lt::torrent_removed_alert *p)
@@ -4775,6 +5416,7 @@ void Session::handleSessionStatsAlert(const lt::session_stats_alert *p)
     m_statsLastTimestamp = p->timestamp();
 
     const auto stats = p->counters();
+    std::copy_n(stats.begin(), std::min<qsizetype>(stats.size(), m_sessionStatsCounters.size()), m_sessionStatsCounters.begin());
 
     m_status.hasIncomingConnections = static_cast<bool>(stats[m_metricIndices.net.hasIncomingConnections]);
 
@@ -4845,46 +5487,45 @@ void Session::handleSessionStatsAlert(const lt::session_stats_alert *p)
         enqueueRefresh();
 }
 
-void Session::handleAlertsDroppedAlert(const lt::alerts_dropped_alert *p) const
+void Session::handleAlertsDroppedAlert(const lt::alerts_dropped_alert *p)
 {
+    ++m_droppedAlertsCount;
     LogMsg(tr("Error: Internal alert queue full and alerts were dropped, you might see degraded performance. Dropped alert types: %1. Message: %2")
         .arg(QString::fromStdString(p->dropped_alerts.to_string()), QString::fromStdString(p->message())), Log::CRITICAL);
 }
 
 void Session::handleStorageMovedAlert(const lt::storage_moved_alert *p)
 {
-    Q_ASSERT(!m_moveStorageQueue.isEmpty());
-
-    const MoveStorageJob &currentJob = m_moveStorageQueue.first();
-    Q_ASSERT(currentJob.torrentHandle == p->handle);
-
     const QString newPath {p->storage_path()};
-    Q_ASSERT(newPath == currentJob.path);
 
 #ifdef QBT_USES_LIBTORRENT2
-    const auto id = TorrentID::fromInfoHash(currentJob.torrentHandle.info_hashes());
+    const auto id = TorrentID::fromInfoHash(p->handle.info_hashes());
 #else
-    const auto id = TorrentID::fromInfoHash(currentJob.torrentHandle.info_hash());
+    const auto id = TorrentID::fromInfoHash(p->handle.info_hash());
 #endif
 
     TorrentImpl *torrent = m_torrents.value(id);
     const QString torrentName = (torrent ? torrent->name() : id.toString());
     LogMsg(tr("\"%1\" is successfully moved to \"%2\".").arg(torrentName, newPath));
 
-    handleMoveTorrentStorageJobFinished();
+    handleMoveTorrentStorageJobFinished(p->handle);
 }
 
 void Session::handleStorageMovedFailedAlert(const lt::storage_moved_failed_alert *p)
 {
-    Q_ASSERT(!m_moveStorageQueue.isEmpty());
-
-    const MoveStorageJob &currentJob = m_moveStorageQueue.first();
-    Q_ASSERT(currentJob.torrentHandle == p->handle);
+    const auto currentJob = std::find_if(m_moveStorageQueue.cbegin(), m_moveStorageQueue.cend()
+                                   , [p](const MoveStorageJob &job)
+    {
+        return job.isActive && (job.torrentHandle == p->handle);
+    });
+    Q_ASSERT(currentJob != m_moveStorageQueue.cend());
+    if (currentJob == m_moveStorageQueue.cend())
+        return;
 
 #ifdef QBT_USES_LIBTORRENT2
-    const auto id = TorrentID::fromInfoHash(currentJob.torrentHandle.info_hashes());
+    const auto id = TorrentID::fromInfoHash(p->handle.info_hashes());
 #else
-    const auto id = TorrentID::fromInfoHash(currentJob.torrentHandle.info_hash());
+    const auto id = TorrentID::fromInfoHash(p->handle.info_hash());
 #endif
 
     TorrentImpl *torrent = m_torrents.value(id);
@@ -4892,15 +5533,16 @@ void Session::handleStorageMovedFailedAlert(const lt::storage_moved_failed_alert
     const QString currentLocation = QString::fromStdString(p->handle.status(lt::torrent_handle::query_save_path).save_path);
     const QString errorMessage = QString::fromStdString(p->message());
     LogMsg(tr("Failed to move \"%1\" from \"%2\" to \"%3\". Reason: %4.")
-           .arg(torrentName, currentLocation, currentJob.path, errorMessage), Log::CRITICAL);
+           .arg(torrentName, currentLocation, currentJob->path, errorMessage), Log::CRITICAL);
 
-    handleMoveTorrentStorageJobFinished();
+    handleMoveTorrentStorageJobFinished(p->handle);
 }
 
 void Session::handleStateUpdateAlert(const lt::state_update_alert *p)
 {
     QVector<Torrent *> updatedTorrents;
     updatedTorrents.reserve(static_cast<decltype(updatedTorrents)::size_type>(p->status.size()));
+    QVector<TorrentImpl *> checkingTorrents;
 
     for (const lt::torrent_status &status : p->status)
     {
@@ -4915,8 +5557,12 @@ void Session::handleStateUpdateAlert(const lt::state_update_alert *p)
 
         torrent->handleStateUpdate(status);
         updatedTorrents.push_back(torrent);
+        if (torrent->isChecking())
+            checkingTorrents.push_back(torrent);
     }
 
+    m_recheckScheduler->handleTorrentsUpdated(checkingTorrents);
+
     if (!updatedTorrents.isEmpty())
         emit torrentsUpdated(updatedTorrents);
 
@@ -30,13 +30,16 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <variant>
 #include <vector>
 
 #include <libtorrent/add_torrent_params.hpp>
+#include <libtorrent/address.hpp>
 #include <libtorrent/fwd.hpp>
 #include <libtorrent/torrent_handle.hpp>
 
+#include <QElapsedTimer>
 #include <QHash>
 #include <QPointer>
 #include <QSet>
@@ -47,6 +50,7 @@
 #include "base/types.h"
 #include "addtorrentparams.h"
 #include "cachestatus.h"
+#include "infohash.h"
 #include "sessionstatus.h"
 #include "torrentinfo.h"
 #include "trackerentry.h"
@@ -63,6 +67,7 @@ class QUrl;
 class BandwidthScheduler;
 class FileSearcher;
 class FilterParserThread;
+class TorrentFileWorker;
 class Statistics;
 
 // These values should remain unchanged when adding new items
@@ -96,8 +101,32 @@ namespace BitTorrent
     class Tracker;
     struct LoadTorrentParams;
 
+    class RecheckScheduler;
+    struct RecheckStatus;
+    class TransferHistory;
+
     enum class MoveStorageMode;
 
+    struct MoveStorageJobStatus
+    {
+        TorrentID torrentID;
+        QString name;
+        QString sourcePath;
+        QString destinationPath;
+        qint64 totalSize = 0;
+        // Estimated from the files that already exist in the destination folder,
+        // sampled every few seconds so it may lag behind
+        qint64 movedSize = 0;
+        bool isActive = false;
+    };
+
+    struct SessionStatsMetric
+    {
+        // libtorrent name, e.g. "net.sent_bytes"
+        QByteArray name;
+        bool isGauge = false;
+    };
+
     // Using `Q_ENUM_NS()` without a wrapper namespace in our case is not advised
     // since `Q_NAMESPACE` cannot be used when the same namespace resides at different files.
     // https://www.kdab.com/new-qt-5-8-meta-object-support-namespaces/#comment-143779
@@ -303,6 +332,24 @@ namespace BitTorrent
 
         int saveResumeDataInterval() const;
         void setSaveResumeDataInterval(int value);
+        // Seconds to wait on exit for the resume data of the torrents to be generated,
+        // and then again for it to be written
+        int shutdownTimeout() const;
+        void setShutdownTimeout(int value);
+        // MiB, the cached data of idle torrents is released when the memory usage approaches it (0 means no limit).
+        // The usage is the private memory of the process where it can be determined, otherwise
+        // only the accounted data structures are counted.
+        int memoryBudget() const;
+        void setMemoryBudget(int value);
+        // Minutes, the metadata of seeds inactive for that long is unloaded (0 means never).
+        // Such seeds are only announced through DHT, LSD and PEX, not to the trackers, and their
+        // metadata is loaded back once some peer connects to them. Private torrents are never unloaded.
+        int metadataUnloadDelay() const;
+        void setMetadataUnloadDelay(int value);
+        int maxConcurrentMovesPerDevice() const;
+        void setMaxConcurrentMovesPerDevice(int value);
+        int maxConcurrentChecksPerDevice() const;
+        void setMaxConcurrentChecksPerDevice(int value);
         int port() const;
         void setPort(int port);
         QString networkInterface() const;
@@ -441,7 +488,11 @@ namespace BitTorrent
         void setOSMemoryPriority(OSMemoryPriority priority);
 #endif
 
+        // Starts loading the torrents of the previous session, in batches from the event loop
         void startUpTorrents();
+        bool isStartupFinished() const;
+        int startupTorrentsCount() const;
+        int startupLoadedTorrentsCount() const;
         Torrent *findTorrent(const TorrentID &id) const;
         QVector<Torrent *> torrents() const;
         bool hasActiveTorrents() const;
@@ -449,8 +500,15 @@ namespace BitTorrent
         bool hasRunningSeed() const;
         const SessionStatus &status() const;
         const CacheStatus &cacheStatus() const;
+        // All the libtorrent session counters and gauges.
+        // Counter values are indexed in the same way as their metrics.
+        const QVector<SessionStatsMetric> &sessionStatsMetrics() const;
+        const QVector<qint64> &sessionStatsCounters() const;
+        quint64 droppedAlertsCount() const;
+        int pendingResumeDataCount() const;
         quint64 getAlltimeDL() const;
         quint64 getAlltimeUL() const;
+        TransferHistory *transferHistory() const;
         bool isListening() const;
         bool isPaused() const;
 
@@ -458,6 +516,8 @@ namespace BitTorrent
         void setMaxRatioAction(MaxRatioAction act);
 
         void banIP(const QString &ip);
+        void banIPs(const QStringList &ips);
+        void unbanIPs(const QStringList &ips);
 
         bool isKnownTorrent(const TorrentID &id) const;
         bool addTorrent(const QString &source, const AddTorrentParams &params = AddTorrentParams());
@@ -486,6 +546,7 @@ namespace BitTorrent
         void handleTorrentMetadataReceived(TorrentImpl *const torrent);
         void handleTorrentPaused(TorrentImpl *const torrent);
         void handleTorrentResumed(TorrentImpl *const torrent);
+        void handleTorrentUnfinishedStateChanged(TorrentImpl *const torrent, bool isUnfinished);
         void handleTorrentChecked(TorrentImpl *const torrent);
         void handleTorrentFinished(TorrentImpl *const torrent);
         void handleTorrentTrackersAdded(TorrentImpl *const torrent, const QVector<TrackerEntry> &newTrackers);
@@ -494,13 +555,20 @@ namespace BitTorrent
         void handleTorrentUrlSeedsAdded(TorrentImpl *const torrent, const QVector<QUrl> &newUrlSeeds);
         void handleTorrentUrlSeedsRemoved(TorrentImpl *const torrent, const QVector<QUrl> &urlSeeds);
         void handleTorrentResumeDataReady(TorrentImpl *const torrent, const LoadTorrentParams &data);
+        void handleTorrentResumeDataFailed(const TorrentImpl *torrent);
         void handleTorrentTrackerReply(TorrentImpl *const torrent, const QString &trackerUrl);
         void handleTorrentTrackerWarning(TorrentImpl *const torrent, const QString &trackerUrl);
         void handleTorrentTrackerError(TorrentImpl *const torrent, const QString &trackerUrl);
 
         bool addMoveTorrentStorageJob(TorrentImpl *torrent, const QString &newPath, MoveStorageMode mode);
+        QVector<MoveStorageJobStatus> moveStorageJobs();
+
+        void enqueueRecheck(TorrentImpl *torrent);
+        bool isRecheckQueued(const TorrentImpl *torrent) const;
+        RecheckStatus recheckStatus() const;
 
         void findIncompleteFiles(const TorrentInfo &torrentInfo, const QString &savePath) const;
+        std::optional<LoadTorrentParams> loadTorrentResumeData(const TorrentID &id) const;
 
     signals:
         void allTorrentsFinished();
@@ -514,6 +582,7 @@ namespace BitTorrent
         void metadataDownloaded(const TorrentInfo &info);
         void recursiveTorrentDownloadPossible(Torrent *torrent);
         void speedLimitModeChanged(bool alternative);
+        void startupFinished();
         void statsUpdated();
         void subcategoriesSupportChanged();
         void tagAdded(const QString &tag);
@@ -546,10 +615,14 @@ namespace BitTorrent
         void enqueueRefresh();
         void processShareLimits();
         void generateResumeData();
+        void enforceMemoryBudget();
+        void unloadInactiveMetadata();
         void handleIPFilterParsed(int ruleCount);
         void handleIPFilterError();
         void handleDownloadFinished(const Net::DownloadResult &result);
         void fileSearchFinished(const TorrentID &id, const QString &savePath, const QStringList &fileNames);
+        void handleTorrentFilesFound(const TorrentID &id);
+        void handleResumeDataStored(const TorrentID &id, bool success);
 
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
         // Session reconfiguration triggers
@@ -563,6 +636,11 @@ namespace BitTorrent
             lt::torrent_handle torrentHandle;
             QString path;
             MoveStorageMode mode;
+            QString sourcePath;
+            QString sourceDeviceID;
+            QString destinationDeviceID;
+            qint64 totalSize = 0;
+            bool isActive = false;
         };
 
         struct RemovingTorrentData
@@ -591,6 +669,7 @@ namespace BitTorrent
         void adjustLimits();
         void applyBandwidthLimits();
         void processBannedIPs(lt::ip_filter &filter);
+        void setBannedAddresses(std::vector<lt::address> addresses);
         QStringList getListeningIPs() const;
         void configureListeningInterface();
         void enableTracker(bool enable);
@@ -602,12 +681,17 @@ namespace BitTorrent
         void applyOSMemoryPriority() const;
 #endif
 
+        void loadStartupTorrents();
+        void finishStartup();
+        void emitDeferredAllTorrentsFinished();
+
         bool loadTorrent(LoadTorrentParams params);
         LoadTorrentParams initLoadTorrentParams(const AddTorrentParams &addTorrentParams);
         bool addTorrent_impl(const std::variant<MagnetUri, TorrentInfo> &source, const AddTorrentParams &addTorrentParams);
 
         void updateSeedingLimitTimer();
         void exportTorrentFile(const TorrentInfo &torrentInfo, const QString &folderPath, const QString &baseName);
+        void exportTorrentFile(const lt::torrent_handle &nativeHandle, const QString &folderPath, const QString &baseName);
 
         void handleAlert(const lt::alert *a);
         void dispatchTorrentAlert(const lt::alert *a);
@@ -627,7 +711,7 @@ namespace BitTorrent
         void handleListenFailedAlert(const lt::listen_failed_alert *p);
         void handleExternalIPAlert(const lt::external_ip_alert *p);
         void handleSessionStatsAlert(const lt::session_stats_alert *p);
-        void handleAlertsDroppedAlert(const lt::alerts_dropped_alert *p) const;
+        void handleAlertsDroppedAlert(const lt::alerts_dropped_alert *p);
         void handleStorageMovedAlert(const lt::storage_moved_alert *p);
         void handleStorageMovedFailedAlert(const lt::storage_moved_failed_alert *p);
         void handleSocks5Alert(const lt::socks5_alert *p) const;
@@ -635,13 +719,16 @@ namespace BitTorrent
         void createTorrent(const lt::torrent_handle &nativeHandle);
 
         void saveResumeData();
+        void storeResumeData(const TorrentID &id, const LoadTorrentParams &resumeData);
         void saveTorrentsQueue() const;
         void removeTorrentsQueue() const;
 
         std::vector<lt::alert *> getPendingAlerts(lt::time_duration time = lt::time_duration::zero()) const;
 
         void moveTorrentStorage(const MoveStorageJob &job) const;
-        void handleMoveTorrentStorageJobFinished();
+        void sampleMovedStorageSizes();
+        void startMoveStorageJobs();
+        void handleMoveTorrentStorageJobFinished(const lt::torrent_handle &torrentHandle);
 
         // BitTorrent
         lt::session *m_nativeSession = nullptr;
@@ -722,6 +809,11 @@ namespace BitTorrent
         CachedSettingValue<bool> m_isAltGlobalSpeedLimitEnabled;
         CachedSettingValue<bool> m_isBandwidthSchedulerEnabled;
         CachedSettingValue<int> m_saveResumeDataInterval;
+        CachedSettingValue<int> m_shutdownTimeout;
+        CachedSettingValue<int> m_memoryBudget;
+        CachedSettingValue<int> m_metadataUnloadDelay;
+        CachedSettingValue<int> m_maxConcurrentMovesPerDevice;
+        CachedSettingValue<int> m_maxConcurrentChecksPerDevice;
         CachedSettingValue<int> m_port;
         CachedSettingValue<QString> m_networkInterface;
         CachedSettingValue<QString> m_networkInterfaceName;
@@ -746,6 +838,8 @@ namespace BitTorrent
         CachedSettingValue<int> m_peerTurnoverCutoff;
         CachedSettingValue<int> m_peerTurnoverInterval;
         CachedSettingValue<QStringList> m_bannedIPs;
+        // parsed m_bannedIPs, sorted and unique
+        std::vector<lt::address> m_bannedAddresses;
         CachedSettingValue<ResumeDataStorageType> m_resumeDataStorageType;
 #if defined(Q_OS_WIN)
         CachedSettingValue<OSMemoryPriority> m_OSMemoryPriority;
@@ -763,7 +857,10 @@ namespace BitTorrent
         bool m_refreshEnqueued = false;
         QTimer *m_seedingLimitTimer = nullptr;
         QTimer *m_resumeDataTimer = nullptr;
+        QTimer *m_memoryBudgetTimer = nullptr;
+        QTimer *m_metadataUnloadTimer = nullptr;
         Statistics *m_statistics = nullptr;
+        TransferHistory *m_transferHistory = nullptr;
         // IP filtering
         QPointer<FilterParserThread> m_filterParser;
         QPointer<BandwidthScheduler> m_bwScheduler;
@@ -772,15 +869,34 @@ namespace BitTorrent
 
         QThread *m_ioThread = nullptr;
         ResumeDataStorage *m_resumeDataStorage = nullptr;
+        // Number of the resume data stores of each torrent that haven't completed yet
+        QHash<TorrentID, int> m_pendingResumeDataStores;
         FileSearcher *m_fileSearcher = nullptr;
+        TorrentFileWorker *m_torrentFileWorker = nullptr;
+        RecheckScheduler *m_recheckScheduler = nullptr;
 
         QSet<TorrentID> m_downloadedMetadata;
 
         QHash<TorrentID, TorrentImpl *> m_torrents;
+        // Torrents that are neither finished, paused nor errored
+        QSet<TorrentID> m_unfinishedTorrents;
         QHash<TorrentID, LoadTorrentParams> m_loadingTorrents;
+        // Torrents of the previous session, loaded during startup
+        ResumeDataStorage *m_startupStorage = nullptr;
+        QVector<TorrentID> m_startupTorrents;
+        QSet<TorrentID> m_pendingStartupTorrents;
+        QVector<TorrentID> m_startupQueue;
+        int m_startupLoadedCount = 0;
+        bool m_isStartupFinished = false;
+        // allTorrentsFinished() is deferred until all the torrents are loaded
+        bool m_isAllTorrentsFinishedDeferred = false;
+        QElapsedTimer m_startupTimer;
         QHash<QString, AddTorrentParams> m_downloadedTorrents;
         QHash<TorrentID, RemovingTorrentData> m_removingTorrents;
         QSet<TorrentID> m_needSaveResumeDataTorrents;
+        // On exit the resume data are collected to be stored at once
+        bool m_isCollectingResumeData = false;
+        QHash<TorrentID, LoadTorrentParams> m_collectedResumeData;
         QStringMap m_categories;
         QSet<QString> m_tags;
 
@@ -790,6 +906,9 @@ namespace BitTorrent
 
         SessionMetricIndices m_metricIndices;
         lt::time_point m_statsLastTimestamp = lt::clock_type::now();
+        QVector<SessionStatsMetric> m_sessionStatsMetrics;
+        QVector<qint64> m_sessionStatsCounters;
+        quint64 m_droppedAlertsCount = 0;
 
         SessionStatus m_status;
         CacheStatus m_cacheStatus;
@@ -797,7 +916,16 @@ namespace BitTorrent
         QNetworkConfigurationManager *m_networkManager = nullptr;
 #endif
 
+        // Jobs of the same torrent run in the order they were added.
+        // Jobs of different torrents run concurrently as long as neither
+        // the source nor the destination device has too many active jobs.
         QList<MoveStorageJob> m_moveStorageQueue;
+        QHash<QString, int> m_activeMoveStorageJobsPerDevice;
+        // Moved size of the active jobs. It is sampled on the I/O thread
+        // since every file of the torrent has to be looked up at the destination.
+        QHash<TorrentID, qint64> m_movedStorageSizes;
+        QElapsedTimer m_movedStorageSizesSampleTimer;
+        bool m_isSamplingMovedStorageSizes = false;
 
         QString m_lastExternalIP;
 
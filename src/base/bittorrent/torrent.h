@@ -213,6 +213,9 @@ namespace BitTorrent
         virtual bool hasFirstLastPiecePriority() const = 0;
         virtual TorrentState state() const = 0;
         virtual bool hasMetadata() const = 0;
+        // The metadata of an inactive seed can be unloaded to save memory,
+        // it has to be loaded back before accessing the torrent's files or pieces
+        virtual bool isMetadataUnloaded() const = 0;
         virtual bool hasMissingFiles() const = 0;
         virtual bool hasError() const = 0;
         virtual int queuePosition() const = 0;
@@ -293,6 +296,7 @@ namespace BitTorrent
         virtual void removeUrlSeeds(const QVector<QUrl> &urlSeeds) = 0;
         virtual bool connectPeer(const PeerAddress &peerAddress) = 0;
         virtual void clearPeers() = 0;
+        virtual void loadMetadata() = 0;
 
         virtual QString createMagnetURI() const = 0;
 
@@ -0,0 +1,272 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentcreationmanager.h"
+
+#include <QUuid>
+
+#include "base/global.h"
+#include "base/utils/fs.h"
+
+namespace
+{
+    const int MAX_FINISHED_TASKS = 50;
+}
+
+using namespace BitTorrent;
+
+TorrentCreationTask::TorrentCreationTask(const QString &id, const TorrentCreatorParams &params, QObject *parent)
+    : QObject(parent)
+    , m_id(id)
+    , m_params(params)
+    , m_timeAdded(QDateTime::currentDateTime())
+{
+}
+
+QString TorrentCreationTask::id() const
+{
+    return m_id;
+}
+
+const TorrentCreatorParams &TorrentCreationTask::params() const
+{
+    return m_params;
+}
+
+TorrentCreationTask::State TorrentCreationTask::state() const
+{
+    return m_state;
+}
+
+int TorrentCreationTask::progress() const
+{
+    return m_progress;
+}
+
+QString TorrentCreationTask::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+QDateTime TorrentCreationTask::timeAdded() const
+{
+    return m_timeAdded;
+}
+
+QDateTime TorrentCreationTask::timeStarted() const
+{
+    return m_timeStarted;
+}
+
+QDateTime TorrentCreationTask::timeFinished() const
+{
+    return m_timeFinished;
+}
+
+void TorrentCreationTask::start()
+{
+    if (m_state != State::Queued)
+        return;
+
+    m_state = State::Running;
+    m_timeStarted = QDateTime::currentDateTime();
+
+    m_creatorThread = new TorrentCreatorThread(this);
+    connect(m_creatorThread, &TorrentCreatorThread::creationSuccess, this, &TorrentCreationTask::handleCreationSuccess);
+    connect(m_creatorThread, &TorrentCreatorThread::creationFailure, this, &TorrentCreationTask::handleCreationFailure);
+    connect(m_creatorThread, &TorrentCreatorThread::updateProgress, this, [this](const int progress)
+    {
+        m_progress = progress;
+    });
+    m_creatorThread->create(m_params);
+}
+
+void TorrentCreationTask::handleCreationSuccess()
+{
+    m_state = State::Finished;
+    m_progress = 100;
+    m_timeFinished = QDateTime::currentDateTime();
+    m_creatorThread->deleteLater();
+    m_creatorThread = nullptr;
+    emit finished();
+}
+
+void TorrentCreationTask::handleCreationFailure(const QString &msg)
+{
+    m_state = State::Failed;
+    m_errorMessage = msg;
+    m_timeFinished = QDateTime::currentDateTime();
+    m_creatorThread->deleteLater();
+    m_creatorThread = nullptr;
+    emit finished();
+}
+
+TorrentCreationManager *TorrentCreationManager::m_instance = nullptr;
+
+TorrentCreationManager::~TorrentCreationManager()
+{
+    // Running creator threads are interrupted by the task destructors
+    for (TorrentCreationTask *task : asConst(m_orderedTasks))
+        removeTask(task);
+}
+
+void TorrentCreationManager::initInstance()
+{
+    if (!m_instance)
+        m_instance = new TorrentCreationManager;
+}
+
+void TorrentCreationManager::freeInstance()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+TorrentCreationManager *TorrentCreationManager::instance()
+{
+    return m_instance;
+}
+
+QString TorrentCreationManager::addTask(TorrentCreatorParams params)
+{
+    const QString id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    if (params.savePath.isEmpty())
+        params.savePath = Utils::Fs::tempPath() + id + QLatin1String(".torrent");
+
+    auto *task = new TorrentCreationTask(id, params, this);
+    connect(task, &TorrentCreationTask::finished, this, [this, task]()
+    {
+        handleTaskFinished(task);
+    });
+
+    m_tasks.insert(id, task);
+    m_orderedTasks.append(task);
+
+    if (!m_runningTask)
+        startNextTask();
+
+    return id;
+}
+
+TorrentCreationTask *TorrentCreationManager::task(const QString &id) const
+{
+    return m_tasks.value(id);
+}
+
+QVector<TorrentCreationTask *> TorrentCreationManager::tasks() const
+{
+    return m_orderedTasks;
+}
+
+bool TorrentCreationManager::deleteTask(const QString &id)
+{
+    TorrentCreationTask *task = m_tasks.take(id);
+    if (!task)
+        return false;
+
+    m_orderedTasks.removeOne(task);
+
+    const bool wasRunning = (task == m_runningTask);
+    removeTask(task);
+
+    if (wasRunning)
+        startNextTask();
+
+    return true;
+}
+
+void TorrentCreationManager::handleTaskFinished(TorrentCreationTask *task)
+{
+    emit taskFinished(task);
+
+    if (task == m_runningTask)
+        startNextTask();
+
+    pruneFinishedTasks();
+}
+
+void TorrentCreationManager::pruneFinishedTasks()
+{
+    int finishedCount = 0;
+    for (const TorrentCreationTask *task : asConst(m_orderedTasks))
+    {
+        if ((task->state() == TorrentCreationTask::State::Finished)
+            || (task->state() == TorrentCreationTask::State::Failed))
+        {
+            ++finishedCount;
+        }
+    }
+
+    // The oldest tasks come first
+    for (auto it = m_orderedTasks.begin(); (finishedCount > MAX_FINISHED_TASKS) && (it != m_orderedTasks.end());)
+    {
+        TorrentCreationTask *task = *it;
+        if ((task->state() == TorrentCreationTask::State::Finished)
+            || (task->state() == TorrentCreationTask::State::Failed))
+        {
+            it = m_orderedTasks.erase(it);
+            m_tasks.remove(task->id());
+            // The task can't be deleted while it is emitting its finished() signal
+            task->deleteLater();
+            if (task->params().savePath.startsWith(Utils::Fs::tempPath()))
+                Utils::Fs::forceRemove(task->params().savePath);
+            --finishedCount;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void TorrentCreationManager::removeTask(TorrentCreationTask *task)
+{
+    const QString torrentFilePath = task->params().savePath;
+    const bool isTemporaryFile = torrentFilePath.startsWith(Utils::Fs::tempPath());
+
+    // Deleting the task waits for its creator thread to be interrupted
+    delete task;
+
+    if (isTemporaryFile)
+        Utils::Fs::forceRemove(torrentFilePath);
+}
+
+void TorrentCreationManager::startNextTask()
+{
+    m_runningTask = nullptr;
+
+    for (TorrentCreationTask *task : asConst(m_orderedTasks))
+    {
+        if (task->state() == TorrentCreationTask::State::Queued)
+        {
+            m_runningTask = task;
+            task->start();
+            return;
+        }
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+#include "torrentcreatorthread.h"
+
+namespace BitTorrent
+{
+    class TorrentCreationTask final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(TorrentCreationTask)
+
+    public:
+        enum class State
+        {
+            Queued,
+            Running,
+            Finished,
+            Failed
+        };
+
+        TorrentCreationTask(const QString &id, const TorrentCreatorParams &params, QObject *parent = nullptr);
+
+        QString id() const;
+        const TorrentCreatorParams &params() const;
+        State state() const;
+        int progress() const;
+        QString errorMessage() const;
+        QDateTime timeAdded() const;
+        QDateTime timeStarted() const;
+        QDateTime timeFinished() const;
+
+        void start();
+
+    signals:
+        void finished();
+
+    private:
+        void handleCreationSuccess();
+        void handleCreationFailure(const QString &msg);
+
+        QString m_id;
+        TorrentCreatorParams m_params;
+        State m_state = State::Queued;
+        int m_progress = 0;
+        QString m_errorMessage;
+        QDateTime m_timeAdded;
+        QDateTime m_timeStarted;
+        QDateTime m_timeFinished;
+        TorrentCreatorThread *m_creatorThread = nullptr;
+    };
+
+    // Runs queued torrent creation tasks one after another.
+    // Each task uses all hashing threads, so running them concurrently
+    // would only compete for the same disks and CPU cores.
+    class TorrentCreationManager final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(TorrentCreationManager)
+
+    public:
+        static void initInstance();
+        static void freeInstance();
+        static TorrentCreationManager *instance();
+
+        // Returns the ID of the new task.
+        // If 'params.savePath' is empty the torrent file is stored in the temporary folder.
+        QString addTask(TorrentCreatorParams params);
+        TorrentCreationTask *task(const QString &id) const;
+        // Tasks in the order they were added.
+        // Only the most recent finished or failed tasks are kept.
+        QVector<TorrentCreationTask *> tasks() const;
+        // Cancels the task if it is running
+        bool deleteTask(const QString &id);
+
+    signals:
+        void taskFinished(TorrentCreationTask *task);
+
+    private:
+        TorrentCreationManager() = default;
+        ~TorrentCreationManager() override;
+
+        void handleTaskFinished(TorrentCreationTask *task);
+        void startNextTask();
+        void pruneFinishedTasks();
+        // Removes the torrent file too if it was stored in the temporary folder
+        void removeTask(TorrentCreationTask *task);
+
+        QHash<QString, TorrentCreationTask *> m_tasks;
+        QVector<TorrentCreationTask *> m_orderedTasks;
+        QPointer<TorrentCreationTask> m_runningTask;
+
+        static TorrentCreationManager *m_instance;
+    };
+}
@@ -28,10 +28,12 @@
 
 #include "torrentcreatorthread.h"
 
+#include <algorithm>
 #include <fstream>
 
 #include <libtorrent/create_torrent.hpp>
 #include <libtorrent/file_storage.hpp>
+#include <libtorrent/settings_pack.hpp>
 #include <libtorrent/torrent_info.hpp>
 
 #include <QDirIterator>
@@ -182,12 +184,30 @@ void TorrentCreatorThread::run()
         }
 
         // calculate the hash for all pieces
+#ifdef QBT_USES_LIBTORRENT2
+        // Pieces are hashed concurrently by libtorrent's hasher threads and may
+        // complete out of order, so progress is based on the number of hashed pieces
+        lt::settings_pack settingsPack;
+        settingsPack.set_int(lt::settings_pack::hashing_threads, std::max(1, QThread::idealThreadCount()));
+
+        int hashedPieces = 0;
+        lt::error_code ec;
+        lt::set_piece_hashes(newTorrent, Utils::Fs::toNativePath(parentPath).toStdString(), settingsPack
+            , [this, &newTorrent, &hashedPieces](const lt::piece_index_t)
+        {
+            checkInterruptionRequested();
+            sendProgressSignal(++hashedPieces, newTorrent.num_pieces());
+        }, ec);
+        if (ec)
+            throw RuntimeError(QString::fromLocal8Bit(ec.message().c_str()));
+#else
         lt::set_piece_hashes(newTorrent, Utils::Fs::toNativePath(parentPath).toStdString()
             , [this, &newTorrent](const lt::piece_index_t n)
         {
             checkInterruptionRequested();
             sendProgressSignal(LT::toUnderlyingType(n), newTorrent.num_pieces());
         });
+#endif
 
         // Set qBittorrent as creator and add user comment to
         // torrent_info structure
@@ -0,0 +1,87 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentfileworker.h"
+
+#include <QDir>
+#include <QFile>
+
+#include "base/logger.h"
+#include "base/utils/fs.h"
+#include "infohash.h"
+#include "torrentinfo.h"
+
+void TorrentFileWorker::exportTorrentFile(const BitTorrent::TorrentInfo &torrentInfo, const QString &folderPath, const QString &baseName)
+{
+    const QString validName = Utils::Fs::toValidFileSystemName(baseName);
+    QString torrentExportFilename = QString::fromLatin1("%1.torrent").arg(validName);
+    const QDir exportDir {folderPath};
+    if (exportDir.exists() || exportDir.mkpath(exportDir.absolutePath()))
+    {
+        QString newTorrentPath = exportDir.absoluteFilePath(torrentExportFilename);
+        int counter = 0;
+        while (QFile::exists(newTorrentPath))
+        {
+            // Append number to torrent name to make it unique
+            torrentExportFilename = QString::fromLatin1("%1 %2.torrent").arg(validName).arg(++counter);
+            newTorrentPath = exportDir.absoluteFilePath(torrentExportFilename);
+        }
+
+        const nonstd::expected<void, QString> result = torrentInfo.saveToFile(newTorrentPath);
+        if (!result)
+        {
+            LogMsg(tr("Couldn't export torrent metadata file '%1'. Reason: %2.")
+                   .arg(newTorrentPath, result.error()), Log::WARNING);
+        }
+    }
+}
+
+void TorrentFileWorker::exportTorrentFile(const lt::torrent_handle &nativeHandle, const QString &folderPath, const QString &baseName)
+{
+#ifdef QBT_USES_LIBTORRENT2
+    const BitTorrent::TorrentInfo torrentInfo {nativeHandle.torrent_file_with_hashes()};
+#else
+    const BitTorrent::TorrentInfo torrentInfo {nativeHandle.torrent_file()};
+#endif
+    if (torrentInfo.isValid())
+        exportTorrentFile(torrentInfo, folderPath, baseName);
+}
+
+void TorrentFileWorker::findTorrentFiles(const BitTorrent::TorrentID &id, const QStringList &filePaths)
+{
+    for (const QString &filePath : filePaths)
+    {
+        if (BitTorrent::TorrentInfo::loadFromFile(filePath))
+        {
+            emit torrentFilesFound(id);
+            return;
+        }
+
+        LogMsg(tr("Unable to decode '%1' torrent file.").arg(Utils::Fs::toNativePath(filePath)), Log::CRITICAL);
+    }
+}
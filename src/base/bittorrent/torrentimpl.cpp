@@ -58,6 +58,7 @@
 #include "base/global.h"
 #include "base/logger.h"
 #include "base/preferences.h"
+#include "base/utils/bitfield.h"
 #include "base/utils/fs.h"
 #include "base/utils/string.h"
 #include "common.h"
@@ -240,6 +241,45 @@ namespace
         status.pieces = params.have_pieces;
         status.verified_pieces = params.verified_pieces;
     }
+
+    template <typename Bitfield>
+    qint64 bitfieldSize(const Bitfield &bitfield)
+    {
+        return (bitfield.size() + 7) / 8;
+    }
+
+    qint64 stringsSize(const std::vector<std::string> &strings)
+    {
+        qint64 size = strings.size() * sizeof(std::string);
+        for (const std::string &str : strings)
+            size += str.capacity();
+        return size;
+    }
+
+    qint64 estimateSize(const lt::add_torrent_params &params)
+    {
+        qint64 size = sizeof(params) + bitfieldSize(params.have_pieces) + bitfieldSize(params.verified_pieces)
+            + (params.piece_priorities.size() * sizeof(lt::download_priority_t))
+            + (params.file_priorities.size() * sizeof(lt::download_priority_t))
+            + ((params.peers.size() + params.banned_peers.size()) * sizeof(lt::tcp::endpoint))
+            + stringsSize(params.trackers) + stringsSize(params.url_seeds) + stringsSize(params.http_seeds)
+            + params.name.capacity() + params.save_path.capacity();
+        for (const auto &unfinishedPiece : params.unfinished_pieces)
+            size += sizeof(unfinishedPiece) + bitfieldSize(unfinishedPiece.second);
+        for (const auto &renamedFile : params.renamed_files)
+            size += sizeof(renamedFile) + renamedFile.second.capacity();
+#ifdef QBT_USES_LIBTORRENT2
+        for (const auto &tree : params.merkle_trees)
+            size += tree.size() * sizeof(lt::sha256_hash);
+        for (const auto &mask : params.merkle_tree_mask)
+            size += (mask.size() + 7) / 8;
+        for (const auto &hashes : params.verified_leaf_hashes)
+            size += (hashes.size() + 7) / 8;
+#else
+        size += params.merkle_tree.size() * sizeof(lt::sha1_hash);
+#endif
+        return size;
+    }
 }
 
 // TorrentImpl
@@ -327,6 +367,9 @@ QString TorrentImpl::name() const
     if (!m_name.isEmpty())
         return m_name;
 
+    if (m_metadataSummary)
+        return m_metadataSummary->name;
+
     if (hasMetadata())
         return m_torrentInfo.name();
 
@@ -339,26 +382,41 @@ QString TorrentImpl::name() const
 
 QDateTime TorrentImpl::creationDate() const
 {
+    if (m_metadataSummary)
+        return m_metadataSummary->creationDate;
+
     return m_torrentInfo.creationDate();
 }
 
 QString TorrentImpl::creator() const
 {
+    if (m_metadataSummary)
+        return m_metadataSummary->creator;
+
     return m_torrentInfo.creator();
 }
 
 QString TorrentImpl::comment() const
 {
+    if (m_metadataSummary)
+        return m_metadataSummary->comment;
+
     return m_torrentInfo.comment();
 }
 
 bool TorrentImpl::isPrivate() const
 {
+    if (m_metadataSummary)
+        return m_metadataSummary->isPrivate;
+
     return m_torrentInfo.isPrivate();
 }
 
 qlonglong TorrentImpl::totalSize() const
 {
+    if (m_metadataSummary)
+        return m_metadataSummary->totalSize;
+
     return m_torrentInfo.totalSize();
 }
 
@@ -375,6 +433,9 @@ qlonglong TorrentImpl::completedSize() const
 
 qlonglong TorrentImpl::pieceLength() const
 {
+    if (m_metadataSummary)
+        return m_metadataSummary->pieceLength;
+
     return m_torrentInfo.pieceLength();
 }
 
@@ -401,12 +462,7 @@ QString TorrentImpl::rootPath(bool actual) const
     if (!hasMetadata())
         return {};
 
-    const QString firstFilePath = filePath(0);
-    const int slashIndex = firstFilePath.indexOf('/');
-    if (slashIndex >= 0)
-        return QDir(savePath(actual)).absoluteFilePath(firstFilePath.left(slashIndex));
-    else
-        return QDir(savePath(actual)).absoluteFilePath(firstFilePath);
+    return QDir(savePath(actual)).absoluteFilePath(relativeRootPath());
 }
 
 QString TorrentImpl::contentPath(const bool actual) const
@@ -414,13 +470,35 @@ QString TorrentImpl::contentPath(const bool actual) const
     if (!hasMetadata())
         return {};
 
+    const QString relativePath = relativeContentPath();
+    if (relativePath.isEmpty())
+        return savePath(actual);
+
+    return QDir(savePath(actual)).absoluteFilePath(relativePath);
+}
+
+QString TorrentImpl::relativeRootPath() const
+{
+    if (m_metadataSummary)
+        return m_metadataSummary->rootPath;
+
+    const QString firstFilePath = filePath(0);
+    const int slashIndex = firstFilePath.indexOf('/');
+    return (slashIndex >= 0) ? firstFilePath.left(slashIndex) : firstFilePath;
+}
+
+QString TorrentImpl::relativeContentPath() const
+{
+    if (m_metadataSummary)
+        return m_metadataSummary->contentPath;
+
     if (filesCount() == 1)
-        return QDir(savePath(actual)).absoluteFilePath(filePath(0));
+        return filePath(0);
 
     if (m_torrentInfo.hasRootFolder())
-        return rootPath(actual);
+        return relativeRootPath();
 
-    return savePath(actual);
+    return {};
 }
 
 bool TorrentImpl::isAutoTMMEnabled() const
@@ -445,6 +523,212 @@ QString TorrentImpl::actualStorageLocation() const
     return QString::fromStdString(m_nativeStatus.save_path);
 }
 
+qint64 TorrentImpl::resumeDataCacheSize() const
+{
+    return estimateSize(m_ltAddTorrentParams);
+}
+
+qint64 TorrentImpl::statusCacheSize() const
+{
+    return sizeof(m_nativeStatus) + bitfieldSize(m_nativeStatus.pieces) + bitfieldSize(m_nativeStatus.verified_pieces)
+        + m_nativeStatus.name.capacity() + m_nativeStatus.save_path.capacity() + m_nativeStatus.current_tracker.capacity();
+}
+
+qint64 TorrentImpl::metadataSize() const
+{
+    const std::shared_ptr<const lt::torrent_info> nativeInfo = m_torrentInfo.nativeInfo();
+    if (!nativeInfo)
+        return 0;
+
+    // File entries refer to their names in the info section, so only their fixed part is added
+    const qint64 fileEntrySize = 64;
+#ifdef QBT_USES_LIBTORRENT2
+    const qint64 infoSectionSize = nativeInfo->info_section().size();
+#else
+    const qint64 infoSectionSize = nativeInfo->metadata_size();
+#endif
+    return sizeof(lt::torrent_info) + infoSectionSize + (nativeInfo->num_files() * fileEntrySize);
+}
+
+qint64 TorrentImpl::releaseResumeDataCache()
+{
+    // The cached resume data is used to reload the torrent, which only happens
+    // while its metadata is being handled or its files are missing, so the cache
+    // of idle seeds can be released and restored from the resume data storage
+    if (m_isResumeDataCacheReleased || m_metadataSummary || !isSeed() || m_hasMissingFiles
+        || (m_maintenanceJob != MaintenanceJob::None) || (m_nativeStatus.num_peers > 0))
+    {
+        return 0;
+    }
+
+    const qint64 oldSize = resumeDataCacheSize();
+
+    lt::add_torrent_params &p = m_ltAddTorrentParams;
+    p.have_pieces = {};
+    p.verified_pieces = {};
+    p.unfinished_pieces = {};
+    p.piece_priorities = {};
+    p.peers = {};
+    p.banned_peers = {};
+#ifdef QBT_USES_LIBTORRENT2
+    p.merkle_trees = {};
+    p.merkle_tree_mask = {};
+    p.verified_leaf_hashes = {};
+#else
+    p.merkle_tree = {};
+#endif
+    m_isResumeDataCacheReleased = true;
+
+    return oldSize - resumeDataCacheSize();
+}
+
+void TorrentImpl::restoreResumeDataCache()
+{
+    // The torrent may be reloaded long after its cache was released (e.g. once its files
+    // were moved or found missing), so it must not be assumed to be still complete.
+    // The piece information is taken from the stored resume data instead so libtorrent
+    // validates it against the files. If it can't be loaded, the torrent gets rechecked.
+    const std::optional<LoadTorrentParams> resumeData = m_session->loadTorrentResumeData(id());
+    if (resumeData)
+    {
+        const lt::add_torrent_params &storedParams = resumeData->ltAddTorrentParams;
+        m_ltAddTorrentParams.have_pieces = storedParams.have_pieces;
+        m_ltAddTorrentParams.verified_pieces = storedParams.verified_pieces;
+        m_ltAddTorrentParams.unfinished_pieces = storedParams.unfinished_pieces;
+        m_ltAddTorrentParams.piece_priorities = storedParams.piece_priorities;
+#ifdef QBT_USES_LIBTORRENT2
+        m_ltAddTorrentParams.merkle_trees = storedParams.merkle_trees;
+        m_ltAddTorrentParams.merkle_tree_mask = storedParams.merkle_tree_mask;
+        m_ltAddTorrentParams.verified_leaf_hashes = storedParams.verified_leaf_hashes;
+#else
+        m_ltAddTorrentParams.merkle_tree = storedParams.merkle_tree;
+#endif
+    }
+
+    m_isResumeDataCacheReleased = false;
+}
+
+bool TorrentImpl::canUnloadMetadata() const
+{
+    // While the metadata is unloaded, the peers can find the torrent only through DHT, LSD and PEX
+    // (see reload()), so private torrents and those not using DHT aren't eligible.
+    // Queued seeds would take no queue slot once unloaded and would be started instead.
+    return (m_torrentInfo.isValid() && isSeed() && !isChecking() && !m_hasMissingFiles && !hasError()
+        && !isMoveInProgress() && (m_renameCount == 0) && (m_maintenanceJob == MaintenanceJob::None)
+        && (m_nativeStatus.num_peers == 0) && !isPrivate() && !isQueued()
+        && !isDHTDisabled() && m_session->isDHTEnabled());
+}
+
+bool TorrentImpl::unloadMetadata(const int inactiveTime)
+{
+    if (m_isMetadataUnloadRequested || !canUnloadMetadata())
+        return false;
+
+    const QDateTime now = QDateTime::currentDateTime();
+    qlonglong idleTime = timeSinceActivity();
+    if (idleTime < 0)
+        idleTime = addedTime().secsTo(now);
+    // Otherwise the metadata loaded back for some peer which didn't download anything
+    // would be unloaded again right away
+    if (m_metadataLoadTime.isValid())
+        idleTime = std::min(idleTime, m_metadataLoadTime.secsTo(now));
+    if (idleTime < inactiveTime)
+        return false;
+
+    // The metadata is unloaded when the requested resume data is written to the storage
+    // (see handleResumeDataStored()) so it can be loaded back from there
+    m_isMetadataUnloadRequested = true;
+    saveResumeData();
+    return true;
+}
+
+void TorrentImpl::unloadMetadata_impl()
+{
+    MetadataSummary summary;
+    summary.name = m_torrentInfo.name();
+    summary.creationDate = m_torrentInfo.creationDate();
+    summary.creator = m_torrentInfo.creator();
+    summary.comment = m_torrentInfo.comment();
+    summary.isPrivate = m_torrentInfo.isPrivate();
+    summary.totalSize = m_torrentInfo.totalSize();
+    summary.wantedSize = m_nativeStatus.total_wanted;
+    summary.pieceLength = m_torrentInfo.pieceLength();
+    summary.piecesCount = m_torrentInfo.piecesCount();
+    summary.piecesHave = m_nativeStatus.num_pieces;
+    summary.rootPath = relativeRootPath();
+    summary.contentPath = relativeContentPath();
+    summary.activeTime = m_ltAddTorrentParams.active_time;
+    summary.finishedTime = m_ltAddTorrentParams.finished_time;
+    summary.seedingTime = m_ltAddTorrentParams.seeding_time;
+
+    // Keep the torrent in the session without metadata so the peers can still find it
+    // through DHT and the metadata is loaded back as soon as some of them connects to it.
+    // See reload() for how it is kept from being announced to the trackers as a leecher
+    // and from taking a queue slot.
+    lt::add_torrent_params p;
+#ifdef QBT_USES_LIBTORRENT2
+    p.info_hashes = m_infoHash;
+#else
+    p.info_hash = m_infoHash;
+#endif
+    p.name = summary.name.toStdString();
+    p.save_path = m_ltAddTorrentParams.save_path;
+    p.trackers = m_ltAddTorrentParams.trackers;
+    p.tracker_tiers = m_ltAddTorrentParams.tracker_tiers;
+    p.url_seeds = m_ltAddTorrentParams.url_seeds;
+    p.flags = m_ltAddTorrentParams.flags;
+    p.max_uploads = m_ltAddTorrentParams.max_uploads;
+    p.max_connections = m_ltAddTorrentParams.max_connections;
+    p.upload_limit = m_ltAddTorrentParams.upload_limit;
+    p.download_limit = m_ltAddTorrentParams.download_limit;
+    p.total_uploaded = m_ltAddTorrentParams.total_uploaded;
+    p.total_downloaded = m_ltAddTorrentParams.total_downloaded;
+    p.active_time = m_ltAddTorrentParams.active_time;
+    p.finished_time = m_ltAddTorrentParams.finished_time;
+    p.seeding_time = m_ltAddTorrentParams.seeding_time;
+    p.num_complete = m_ltAddTorrentParams.num_complete;
+    p.num_incomplete = m_ltAddTorrentParams.num_incomplete;
+    p.added_time = m_ltAddTorrentParams.added_time;
+    p.completed_time = m_ltAddTorrentParams.completed_time;
+    p.last_seen_complete = m_ltAddTorrentParams.last_seen_complete;
+    p.last_download = m_ltAddTorrentParams.last_download;
+    p.last_upload = m_ltAddTorrentParams.last_upload;
+
+    m_metadataSummary = summary;
+    m_ltAddTorrentParams = p;
+    // the parameters are complete for the torrent without metadata
+    m_isResumeDataCacheReleased = false;
+    reload();
+    updateStatus();
+}
+
+void TorrentImpl::loadMetadata()
+{
+    if (!m_metadataSummary)
+        return;
+
+    std::optional<LoadTorrentParams> resumeData = m_session->loadTorrentResumeData(id());
+    if (!resumeData || !resumeData->ltAddTorrentParams.ti)
+    {
+        // Let it be downloaded from peers and handled like the metadata of a magnet link
+        LogMsg(tr("Failed to load metadata of torrent '%1' from the resume data storage. It will be retrieved from peers.")
+            .arg(name()), Log::WARNING);
+        m_metadataSummary.reset();
+        reload();
+        updateStatus();
+        return;
+    }
+
+    lt::add_torrent_params &p = resumeData->ltAddTorrentParams;
+    applyUnloadedStatus(p);
+
+    m_metadataSummary.reset();
+    m_metadataLoadTime = QDateTime::currentDateTime();
+    m_ltAddTorrentParams = p;
+    reload();
+    updateStatus();
+}
+
 void TorrentImpl::setAutoManaged(const bool enable)
 {
     if (enable)
@@ -455,6 +739,20 @@ void TorrentImpl::setAutoManaged(const bool enable)
 
 QVector<TrackerEntry> TorrentImpl::trackers() const
 {
+    if (m_metadataSummary)
+    {
+        // They aren't given to libtorrent while the metadata is unloaded
+        const std::vector<std::string> &urls = m_ltAddTorrentParams.trackers;
+        const std::vector<int> &tiers = m_ltAddTorrentParams.tracker_tiers;
+
+        QVector<TrackerEntry> entries;
+        entries.reserve(static_cast<decltype(entries)::size_type>(urls.size()));
+        for (std::size_t i = 0; i < urls.size(); ++i)
+            entries.append({QString::fromStdString(urls[i]), ((i < tiers.size()) ? tiers[i] : 0)});
+
+        return entries;
+    }
+
     const std::vector<lt::announce_entry> nativeTrackers = m_nativeHandle.trackers();
 
     QVector<TrackerEntry> entries;
@@ -475,6 +773,9 @@ QVector<TrackerEntry> TorrentImpl::trackers() const
 
 void TorrentImpl::addTrackers(const QVector<TrackerEntry> &trackers)
 {
+    if (m_metadataSummary)
+        loadMetadata();
+
     QSet<TrackerEntry> currentTrackers;
     for (const lt::announce_entry &entry : m_nativeHandle.trackers())
         currentTrackers.insert({QString::fromStdString(entry.url), entry.tier});
@@ -500,6 +801,9 @@ void TorrentImpl::addTrackers(const QVector<TrackerEntry> &trackers)
 
 void TorrentImpl::replaceTrackers(const QVector<TrackerEntry> &trackers)
 {
+    if (m_metadataSummary)
+        loadMetadata();
+
     QVector<TrackerEntry> currentTrackers = this->trackers();
 
     QVector<TrackerEntry> newTrackers;
@@ -555,6 +859,9 @@ QVector<QUrl> TorrentImpl::urlSeeds() const
 
 void TorrentImpl::addUrlSeeds(const QVector<QUrl> &urlSeeds)
 {
+    if (m_metadataSummary)
+        loadMetadata();
+
     const std::set<std::string> currentSeeds = m_nativeHandle.url_seeds();
 
     QVector<QUrl> addedUrlSeeds;
@@ -579,6 +886,9 @@ void TorrentImpl::addUrlSeeds(const QVector<QUrl> &urlSeeds)
 
 void TorrentImpl::removeUrlSeeds(const QVector<QUrl> &urlSeeds)
 {
+    if (m_metadataSummary)
+        loadMetadata();
+
     const std::set<std::string> currentSeeds = m_nativeHandle.url_seeds();
 
     QVector<QUrl> removedUrlSeeds;
@@ -630,13 +940,48 @@ bool TorrentImpl::connectPeer(const PeerAddress &peerAddress)
 
 bool TorrentImpl::needSaveResumeData() const
 {
+    // The resume data of the torrent which metadata is unloaded
+    // is stored by saveResumeData() on each change
+    if (m_metadataSummary)
+        return false;
+
     return m_nativeHandle.need_save_resume_data();
 }
 
 void TorrentImpl::saveResumeData()
 {
+    if (m_metadataSummary)
+    {
+        // libtorrent can't provide the complete resume data of the torrent
+        // without metadata, so the stored one is updated instead
+        m_session->handleTorrentSaveResumeDataRequested(this);
+        std::optional<LoadTorrentParams> resumeData = m_session->loadTorrentResumeData(id());
+        if (!resumeData)
+        {
+            m_session->handleTorrentResumeDataFailed(this);
+            return;
+        }
+
+        lt::add_torrent_params &p = resumeData->ltAddTorrentParams;
+        applyUnloadedStatus(p);
+        m_session->handleTorrentResumeDataReady(this, makeResumeData(p));
+        return;
+    }
+
     m_nativeHandle.save_resume_data();
     m_session->handleTorrentSaveResumeDataRequested(this);
+    ++m_pendingResumeDataCount;
+}
+
+void TorrentImpl::applyUnloadedStatus(lt::add_torrent_params &params) const
+{
+    params.total_uploaded = m_nativeStatus.all_time_upload;
+    params.total_downloaded = m_nativeStatus.all_time_download;
+    params.active_time = lt::total_seconds(m_nativeStatus.active_duration);
+    params.finished_time = lt::total_seconds(m_nativeStatus.finished_duration);
+    params.seeding_time = lt::total_seconds(m_nativeStatus.seeding_duration);
+    params.num_complete = m_nativeStatus.num_complete;
+    params.num_incomplete = m_nativeStatus.num_incomplete;
 }
 
 int TorrentImpl::filesCount() const
@@ -646,6 +991,9 @@ int TorrentImpl::filesCount() const
 
 int TorrentImpl::piecesCount() const
 {
+    if (m_metadataSummary)
+        return m_metadataSummary->piecesCount;
+
     return m_torrentInfo.piecesCount();
 }
 
@@ -819,6 +1167,12 @@ bool TorrentImpl::isChecking() const
             || (m_nativeStatus.state == lt::torrent_status::checking_resume_data));
 }
 
+bool TorrentImpl::isCheckingFiles() const
+{
+    return ((m_nativeStatus.state == lt::torrent_status::checking_files)
+            && !(m_nativeStatus.flags & lt::torrent_flags::paused));
+}
+
 bool TorrentImpl::isDownloading() const
 {
     return m_state == TorrentState::Downloading
@@ -935,6 +1289,11 @@ void TorrentImpl::updateState()
         // If the torrent is not just in the "checking" state, but is being actually checked
         m_state = m_hasSeedStatus ? TorrentState::CheckingUploading : TorrentState::CheckingDownloading;
     }
+    else if (m_session->isRecheckQueued(this))
+    {
+        // Waiting for its turn, like the torrents that libtorrent queues for checking
+        m_state = m_hasSeedStatus ? TorrentState::CheckingUploading : TorrentState::CheckingDownloading;
+    }
     else if (isSeed())
     {
         if (isPaused())
@@ -961,11 +1320,28 @@ void TorrentImpl::updateState()
         else
             m_state = TorrentState::StalledDownloading;
     }
+
+    updateUnfinishedState();
+}
+
+void TorrentImpl::updateUnfinishedState()
+{
+    const bool isUnfinished = (!isSeed() && !isPaused() && !isErrored());
+    if (isUnfinished == m_isUnfinished)
+        return;
+
+    m_isUnfinished = isUnfinished;
+    m_session->handleTorrentUnfinishedStateChanged(this, isUnfinished);
 }
 
 bool TorrentImpl::hasMetadata() const
 {
-    return m_torrentInfo.isValid();
+    return (m_torrentInfo.isValid() || m_metadataSummary);
+}
+
+bool TorrentImpl::isMetadataUnloaded() const
+{
+    return m_metadataSummary.has_value();
 }
 
 bool TorrentImpl::hasMissingFiles() const
@@ -1203,6 +1579,17 @@ bool TorrentImpl::isLSDDisabled() const
     return static_cast<bool>(m_nativeStatus.flags & lt::torrent_flags::disable_lsd);
 }
 
+bool TorrentImpl::hasIncomingConnection() const
+{
+    std::vector<lt::peer_info> nativePeers;
+    m_nativeHandle.get_peer_info(nativePeers);
+
+    return std::any_of(nativePeers.cbegin(), nativePeers.cend(), [](const lt::peer_info &peer)
+    {
+        return !(peer.flags & lt::peer_info::local_connection);
+    });
+}
+
 QVector<PeerInfo> TorrentImpl::peers() const
 {
     std::vector<lt::peer_info> nativePeers;
@@ -1212,20 +1599,14 @@ QVector<PeerInfo> TorrentImpl::peers() const
     peers.reserve(static_cast<decltype(peers)::size_type>(nativePeers.size()));
 
     for (const lt::peer_info &peer : nativePeers)
-        peers << PeerInfo(this, peer);
+        peers << PeerInfo(peer, m_nativeStatus.pieces);
 
     return peers;
 }
 
 QBitArray TorrentImpl::pieces() const
 {
-    QBitArray result(m_nativeStatus.pieces.size());
-    for (int i = 0; i < result.size(); ++i)
-    {
-        if (m_nativeStatus.pieces[lt::piece_index_t {i}])
-            result.setBit(i, true);
-    }
-    return result;
+    return Utils::Bitfield::toQBitArray(m_nativeStatus.pieces);
 }
 
 QBitArray TorrentImpl::downloadingPieces() const
@@ -1404,6 +1785,20 @@ void TorrentImpl::forceRecheck()
 {
     if (!hasMetadata()) return;
 
+    if (m_metadataSummary)
+        loadMetadata();
+
+    m_session->enqueueRecheck(this);
+    updateState();
+}
+
+void TorrentImpl::startRecheck()
+{
+    if (!hasMetadata()) return;
+
+    if (m_metadataSummary)
+        loadMetadata();
+
     m_nativeHandle.force_recheck();
     m_hasMissingFiles = false;
     m_unchecked = false;
@@ -1437,6 +1832,9 @@ void TorrentImpl::setFirstLastPiecePriority(const bool enabled)
     if (m_hasFirstLastPiecePriority == enabled)
         return;
 
+    if (m_metadataSummary)
+        loadMetadata();
+
     m_hasFirstLastPiecePriority = enabled;
     if (hasMetadata())
         applyFirstLastPiecePriority(enabled);
@@ -1522,6 +1920,9 @@ void TorrentImpl::reload()
 
     m_nativeSession->remove_torrent(m_nativeHandle, lt::session::delete_partfile);
 
+    if (m_isResumeDataCacheReleased)
+        restoreResumeDataCache();
+
     lt::add_torrent_params p = m_ltAddTorrentParams;
     p.flags |= lt::torrent_flags::update_subscribe
             | lt::torrent_flags::override_trackers
@@ -1532,6 +1933,15 @@ void TorrentImpl::reload()
         p.flags |= lt::torrent_flags::paused;
         p.flags &= ~lt::torrent_flags::auto_managed;
     }
+    else if (m_metadataSummary)
+    {
+        // libtorrent handles the torrent without metadata like a magnet link. It isn't auto managed
+        // so it doesn't take a download slot, and the trackers are kept from it so it isn't
+        // announced as a leecher. The peers still find it through DHT, LSD and PEX.
+        p.flags &= ~(lt::torrent_flags::auto_managed | lt::torrent_flags::paused);
+        p.trackers.clear();
+        p.tracker_tiers.clear();
+    }
     else if (m_operatingMode == TorrentOperatingMode::AutoManaged)
     {
         p.flags |= (lt::torrent_flags::auto_managed | lt::torrent_flags::paused);
@@ -1552,6 +1962,7 @@ void TorrentImpl::pause()
     if (!m_isStopped)
     {
         m_isStopped = true;
+        updateUnfinishedState();
         m_session->handleTorrentNeedSaveResumeData(this);
         m_session->handleTorrentPaused(this);
     }
@@ -1575,6 +1986,9 @@ void TorrentImpl::resume(const TorrentOperatingMode mode)
 
     m_operatingMode = mode;
 
+    if (m_metadataSummary)
+        loadMetadata();
+
     if (m_hasMissingFiles)
     {
         m_hasMissingFiles = false;
@@ -1592,6 +2006,7 @@ void TorrentImpl::resume(const TorrentOperatingMode mode)
         m_nativeHandle.unset_flags(lt::torrent_flags::stop_when_ready);
 
         m_isStopped = false;
+        updateUnfinishedState();
         m_session->handleTorrentNeedSaveResumeData(this);
         m_session->handleTorrentResumed(this);
     }
@@ -1606,6 +2021,9 @@ void TorrentImpl::resume(const TorrentOperatingMode mode)
 
 void TorrentImpl::moveStorage(const QString &newPath, const MoveStorageMode mode)
 {
+    if (m_metadataSummary)
+        loadMetadata();
+
     if (m_session->addMoveTorrentStorageJob(this, newPath, mode))
     {
         m_storageIsMoving = true;
@@ -1615,6 +2033,9 @@ void TorrentImpl::moveStorage(const QString &newPath, const MoveStorageMode mode
 
 void TorrentImpl::renameFile(const int index, const QString &path)
 {
+    if (m_metadataSummary)
+        loadMetadata();
+
 #ifndef QBT_USES_LIBTORRENT2
     const QString oldPath = filePath(index);
     m_oldPath[index].push_back(oldPath);
@@ -1694,10 +2115,11 @@ void TorrentImpl::handleTorrentCheckedAlert(const lt::torrent_checked_alert *p)
     qDebug("\"%s\" have just finished checking.", qUtf8Printable(name()));
 
 
-    if (!hasMetadata())
+    if (!m_torrentInfo.isValid())
     {
         // The torrent is checked due to metadata received, but we should not process
         // this event until the torrent is reloaded using the received metadata.
+        // The torrent which metadata is unloaded has nothing to check as well.
         return;
     }
 
@@ -1739,7 +2161,7 @@ void TorrentImpl::handleTorrentFinishedAlert(const lt::torrent_finished_alert *p
 
     m_session->handleTorrentNeedSaveResumeData(this);
 
-    const bool recheckTorrentsOnCompletion = Preferences::instance()->recheckTorrentsOnCompletion();
+    const bool recheckTorrentsOnCompletion = Preferences::instance()->snapshot().recheckTorrentsOnCompletion;
     if (isMoveInProgress() || (m_renameCount > 0))
     {
         if (recheckTorrentsOnCompletion)
@@ -1778,10 +2200,30 @@ void TorrentImpl::handleSaveResumeDataAlert(const lt::save_resume_data_alert *p)
 
         m_session->findIncompleteFiles(metadata, m_savePath);
     }
+    else if (m_metadataSummary)
+    {
+        // Requested before the metadata was unloaded, the stored resume data is already up to date
+        m_session->handleTorrentResumeDataFailed(this);
+    }
     else
     {
         prepareResumeData(p->params);
     }
+
+    if (m_pendingResumeDataCount > 0)
+        --m_pendingResumeDataCount;
+}
+
+void TorrentImpl::handleResumeDataStored(const bool success)
+{
+    // The stored resume data is up to date only if no more of it was requested meanwhile
+    if (!m_isMetadataUnloadRequested || (m_pendingResumeDataCount > 0))
+        return;
+
+    m_isMetadataUnloadRequested = false;
+    // Something could happen to the torrent since the unloading was requested
+    if (success && canUnloadMetadata())
+        unloadMetadata_impl();
 }
 
 void TorrentImpl::prepareResumeData(const lt::add_torrent_params &params)
@@ -1803,12 +2245,18 @@ void TorrentImpl::prepareResumeData(const lt::add_torrent_params &params)
         // Update recent resume data
         m_ltAddTorrentParams = params;
     }
+    m_isResumeDataCacheReleased = false;
 
     m_ltAddTorrentParams.added_time = addedTime().toSecsSinceEpoch();
 
     // We shouldn't save upload_mode flag to allow torrent operate normally on next run
     m_ltAddTorrentParams.flags &= ~lt::torrent_flags::upload_mode;
 
+    m_session->handleTorrentResumeDataReady(this, makeResumeData(m_ltAddTorrentParams));
+}
+
+LoadTorrentParams TorrentImpl::makeResumeData(const lt::add_torrent_params &params) const
+{
     LoadTorrentParams resumeData;
     resumeData.name = m_name;
     resumeData.category = m_category;
@@ -1821,9 +2269,8 @@ void TorrentImpl::prepareResumeData(const lt::add_torrent_params &params)
     resumeData.hasSeedStatus = m_hasSeedStatus;
     resumeData.stopped = m_isStopped;
     resumeData.operatingMode = m_operatingMode;
-    resumeData.ltAddTorrentParams = m_ltAddTorrentParams;
-
-    m_session->handleTorrentResumeDataReady(this, resumeData);
+    resumeData.ltAddTorrentParams = params;
+    return resumeData;
 }
 
 void TorrentImpl::handleSaveResumeDataFailedAlert(const lt::save_resume_data_failed_alert *p)
@@ -1956,6 +2403,13 @@ void TorrentImpl::handleMetadataReceivedAlert(const lt::metadata_received_alert
     Q_UNUSED(p);
     qDebug("Metadata received for torrent %s.", qUtf8Printable(name()));
 
+    if (m_metadataSummary)
+    {
+        // The metadata is already known, it is just unloaded
+        loadMetadata();
+        return;
+    }
+
     m_maintenanceJob = MaintenanceJob::HandleMetadata;
     m_session->handleTorrentNeedSaveResumeData(this);
 }
@@ -2136,7 +2590,31 @@ void TorrentImpl::updateStatus()
 
 void TorrentImpl::updateStatus(const lt::torrent_status &nativeStatus)
 {
+    if (m_metadataSummary && (nativeStatus.num_peers > 0) && hasIncomingConnection())
+    {
+        // Some peer looks for this torrent, it updates the status itself
+        loadMetadata();
+        return;
+    }
+
     m_nativeStatus = nativeStatus;
+    if (m_metadataSummary)
+    {
+        // Present the torrent as the seed it was when its metadata was unloaded
+        m_nativeStatus.state = lt::torrent_status::seeding;
+        m_nativeStatus.is_seeding = true;
+        m_nativeStatus.is_finished = true;
+        m_nativeStatus.progress = 1;
+        m_nativeStatus.progress_ppm = 1000000;
+        m_nativeStatus.total_wanted = m_metadataSummary->wantedSize;
+        m_nativeStatus.total_wanted_done = m_metadataSummary->wantedSize;
+        m_nativeStatus.num_pieces = m_metadataSummary->piecesHave;
+        // libtorrent counts the torrent without metadata as downloading, however it keeps seeding
+        const qint64 unloadedTime = std::max<qint64>(0
+            , (lt::total_seconds(nativeStatus.active_duration) - m_metadataSummary->activeTime));
+        m_nativeStatus.finished_duration = lt::seconds {m_metadataSummary->finishedTime + unloadedTime};
+        m_nativeStatus.seeding_duration = lt::seconds {m_metadataSummary->seedingTime + unloadedTime};
+    }
     updateState();
 
     m_speedMonitor.addSample({nativeStatus.download_payload_rate
@@ -2188,6 +2666,9 @@ void TorrentImpl::setUploadLimit(const int limit)
     if (limit == uploadLimit())
         return;
 
+    if (m_metadataSummary)
+        loadMetadata();
+
     m_nativeHandle.set_upload_limit(limit);
     m_session->handleTorrentNeedSaveResumeData(this);
 }
@@ -2197,6 +2678,9 @@ void TorrentImpl::setDownloadLimit(const int limit)
     if (limit == downloadLimit())
         return;
 
+    if (m_metadataSummary)
+        loadMetadata();
+
     m_nativeHandle.set_download_limit(limit);
     m_session->handleTorrentNeedSaveResumeData(this);
 }
@@ -2206,6 +2690,9 @@ void TorrentImpl::setSuperSeeding(const bool enable)
     if (enable == superSeeding())
         return;
 
+    if (m_metadataSummary)
+        loadMetadata();
+
     if (enable)
         m_nativeHandle.set_flags(lt::torrent_flags::super_seeding);
     else
@@ -2219,6 +2706,9 @@ void TorrentImpl::setDHTDisabled(const bool disable)
     if (disable == isDHTDisabled())
         return;
 
+    if (m_metadataSummary)
+        loadMetadata();
+
     if (disable)
         m_nativeHandle.set_flags(lt::torrent_flags::disable_dht);
     else
@@ -2232,6 +2722,9 @@ void TorrentImpl::setPEXDisabled(const bool disable)
     if (disable == isPEXDisabled())
         return;
 
+    if (m_metadataSummary)
+        loadMetadata();
+
     if (disable)
         m_nativeHandle.set_flags(lt::torrent_flags::disable_pex);
     else
@@ -2245,6 +2738,9 @@ void TorrentImpl::setLSDDisabled(const bool disable)
     if (disable == isLSDDisabled())
         return;
 
+    if (m_metadataSummary)
+        loadMetadata();
+
     if (disable)
         m_nativeHandle.set_flags(lt::torrent_flags::disable_lsd);
     else
@@ -2267,6 +2763,9 @@ void TorrentImpl::prioritizeFiles(const QVector<DownloadPriority> &priorities)
 {
     if (!hasMetadata()) return;
 
+    if (m_metadataSummary)
+        loadMetadata();
+
     Q_ASSERT(priorities.size() == filesCount());
 
     // Reset 'm_hasSeedStatus' if needed in order to react again to
@@ -2307,6 +2806,13 @@ QVector<qreal> TorrentImpl::availableFileFractions() const
     // libtorrent returns empty array for seeding only torrents
     if (piecesAvailability.empty()) return QVector<qreal>(filesCount, -1);
 
+    // prefix sums of available pieces, so each file is evaluated in O(1)
+    // instead of walking its whole piece range
+    QVector<int> availableBefore(piecesAvailability.size() + 1);
+    availableBefore[0] = 0;
+    for (int i = 0; i < piecesAvailability.size(); ++i)
+        availableBefore[i + 1] = availableBefore[i] + ((piecesAvailability[i] > 0) ? 1 : 0);
+
     QVector<qreal> res;
     res.reserve(filesCount);
     const TorrentInfo info = this->info();
@@ -2314,9 +2820,9 @@ QVector<qreal> TorrentImpl::availableFileFractions() const
     {
         const TorrentInfo::PieceRange filePieces = info.filePieces(i);
 
-        int availablePieces = 0;
-        for (const int piece : filePieces)
-            availablePieces += (piecesAvailability[piece] > 0) ? 1 : 0;
+        const int availablePieces = filePieces.isEmpty()
+            ? 0
+            : (availableBefore[filePieces.last() + 1] - availableBefore[filePieces.first()]);
 
         const qreal availability = filePieces.isEmpty()
             ? 1  // the file has no pieces, so it is available by default
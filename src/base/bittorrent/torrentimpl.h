@@ -30,6 +30,7 @@
 #pragma once
 
 #include <functional>
+#include <optional>
 
 #include <libtorrent/add_torrent_params.hpp>
 #include <libtorrent/fwd.hpp>
@@ -147,6 +148,7 @@ namespace BitTorrent
         bool hasFirstLastPiecePriority() const override;
         TorrentState state() const override;
         bool hasMetadata() const override;
+        bool isMetadataUnloaded() const override;
         bool hasMissingFiles() const override;
         bool hasError() const override;
         int queuePosition() const override;
@@ -222,6 +224,7 @@ namespace BitTorrent
         void removeUrlSeeds(const QVector<QUrl> &urlSeeds) override;
         bool connectPeer(const PeerAddress &peerAddress) override;
         void clearPeers() override;
+        void loadMetadata() override;
 
         QString createMagnetURI() const override;
 
@@ -236,17 +239,59 @@ namespace BitTorrent
         void handleCategorySavePathChanged();
         void handleAppendExtensionToggled();
         void saveResumeData();
+        // Called once all the requested stores of the resume data are completed
+        void handleResumeDataStored(bool success);
         void handleMoveStorageJobFinished(bool hasOutstandingJob);
         void fileSearchFinished(const QString &savePath, const QStringList &fileNames);
 
         QString actualStorageLocation() const;
+        // Whether libtorrent is reading the files to check them,
+        // as opposed to having the check queued
+        bool isCheckingFiles() const;
+
+        // Approximate sizes of the data kept in memory, in bytes
+        qint64 resumeDataCacheSize() const;
+        qint64 statusCacheSize() const;
+        qint64 metadataSize() const;
+        // Releases the bulky parts of the cached resume data of an idle seed.
+        // They are restored the next time the resume data is generated.
+        // Returns the number of bytes released.
+        qint64 releaseResumeDataCache();
+        // Requests the metadata of a seed which was inactive for the given number of seconds
+        // to be unloaded once its resume data is written to the storage. Returns false if it isn't eligible.
+        // The metadata is loaded back when some peer connects to the seed or some operation needs it.
+        bool unloadMetadata(int inactiveTime);
 
     private:
         using EventTrigger = std::function<void ()>;
 
+        // What is kept of the metadata while it is unloaded
+        struct MetadataSummary
+        {
+            QString name;
+            QDateTime creationDate;
+            QString creator;
+            QString comment;
+            bool isPrivate = false;
+            qlonglong totalSize = 0;
+            qlonglong wantedSize = 0;
+            qlonglong pieceLength = 0;
+            int piecesCount = 0;
+            int piecesHave = 0;
+            QString rootPath;
+            QString contentPath;
+            // Durations at the time of unloading, to keep counting the seeding time
+            qint64 activeTime = 0;
+            qint64 finishedTime = 0;
+            qint64 seedingTime = 0;
+        };
+
         void updateStatus();
         void updateStatus(const lt::torrent_status &nativeStatus);
         void updateState();
+        void updateUnfinishedState();
+        // Called by the session when the recheck requested by forceRecheck() may run
+        void startRecheck();
 
         void handleFastResumeRejectedAlert(const lt::fastresume_rejected_alert *p);
         void handleFileCompletedAlert(const lt::file_completed_alert *p);
@@ -280,8 +325,17 @@ namespace BitTorrent
         void applyFirstLastPiecePriority(bool enabled, const QVector<DownloadPriority> &updatedFilePrio = {});
 
         void prepareResumeData(const lt::add_torrent_params &params);
+        LoadTorrentParams makeResumeData(const lt::add_torrent_params &params) const;
+        // Updates the stored resume data with the counters which change while the metadata is unloaded
+        void applyUnloadedStatus(lt::add_torrent_params &params) const;
         void endReceivedMetadataHandling(const QString &savePath, const QStringList &fileNames);
+        void restoreResumeDataCache();
         void reload();
+        bool canUnloadMetadata() const;
+        void unloadMetadata_impl();
+        bool hasIncomingConnection() const;
+        QString relativeRootPath() const;
+        QString relativeContentPath() const;
 
         Session *const m_session;
         lt::session *m_nativeSession;
@@ -327,6 +381,13 @@ namespace BitTorrent
         bool m_isStopped;
 
         bool m_unchecked = false;
+        // Whether the session counts this torrent as unfinished
+        bool m_isUnfinished = false;
+        bool m_isResumeDataCacheReleased = false;
+        bool m_isMetadataUnloadRequested = false;
+        int m_pendingResumeDataCount = 0;
+        std::optional<MetadataSummary> m_metadataSummary;
+        QDateTime m_metadataLoadTime;
 
         lt::add_torrent_params m_ltAddTorrentParams;
     };
@@ -0,0 +1,432 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "transferhistory.h"
+
+#include <algorithm>
+
+#include <QDateTime>
+#include <QFile>
+#include <QVector>
+#include <QtEndian>
+
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/profile.h"
+#include "base/utils/fs.h"
+#include "base/utils/io.h"
+#include "session.h"
+#include "sessionstatus.h"
+#include "torrent.h"
+
+using namespace std::chrono_literals;
+using std::chrono::milliseconds;
+
+namespace
+{
+    const QString HISTORY_FILE_NAME = QStringLiteral("transfer_history.dat");
+    const char FILE_MAGIC[] = {'Q', 'B', 'T', 'H'};
+    const quint32 FILE_VERSION = 1;
+    const milliseconds SAVE_INTERVAL = 5min;
+
+    const int TOP_TORRENTS_COUNT = 10;
+    // Torrents that dropped out of the top are kept until they become too many
+    const int MAX_TRACKED_TORRENTS = 2 * TOP_TORRENTS_COUNT;
+
+    struct SpanInfo
+    {
+        milliseconds duration;
+        milliseconds resolution;
+    };
+
+    const std::array<SpanInfo, BitTorrent::TransferHistory::SpanCount> SPANS =
+    {{
+        {5min, 1s},
+        {30min, 6s},
+        {6h, 36s},
+        {12h, 72s},
+        {24h, 144s}
+    }};
+
+    int spanCapacity(const int span)
+    {
+        return static_cast<int>(SPANS[span].duration / SPANS[span].resolution);
+    }
+
+    // The history file consists of fixed size little endian records, so it can be mapped into memory:
+    //   header: magic (4 bytes), version, rate count, span count (quint32 each)
+    //   for each span: capacity, sample count (quint32 each), followed by
+    //     `capacity` records of timestamp, duration (qint64 each) and the rates (quint64 each),
+    //     oldest first, only the first `sample count` records are valid
+    template <typename T>
+    void appendLE(QByteArray &data, const T value)
+    {
+        char buffer[sizeof(T)];
+        qToLittleEndian(value, buffer);
+        data.append(buffer, sizeof(T));
+    }
+
+    template <typename T>
+    bool readLE(const QByteArray &data, int &pos, T &value)
+    {
+        if ((pos + static_cast<int>(sizeof(T))) > data.size())
+            return false;
+
+        value = qFromLittleEndian<T>(data.constData() + pos);
+        pos += sizeof(T);
+        return true;
+    }
+}
+
+using namespace BitTorrent;
+
+TransferHistory::TransferHistory(Session *session)
+    : QObject(session)
+    , m_session {session}
+{
+    for (int span = 0; span < SpanCount; ++span)
+    {
+        m_averagers[span].samples.set_capacity(spanCapacity(span));
+        m_averagers[span].lastSampleTime.start();
+    }
+
+    load();
+
+    connect(m_session, &Session::statsUpdated, this, &TransferHistory::handleStatsUpdated);
+    connect(m_session, &Session::torrentAboutToBeRemoved, this, &TransferHistory::handleTorrentAboutToBeRemoved);
+
+    connect(&m_saveTimer, &QTimer::timeout, this, &TransferHistory::save);
+    m_saveTimer.start(SAVE_INTERVAL);
+}
+
+TransferHistory::~TransferHistory()
+{
+    save();
+}
+
+milliseconds TransferHistory::spanDuration(const Span span)
+{
+    return SPANS[span].duration;
+}
+
+milliseconds TransferHistory::spanResolution(const Span span)
+{
+    return SPANS[span].resolution;
+}
+
+const TransferHistory::SampleBuffer &TransferHistory::samples(const Span span) const
+{
+    return m_averagers[span].samples;
+}
+
+const QHash<TorrentID, TransferHistory::TorrentSampleBuffer> &TransferHistory::torrentSamples() const
+{
+    return m_torrentSamples;
+}
+
+void TransferHistory::handleStatsUpdated()
+{
+    const SessionStatus &status = m_session->status();
+
+    std::array<quint64, RateCount> rates;
+    rates[Upload] = status.uploadRate;
+    rates[Download] = status.downloadRate;
+    rates[PayloadUpload] = status.payloadUploadRate;
+    rates[PayloadDownload] = status.payloadDownloadRate;
+    rates[OverheadUpload] = status.ipOverheadUploadRate;
+    rates[OverheadDownload] = status.ipOverheadDownloadRate;
+    rates[DHTUpload] = status.dhtUploadRate;
+    rates[DHTDownload] = status.dhtDownloadRate;
+    rates[TrackerUpload] = status.trackerUploadRate;
+    rates[TrackerDownload] = status.trackerDownloadRate;
+
+    for (int span = 0; span < SpanCount; ++span)
+    {
+        if (!pushSample(static_cast<Span>(span), rates))
+            continue;
+
+        // Idle time is restored with zero rates like the downtime, so it doesn't need saving
+        const Sample &sample = m_averagers[span].samples.back();
+        if (std::any_of(sample.rates.cbegin(), sample.rates.cend(), [](const quint64 rate) { return rate > 0; }))
+            m_dirty = true;
+
+        if (span == Span30Min)
+            sampleTorrents();
+        emit samplesAdded(static_cast<Span>(span));
+    }
+}
+
+bool TransferHistory::pushSample(const Span span, const std::array<quint64, RateCount> &rates)
+{
+    // Accumulator overflow will be hit in worst case on longest used averaging span,
+    // defined by resolution. Maximum resolution is 144 seconds
+    // With quint64 the speed limit is 2^64/144 ~~ 114 PBytes/s.
+    Averager &averager = m_averagers[span];
+    const milliseconds resolution = SPANS[span].resolution;
+    const milliseconds maxDuration = SPANS[span].duration;
+
+    ++averager.counter;
+    for (int id = 0; id < RateCount; ++id)
+        averager.accumulator[id] += rates[id];
+
+    // system may go to sleep, that can cause very big elapsed interval
+    const milliseconds updateInterval {static_cast<int64_t>(m_session->refreshInterval() * 1.25)};
+    const milliseconds maxElapsed {std::max(updateInterval, resolution)};
+    const milliseconds elapsed {std::min(milliseconds {averager.lastSampleTime.elapsed()}, maxElapsed)};
+    if (elapsed < resolution)
+        return false; // still accumulating
+
+    // it is time final averaging calculations
+    for (int id = 0; id < RateCount; ++id)
+        averager.accumulator[id] /= averager.counter;
+
+    averager.currentDuration += elapsed;
+
+    // remove extra data from front if we reached max duration
+    if (averager.currentDuration > maxDuration)
+    {
+        // once we go above the max duration never go below that
+        // otherwise it will cause empty space in graphs
+        while (!averager.samples.empty()
+               && ((averager.currentDuration - milliseconds {averager.samples.front().duration}) >= maxDuration))
+        {
+            averager.currentDuration -= milliseconds {averager.samples.front().duration};
+            averager.samples.pop_front();
+        }
+    }
+
+    // now flush out averaged data
+    if (averager.samples.full())
+    {
+        averager.currentDuration -= milliseconds {averager.samples.front().duration};
+        averager.samples.pop_front();
+    }
+    averager.samples.push_back({QDateTime::currentMSecsSinceEpoch(), elapsed.count(), averager.accumulator});
+
+    // reset
+    averager.accumulator = {};
+    averager.counter = 0;
+    averager.lastSampleTime.restart();
+    return true;
+}
+
+void TransferHistory::sampleTorrents()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QVector<Torrent *> activeTorrents;
+    for (Torrent *torrent : asConst(m_session->torrents()))
+    {
+        if ((torrent->uploadPayloadRate() > 0) || (torrent->downloadPayloadRate() > 0))
+            activeTorrents.append(torrent);
+    }
+
+    const auto topEnd = activeTorrents.begin() + std::min<int>(activeTorrents.size(), TOP_TORRENTS_COUNT);
+    std::partial_sort(activeTorrents.begin(), topEnd, activeTorrents.end()
+        , [](const Torrent *left, const Torrent *right)
+    {
+        return ((static_cast<qint64>(left->uploadPayloadRate()) + left->downloadPayloadRate())
+            > (static_cast<qint64>(right->uploadPayloadRate()) + right->downloadPayloadRate()));
+    });
+
+    for (auto it = activeTorrents.begin(); it != topEnd; ++it)
+    {
+        const Torrent *torrent = *it;
+        auto sampleIter = m_torrentSamples.find(torrent->id());
+        if (sampleIter == m_torrentSamples.end())
+            sampleIter = m_torrentSamples.insert(torrent->id(), TorrentSampleBuffer(spanCapacity(Span30Min)));
+
+        sampleIter->push_back({now, static_cast<quint64>(torrent->uploadPayloadRate())
+            , static_cast<quint64>(torrent->downloadPayloadRate())});
+    }
+
+    // Forget the torrents that haven't been among the most active ones for the whole span
+    const qint64 expireTime = now - SPANS[Span30Min].duration.count();
+    for (auto it = m_torrentSamples.begin(); it != m_torrentSamples.end(); )
+    {
+        if (it->empty() || (it->back().timestamp < expireTime))
+            it = m_torrentSamples.erase(it);
+        else
+            ++it;
+    }
+
+    while (m_torrentSamples.size() > MAX_TRACKED_TORRENTS)
+    {
+        const auto oldestIter = std::min_element(m_torrentSamples.begin(), m_torrentSamples.end()
+            , [](const TorrentSampleBuffer &left, const TorrentSampleBuffer &right)
+        {
+            return (left.back().timestamp < right.back().timestamp);
+        });
+        m_torrentSamples.erase(oldestIter);
+    }
+}
+
+void TransferHistory::handleTorrentAboutToBeRemoved(Torrent *torrent)
+{
+    m_torrentSamples.remove(torrent->id());
+}
+
+QString TransferHistory::filePath() const
+{
+    return Utils::Fs::expandPathAbs(specialFolderLocation(SpecialFolder::Data) + HISTORY_FILE_NAME);
+}
+
+void TransferHistory::load()
+{
+    QFile file {filePath()};
+    if (!file.exists())
+        return;
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LogMsg(tr("Couldn't load transfer history. File: \"%1\". Error: \"%2\"").arg(file.fileName(), file.errorString())
+            , Log::WARNING);
+        return;
+    }
+
+    const QByteArray data = file.readAll();
+    int pos = 0;
+
+    quint32 version = 0;
+    quint32 rateCount = 0;
+    quint32 spanCount = 0;
+    if (!data.startsWith(QByteArray::fromRawData(FILE_MAGIC, sizeof(FILE_MAGIC))))
+        return;
+    pos += sizeof(FILE_MAGIC);
+    if (!readLE(data, pos, version) || !readLE(data, pos, rateCount) || !readLE(data, pos, spanCount)
+        || (version != FILE_VERSION) || (rateCount != RateCount) || (spanCount != SpanCount))
+    {
+        LogMsg(tr("Transfer history file has unsupported format and will be replaced. File: \"%1\"").arg(file.fileName())
+            , Log::WARNING);
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    std::array<SampleBuffer, SpanCount> loadedSamples;
+    for (int span = 0; span < SpanCount; ++span)
+    {
+        quint32 capacity = 0;
+        quint32 count = 0;
+        if (!readLE(data, pos, capacity) || !readLE(data, pos, count)
+            || (capacity != static_cast<quint32>(spanCapacity(span))) || (count > capacity))
+        {
+            return;
+        }
+
+        SampleBuffer &samples = loadedSamples[span];
+        samples.set_capacity(capacity);
+        for (quint32 i = 0; i < capacity; ++i)
+        {
+            Sample sample;
+            if (!readLE(data, pos, sample.timestamp) || !readLE(data, pos, sample.duration))
+                return;
+            for (quint64 &rate : sample.rates)
+            {
+                if (!readLE(data, pos, rate))
+                    return;
+            }
+
+            if ((i < count) && (sample.duration > 0) && (sample.timestamp <= now))
+                samples.push_back(sample);
+        }
+    }
+
+    for (int span = 0; span < SpanCount; ++span)
+    {
+        Averager &averager = m_averagers[span];
+        const SampleBuffer &samples = loadedSamples[span];
+        if (samples.empty())
+            continue;
+
+        // Keep only the samples that are still within the span, counting the time we weren't running
+        const milliseconds maxDuration = SPANS[span].duration;
+        const milliseconds downtime {now - samples.back().timestamp};
+        if (downtime >= maxDuration)
+            continue;
+
+        milliseconds duration = downtime;
+        auto first = samples.end();
+        while ((first != samples.begin()) && ((duration + milliseconds {(first - 1)->duration}) <= maxDuration))
+        {
+            --first;
+            duration += milliseconds {first->duration};
+        }
+
+        averager.samples.insert(averager.samples.end(), first, samples.end());
+        // Zero rates for the downtime, so it is shown as a gap
+        if (downtime >= SPANS[span].resolution)
+        {
+            if (averager.samples.full())
+                averager.samples.pop_front();
+            averager.samples.push_back({now, downtime.count(), {}});
+        }
+
+        averager.currentDuration = 0ms;
+        for (const Sample &sample : averager.samples)
+            averager.currentDuration += milliseconds {sample.duration};
+    }
+}
+
+void TransferHistory::save()
+{
+    if (!m_dirty)
+        return;
+
+    QByteArray data;
+    data.append(FILE_MAGIC, sizeof(FILE_MAGIC));
+    appendLE<quint32>(data, FILE_VERSION);
+    appendLE<quint32>(data, RateCount);
+    appendLE<quint32>(data, SpanCount);
+
+    for (int span = 0; span < SpanCount; ++span)
+    {
+        const SampleBuffer &samples = m_averagers[span].samples;
+        const int capacity = spanCapacity(span);
+        appendLE<quint32>(data, capacity);
+        appendLE<quint32>(data, static_cast<quint32>(samples.size()));
+
+        for (int i = 0; i < capacity; ++i)
+        {
+            const Sample sample = (i < static_cast<int>(samples.size())) ? samples[i] : Sample();
+            appendLE<qint64>(data, sample.timestamp);
+            appendLE<qint64>(data, sample.duration);
+            for (const quint64 rate : sample.rates)
+                appendLE<quint64>(data, rate);
+        }
+    }
+
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(filePath(), data);
+    if (!result)
+    {
+        LogMsg(tr("Couldn't save transfer history. File: \"%1\". Error: \"%2\"").arg(filePath(), result.error())
+            , Log::WARNING);
+        return;
+    }
+
+    m_dirty = false;
+}
@@ -0,0 +1,143 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#ifndef Q_MOC_RUN
+#include <boost/circular_buffer.hpp>
+#endif
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    class Session;
+    class Torrent;
+
+    // Averaged transfer rates of the session, kept with several resolutions
+    // and persisted across restarts, plus recent rates of the most active torrents
+    class TransferHistory final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(TransferHistory)
+
+    public:
+        enum Rate
+        {
+            Upload = 0,
+            Download,
+            PayloadUpload,
+            PayloadDownload,
+            OverheadUpload,
+            OverheadDownload,
+            DHTUpload,
+            DHTDownload,
+            TrackerUpload,
+            TrackerDownload,
+
+            RateCount
+        };
+
+        enum Span
+        {
+            Span5Min = 0,
+            Span30Min,
+            Span6Hour,
+            Span12Hour,
+            Span24Hour,
+
+            SpanCount
+        };
+
+        struct Sample
+        {
+            // Milliseconds since epoch at the end of the averaging interval
+            qint64 timestamp = 0;
+            // Length of the averaging interval in milliseconds
+            qint64 duration = 0;
+            // Bytes per second
+            std::array<quint64, RateCount> rates {};
+        };
+
+        struct TorrentSample
+        {
+            qint64 timestamp = 0;
+            quint64 upload = 0;
+            quint64 download = 0;
+        };
+
+        using SampleBuffer = boost::circular_buffer<Sample>;
+        using TorrentSampleBuffer = boost::circular_buffer<TorrentSample>;
+
+        explicit TransferHistory(Session *session);
+        ~TransferHistory() override;
+
+        static std::chrono::milliseconds spanDuration(Span span);
+        static std::chrono::milliseconds spanResolution(Span span);
+
+        const SampleBuffer &samples(Span span) const;
+        // Payload rates of the most active torrents, with the resolution of Span30Min
+        const QHash<TorrentID, TorrentSampleBuffer> &torrentSamples() const;
+
+    signals:
+        void samplesAdded(BitTorrent::TransferHistory::Span span);
+
+    private:
+        struct Averager
+        {
+            std::chrono::milliseconds currentDuration {0};
+            int counter = 0;
+            std::array<quint64, RateCount> accumulator {};
+            SampleBuffer samples;
+            QElapsedTimer lastSampleTime;
+        };
+
+        void handleStatsUpdated();
+        bool pushSample(Span span, const std::array<quint64, RateCount> &rates);
+        void sampleTorrents();
+        void handleTorrentAboutToBeRemoved(Torrent *torrent);
+
+        void load();
+        void save();
+        QString filePath() const;
+
+        Session *m_session = nullptr;
+        std::array<Averager, SpanCount> m_averagers;
+        QHash<TorrentID, TorrentSampleBuffer> m_torrentSamples;
+        QTimer m_saveTimer;
+        bool m_dirty = false;
+    };
+}
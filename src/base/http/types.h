@@ -68,6 +68,8 @@ namespace Http
     inline const char CONTENT_TYPE_JSON[] = "application/json";
     inline const char CONTENT_TYPE_GIF[] = "image/gif";
     inline const char CONTENT_TYPE_PNG[] = "image/png";
+    inline const char CONTENT_TYPE_BITTORRENT[] = "application/x-bittorrent";
+    inline const char CONTENT_TYPE_OPENMETRICS[] = "application/openmetrics-text; version=1.0.0; charset=utf-8";
     inline const char CONTENT_TYPE_FORM_ENCODED[] = "application/x-www-form-urlencoded";
     inline const char CONTENT_TYPE_FORM_DATA[] = "multipart/form-data";
 
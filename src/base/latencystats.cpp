@@ -0,0 +1,191 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "latencystats.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "base/global.h"
+
+namespace
+{
+    struct Registry
+    {
+        QMutex mutex;
+        QHash<QString, std::shared_ptr<LatencyStats::Histogram>> histograms;
+    };
+
+    Registry &registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    int mostSignificantBit(quint64 value)
+    {
+        int bit = 0;
+        while (value >>= 1)
+            ++bit;
+        return bit;
+    }
+}
+
+using namespace LatencyStats;
+
+Histogram::Histogram(const QString &name)
+    : m_name {name}
+{
+}
+
+QString Histogram::name() const
+{
+    return m_name;
+}
+
+int Histogram::bucketIndex(const quint64 value)
+{
+    if (value < SUB_BUCKET_COUNT)
+        return static_cast<int>(value);
+
+    // Values in [2^m, 2^(m+1)) are split into SUB_BUCKET_COUNT buckets
+    const int shift = mostSignificantBit(value) - SUB_BUCKET_BITS;
+    const int index = (shift * SUB_BUCKET_COUNT) + static_cast<int>(value >> shift);
+    return std::min(index, (BUCKET_COUNT - 1));
+}
+
+quint64 Histogram::bucketUpperBound(const int index)
+{
+    if (index < (2 * SUB_BUCKET_COUNT))
+        return static_cast<quint64>(index);
+
+    const int shift = (index / SUB_BUCKET_COUNT) - 1;
+    const quint64 subBucket = static_cast<quint64>(index - (shift * SUB_BUCKET_COUNT));
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void Histogram::record(const quint64 microseconds)
+{
+    m_buckets[bucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(microseconds, std::memory_order_relaxed);
+
+    quint64 max = m_max.load(std::memory_order_relaxed);
+    while ((microseconds > max) && !m_max.compare_exchange_weak(max, microseconds, std::memory_order_relaxed))
+        ;
+}
+
+HistogramSnapshot Histogram::snapshot() const
+{
+    HistogramSnapshot snapshot;
+    snapshot.name = m_name;
+    snapshot.max = m_max.load(std::memory_order_relaxed);
+
+    std::array<quint64, BUCKET_COUNT> buckets;
+    quint64 count = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        count += buckets[i];
+    }
+    if (count == 0)
+        return snapshot;
+
+    snapshot.count = count;
+    snapshot.mean = m_sum.load(std::memory_order_relaxed) / std::max<quint64>(1, m_count.load(std::memory_order_relaxed));
+
+    const auto percentile = [&buckets, count, &snapshot](const int permille) -> quint64
+    {
+        const quint64 rank = std::max<quint64>(1, ((count * permille) + 999) / 1000);
+        quint64 accumulated = 0;
+        for (int i = 0; i < BUCKET_COUNT; ++i)
+        {
+            accumulated += buckets[i];
+            if (accumulated >= rank)
+                return std::min(bucketUpperBound(i), snapshot.max);
+        }
+        return snapshot.max;
+    };
+    snapshot.p50 = percentile(500);
+    snapshot.p90 = percentile(900);
+    snapshot.p99 = percentile(990);
+
+    return snapshot;
+}
+
+void Histogram::reset()
+{
+    for (std::atomic<quint64> &bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+Histogram *LatencyStats::histogram(const QString &name)
+{
+    Registry &reg = registry();
+    const QMutexLocker locker {&reg.mutex};
+
+    std::shared_ptr<Histogram> &histogram = reg.histograms[name];
+    if (!histogram)
+        histogram = std::make_shared<Histogram>(name);
+    return histogram.get();
+}
+
+QVector<HistogramSnapshot> LatencyStats::snapshots()
+{
+    Registry &reg = registry();
+    const QMutexLocker locker {&reg.mutex};
+
+    QVector<HistogramSnapshot> result;
+    result.reserve(reg.histograms.size());
+    for (const std::shared_ptr<Histogram> &histogram : asConst(reg.histograms))
+    {
+        HistogramSnapshot snapshot = histogram->snapshot();
+        if (snapshot.count > 0)
+            result.append(snapshot);
+    }
+
+    std::sort(result.begin(), result.end()
+        , [](const HistogramSnapshot &left, const HistogramSnapshot &right) { return left.name < right.name; });
+    return result;
+}
+
+void LatencyStats::reset()
+{
+    Registry &reg = registry();
+    const QMutexLocker locker {&reg.mutex};
+
+    for (const std::shared_ptr<Histogram> &histogram : asConst(reg.histograms))
+        histogram->reset();
+}
@@ -0,0 +1,137 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+// Latency histograms of the hot code paths.
+// The measurements are only compiled in when QBT_LATENCY_STATS is defined
+// (LATENCY_STATS CMake option, CONFIG+=latencystats for qmake).
+namespace LatencyStats
+{
+    struct HistogramSnapshot
+    {
+        QString name;
+        quint64 count = 0;
+        // Microseconds
+        quint64 mean = 0;
+        quint64 p50 = 0;
+        quint64 p90 = 0;
+        quint64 p99 = 0;
+        quint64 max = 0;
+    };
+
+    // Log-linear histogram of durations in microseconds, with about 12% precision.
+    // Recording is lock-free, so it can be done from any thread.
+    class Histogram
+    {
+        Q_DISABLE_COPY_MOVE(Histogram)
+
+    public:
+        explicit Histogram(const QString &name);
+
+        QString name() const;
+
+        void record(quint64 microseconds);
+        HistogramSnapshot snapshot() const;
+        void reset();
+
+    private:
+        // 8 sub-buckets for each power of 2, up to 2^40 us (~12 days)
+        static const int SUB_BUCKET_BITS = 3;
+        static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+        static const int BUCKET_COUNT = (40 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+        static int bucketIndex(quint64 value);
+        static quint64 bucketUpperBound(int index);
+
+        const QString m_name;
+        std::array<std::atomic<quint64>, BUCKET_COUNT> m_buckets {};
+        std::atomic<quint64> m_count {0};
+        std::atomic<quint64> m_sum {0};
+        std::atomic<quint64> m_max {0};
+    };
+
+    // Returns the histogram with the given name, creating it if needed.
+    // The returned histogram lives until the program exits.
+    Histogram *histogram(const QString &name);
+    QVector<HistogramSnapshot> snapshots();
+    void reset();
+
+    constexpr bool isEnabled()
+    {
+#ifdef QBT_LATENCY_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    class ScopedTimer
+    {
+        Q_DISABLE_COPY_MOVE(ScopedTimer)
+
+    public:
+        explicit ScopedTimer(Histogram *histogram)
+            : m_histogram {histogram}
+        {
+            m_timer.start();
+        }
+
+        ~ScopedTimer()
+        {
+            m_histogram->record(static_cast<quint64>(m_timer.nsecsElapsed() / 1000));
+        }
+
+    private:
+        Histogram *m_histogram = nullptr;
+        QElapsedTimer m_timer;
+    };
+}
+
+#ifdef QBT_LATENCY_STATS
+#define QBT_LATENCY_CONCAT_IMPL(a, b) a##b
+#define QBT_LATENCY_CONCAT(a, b) QBT_LATENCY_CONCAT_IMPL(a, b)
+
+// Records the time until the end of the enclosing scope
+#define QBT_MEASURE_LATENCY(name) \
+    static LatencyStats::Histogram *const QBT_LATENCY_CONCAT(latencyHistogram_, __LINE__) = LatencyStats::histogram(QStringLiteral(name)); \
+    const LatencyStats::ScopedTimer QBT_LATENCY_CONCAT(latencyTimer_, __LINE__) {QBT_LATENCY_CONCAT(latencyHistogram_, __LINE__)}
+// Same as above, for the histograms that are looked up at runtime
+#define QBT_MEASURE_LATENCY_OF(histogram) \
+    const LatencyStats::ScopedTimer QBT_LATENCY_CONCAT(latencyTimer_, __LINE__) {histogram}
+#else
+#define QBT_MEASURE_LATENCY(name)
+#define QBT_MEASURE_LATENCY_OF(histogram)
+#endif
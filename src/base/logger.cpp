@@ -33,6 +33,8 @@
 #include <QDateTime>
 #include <QVector>
 
+#include "memorystats.h"
+
 namespace
 {
     template <typename T>
@@ -51,6 +53,12 @@ Logger::Logger()
     : m_messages(MAX_LOG_MESSAGES)
     , m_peers(MAX_LOG_MESSAGES)
 {
+    MemoryStats::registerProvider(QLatin1String("log"), tr("Execution log"), [this]() { return memoryUsage(); });
+}
+
+Logger::~Logger()
+{
+    MemoryStats::unregisterProvider(QLatin1String("log"));
 }
 
 Logger *Logger::instance()
@@ -122,6 +130,18 @@ QVector<Log::Peer> Logger::getPeers(const int lastKnownId) const
     return loadFromBuffer(m_peers, (size - diff));
 }
 
+qint64 Logger::memoryUsage() const
+{
+    const QReadLocker locker(&m_lock);
+
+    qint64 size = (m_messages.size() * sizeof(Log::Msg)) + (m_peers.size() * sizeof(Log::Peer));
+    for (const Log::Msg &msg : m_messages)
+        size += MemoryStats::estimateSize(msg.message);
+    for (const Log::Peer &peer : m_peers)
+        size += MemoryStats::estimateSize(peer.ip) + MemoryStats::estimateSize(peer.reason);
+    return size;
+}
+
 void LogMsg(const QString &message, const Log::MsgType &type)
 {
     Logger::instance()->addMessage(message, type);
@@ -83,6 +83,8 @@ public:
     void addPeer(const QString &ip, bool blocked, const QString &reason = {});
     QVector<Log::Msg> getMessages(int lastKnownId = -1) const;
     QVector<Log::Peer> getPeers(int lastKnownId = -1) const;
+    // Approximate size of the stored messages and peers in bytes
+    qint64 memoryUsage() const;
 
 signals:
     void newLogMessage(const Log::Msg &message);
@@ -90,7 +92,7 @@ signals:
 
 private:
     Logger();
-    ~Logger() = default;
+    ~Logger() override;
 
     static Logger *m_instance;
     boost::circular_buffer_space_optimized<Log::Msg> m_messages;
@@ -0,0 +1,223 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "memorystats.h"
+
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#include <Windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+#include <QByteArray>
+#include <QFile>
+#include <QVariant>
+#include <QVariantHash>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include "base/global.h"
+
+namespace
+{
+    struct ProviderEntry
+    {
+        QString id;
+        QString name;
+        MemoryStats::Provider provider;
+    };
+
+    QVector<ProviderEntry> &providers()
+    {
+        static QVector<ProviderEntry> instance;
+        return instance;
+    }
+
+    template <typename Container>
+    qint64 estimateContainerSize(const Container &container)
+    {
+        qint64 size = 0;
+        for (auto i = container.cbegin(); i != container.cend(); ++i)
+            size += MemoryStats::estimateSize(i.key()) + MemoryStats::estimateSize(i.value());
+        return size;
+    }
+}
+
+void MemoryStats::registerProvider(const QString &id, const QString &name, const Provider &provider)
+{
+    QVector<ProviderEntry> &entries = providers();
+    const auto iter = std::find_if(entries.begin(), entries.end()
+        , [&id](const ProviderEntry &entry) { return (entry.id == id); });
+    if (iter != entries.end())
+        *iter = {id, name, provider};
+    else
+        entries.append({id, name, provider});
+}
+
+void MemoryStats::unregisterProvider(const QString &id)
+{
+    QVector<ProviderEntry> &entries = providers();
+    entries.erase(std::remove_if(entries.begin(), entries.end()
+        , [&id](const ProviderEntry &entry) { return (entry.id == id); }), entries.end());
+}
+
+QVector<MemoryStats::Entry> MemoryStats::snapshot()
+{
+    const QVector<ProviderEntry> &entries = providers();
+
+    QVector<Entry> result;
+    result.reserve(entries.size());
+    for (const ProviderEntry &entry : entries)
+        result.append({entry.id, entry.name, entry.provider()});
+    return result;
+}
+
+qint64 MemoryStats::totalSize(const QVector<Entry> &entries)
+{
+    qint64 total = 0;
+    for (const Entry &entry : entries)
+        total += entry.size;
+    return total;
+}
+
+qint64 MemoryStats::processResidentSize()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters {};
+    if (!::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+    return static_cast<qint64>(counters.WorkingSetSize);
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info {};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (::task_info(::mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+        return -1;
+    return static_cast<qint64>(info.resident_size);
+#elif defined(Q_OS_LINUX)
+    // The second field is the number of resident pages
+    QFile file {QLatin1String("/proc/self/statm")};
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    const QList<QByteArray> fields = file.readLine().split(' ');
+    if (fields.size() < 2)
+        return -1;
+
+    bool ok = false;
+    const qint64 pages = fields[1].toLongLong(&ok);
+    if (!ok)
+        return -1;
+    return pages * ::sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+qint64 MemoryStats::processPrivateSize()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS_EX counters {};
+    if (!::GetProcessMemoryInfo(::GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS *>(&counters), sizeof(counters)))
+        return -1;
+    return static_cast<qint64>(counters.PrivateUsage);
+#elif defined(Q_OS_MACOS)
+    task_vm_info_data_t info {};
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (::task_info(::mach_task_self(), TASK_VM_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+        return -1;
+    return static_cast<qint64>(info.phys_footprint);
+#elif defined(Q_OS_LINUX)
+    // The line looks like "RssAnon:\t   12345 kB"
+    QFile file {QLatin1String("/proc/self/status")};
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    while (!file.atEnd())
+    {
+        const QByteArray line = file.readLine();
+        if (!line.startsWith("RssAnon:"))
+            continue;
+
+        const QList<QByteArray> fields = line.mid(8).simplified().split(' ');
+        bool ok = false;
+        const qint64 kibs = fields[0].toLongLong(&ok);
+        return ok ? (kibs * 1024) : -1;
+    }
+    return -1;
+#else
+    return -1;
+#endif
+}
+
+qint64 MemoryStats::estimateSize(const QString &str)
+{
+    return str.capacity() * static_cast<qint64>(sizeof(QChar));
+}
+
+qint64 MemoryStats::estimateSize(const QByteArray &data)
+{
+    return data.capacity();
+}
+
+qint64 MemoryStats::estimateSize(const QVariant &value)
+{
+    qint64 size = sizeof(QVariant);
+
+    switch (static_cast<QMetaType::Type>(value.userType()))
+    {
+    case QMetaType::QString:
+        size += estimateSize(value.toString());
+        break;
+    case QMetaType::QByteArray:
+        size += estimateSize(value.toByteArray());
+        break;
+    case QMetaType::QStringList:
+        for (const QString &str : asConst(value.toStringList()))
+            size += sizeof(QString) + estimateSize(str);
+        break;
+    case QMetaType::QVariantList:
+        for (const QVariant &item : asConst(value.toList()))
+            size += estimateSize(item);
+        break;
+    case QMetaType::QVariantMap:
+        size += estimateContainerSize(value.toMap());
+        break;
+    case QMetaType::QVariantHash:
+        size += estimateContainerSize(value.toHash());
+        break;
+    default:
+        break;
+    }
+
+    return size;
+}
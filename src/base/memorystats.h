@@ -0,0 +1,70 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+
+#include <QString>
+#include <QVector>
+
+class QVariant;
+
+// Approximate accounting of the memory used by the main data structures.
+// Each subsystem registers a provider that estimates the size of the data it owns.
+// Providers are called from the main thread only.
+namespace MemoryStats
+{
+    struct Entry
+    {
+        QString id;
+        QString name;
+        // Bytes
+        qint64 size = 0;
+    };
+
+    using Provider = std::function<qint64 ()>;
+
+    // Registering a provider with an already known ID replaces it.
+    void registerProvider(const QString &id, const QString &name, const Provider &provider);
+    void unregisterProvider(const QString &id);
+
+    QVector<Entry> snapshot();
+    qint64 totalSize(const QVector<Entry> &entries);
+
+    // Returns the resident memory size of the process or -1 if it can't be determined
+    qint64 processResidentSize();
+    // Returns the size of the memory allocated by the process itself (excluding mapped files
+    // and shared libraries) or -1 if it can't be determined.
+    // It is RssAnon on Linux, the private bytes on Windows and the physical footprint on macOS.
+    qint64 processPrivateSize();
+
+    qint64 estimateSize(const QString &str);
+    qint64 estimateSize(const QByteArray &data);
+    qint64 estimateSize(const QVariant &value);
+}
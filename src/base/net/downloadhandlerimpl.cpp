@@ -112,6 +112,16 @@ void DownloadHandlerImpl::processFinishedDownload()
         return;
     }
 
+    // Conditional request and the resource has not been modified since
+    if (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304)
+    {
+        m_result.status = Net::DownloadStatus::NotModified;
+        m_result.eTag = m_reply->rawHeader("ETag");
+        m_result.lastModified = m_reply->rawHeader("Last-Modified");
+        finish();
+        return;
+    }
+
     // Check if the server ask us to redirect somewhere else
     const QVariant redirection = m_reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
     if (redirection.isValid())
@@ -124,6 +134,8 @@ void DownloadHandlerImpl::processFinishedDownload()
     m_result.data = (m_reply->rawHeader("Content-Encoding") == "gzip")
                     ? Utils::Gzip::decompress(m_reply->readAll())
                     : m_reply->readAll();
+    m_result.eTag = m_reply->rawHeader("ETag");
+    m_result.lastModified = m_reply->rawHeader("Last-Modified");
 
     if (m_downloadRequest.saveToFile())
     {
@@ -128,6 +128,10 @@ namespace
         // Qt doesn't support Magnet protocol so we need to handle redirections manually
         request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
 
+        const QHash<QByteArray, QByteArray> rawHeaders = downloadRequest.rawHeaders();
+        for (auto i = rawHeaders.cbegin(); i != rawHeaders.cend(); ++i)
+            request.setRawHeader(i.key(), i.value());
+
         return request;
     }
 }
@@ -359,6 +363,17 @@ Net::DownloadRequest &Net::DownloadRequest::destFileName(const QString &value)
     return *this;
 }
 
+QHash<QByteArray, QByteArray> Net::DownloadRequest::rawHeaders() const
+{
+    return m_rawHeaders;
+}
+
+Net::DownloadRequest &Net::DownloadRequest::rawHeader(const QByteArray &name, const QByteArray &value)
+{
+    m_rawHeaders[name] = value;
+    return *this;
+}
+
 Net::ServiceID Net::ServiceID::fromURL(const QUrl &url)
 {
     return {url.host(), url.port(80)};
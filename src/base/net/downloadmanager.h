@@ -57,6 +57,8 @@ namespace Net
     {
         Success,
         RedirectedToMagnet,
+        // conditional request and the resource has not changed (HTTP 304)
+        NotModified,
         Failed
     };
 
@@ -84,12 +86,17 @@ namespace Net
         QString destFileName() const;
         DownloadRequest &destFileName(const QString &value);
 
+        // additional HTTP request headers, e.g. "If-None-Match" for conditional requests
+        QHash<QByteArray, QByteArray> rawHeaders() const;
+        DownloadRequest &rawHeader(const QByteArray &name, const QByteArray &value);
+
     private:
         QString m_url;
         QString m_userAgent;
         qint64 m_limit = 0;
         bool m_saveToFile = false;
         QString m_destFileName;
+        QHash<QByteArray, QByteArray> m_rawHeaders;
     };
 
     struct DownloadResult
@@ -100,6 +107,9 @@ namespace Net
         QByteArray data;
         QString filePath;
         QString magnet;
+        // cache validators received from server
+        QByteArray eTag;
+        QByteArray lastModified;
     };
 
     class DownloadHandler : public QObject
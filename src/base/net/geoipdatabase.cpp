@@ -26,14 +26,14 @@
  * exception statement from your version.
  */
 
+#include "geoipdatabase.h"
+
 #include <QDateTime>
 #include <QDebug>
-#include <QFile>
 #include <QHostAddress>
+#include <QtEndian>
 #include <QVariant>
 
-#include "geoipdatabase.h"
-
 namespace
 {
     const qint32 MAX_FILE_SIZE = 67108864; // 64MB
@@ -60,6 +60,43 @@ namespace
         Boolean = 14,
         Float = 15
     };
+
+    template <int RecordSize>
+    quint32 readNodeRecord(const uchar *node, const bool right)
+    {
+        if constexpr (RecordSize == 24)
+        {
+            const uchar *record = node + (right ? 3 : 0);
+            return (static_cast<quint32>(record[0]) << 16) | (static_cast<quint32>(record[1]) << 8) | record[2];
+        }
+        else if constexpr (RecordSize == 28)
+        {
+            // the middle byte holds most significant bits of both records
+            if (right)
+                return (static_cast<quint32>(node[3] & 0x0F) << 24) | (static_cast<quint32>(node[4]) << 16)
+                    | (static_cast<quint32>(node[5]) << 8) | node[6];
+            return (static_cast<quint32>(node[3] & 0xF0) << 20) | (static_cast<quint32>(node[0]) << 16)
+                | (static_cast<quint32>(node[1]) << 8) | node[2];
+        }
+        else
+        {
+            static_assert(RecordSize == 32, "Unsupported record size");
+            return qFromBigEndian<quint32>(node + (right ? 4 : 0));
+        }
+    }
+
+    template <int RecordSize>
+    quint32 findNodeRecord(const uchar *data, const quint32 nodeCount, quint32 node, const uchar *addr, const int bitCount)
+    {
+        const size_t nodeSize = RecordSize / 4;
+        for (int i = 0; (i < bitCount) && (node < nodeCount); ++i)
+        {
+            const bool right = ((addr[i / 8] >> (7 - (i % 8))) & 1);
+            node = readNodeRecord<RecordSize>(data + (node * nodeSize), right);
+        }
+
+        return node;
+    }
 }
 
 struct DataFieldDescriptor
@@ -72,43 +109,40 @@ struct DataFieldDescriptor
     };
 };
 
-GeoIPDatabase::GeoIPDatabase(const quint32 size)
-    : m_ipVersion(0)
-    , m_recordSize(0)
-    , m_nodeCount(0)
-    , m_nodeSize(0)
-    , m_indexSize(0)
-    , m_recordBytes(0)
-    , m_size(size)
-    , m_data(new uchar[size])
-{
-}
-
 GeoIPDatabase *GeoIPDatabase::load(const QString &filename, QString &error)
 {
-    GeoIPDatabase *db = nullptr;
-    QFile file(filename);
+    auto *db = new GeoIPDatabase;
+    QFile &file = db->m_file;
+    file.setFileName(filename);
     if (file.size() > MAX_FILE_SIZE)
     {
         error = tr("Unsupported database file size.");
+        delete db;
         return nullptr;
     }
 
     if (!file.open(QFile::ReadOnly))
     {
         error = file.errorString();
+        delete db;
         return nullptr;
     }
 
-    db = new GeoIPDatabase(file.size());
-
-    if (file.read(reinterpret_cast<char *>(db->m_data), db->m_size) != db->m_size)
+    db->m_size = file.size();
+    db->m_data = file.map(0, db->m_size);
+    if (!db->m_data)
     {
-        error = file.errorString();
-        delete db;
-        return nullptr;
-    }
+        // memory mapping isn't supported by every file system, so fall back to reading it
+        db->m_buffer = file.readAll();
+        if (db->m_buffer.size() != static_cast<int>(db->m_size))
+        {
+            error = file.errorString();
+            delete db;
+            return nullptr;
+        }
 
+        db->m_data = reinterpret_cast<const uchar *>(db->m_buffer.constData());
+    }
 
     if (!db->parseMetadata(db->readMetadata(), error) || !db->loadDB(error))
     {
@@ -128,9 +162,10 @@ GeoIPDatabase *GeoIPDatabase::load(const QByteArray &data, QString &error)
         return nullptr;
     }
 
-    db = new GeoIPDatabase(data.size());
-
-    memcpy(reinterpret_cast<char *>(db->m_data), data.constData(), db->m_size);
+    db = new GeoIPDatabase;
+    db->m_buffer = data;
+    db->m_size = data.size();
+    db->m_data = reinterpret_cast<const uchar *>(db->m_buffer.constData());
 
     if (!db->parseMetadata(db->readMetadata(), error) || !db->loadDB(error))
     {
@@ -141,10 +176,7 @@ GeoIPDatabase *GeoIPDatabase::load(const QByteArray &data, QString &error)
     return db;
 }
 
-GeoIPDatabase::~GeoIPDatabase()
-{
-    delete [] m_data;
-}
+GeoIPDatabase::~GeoIPDatabase() = default;
 
 QString GeoIPDatabase::type() const
 {
@@ -163,50 +195,51 @@ QDateTime GeoIPDatabase::buildEpoch() const
 
 QString GeoIPDatabase::lookup(const QHostAddress &hostAddr) const
 {
-    Q_IPV6ADDR addr = hostAddr.toIPv6Address();
+    quint32 record = 0;
+    bool isIPv4 = false;
+    const quint32 ipv4Addr = hostAddr.toIPv4Address(&isIPv4);
+    if (isIPv4)
+    {
+        uchar addr[4];
+        qToBigEndian(ipv4Addr, addr);
+        record = findRecord(m_ipv4StartNode, addr, 32);
+    }
+    else
+    {
+        const Q_IPV6ADDR addr = hostAddr.toIPv6Address();
+        record = findRecord(0, addr.c, 128);
+    }
 
-    const uchar *ptr = m_data;
+    if (record <= m_nodeCount)
+        return {};
 
-    for (int i = 0; i < 16; ++i)
     {
-        for (int j = 0; j < 8; ++j)
-        {
-            const bool right = static_cast<bool>((addr[i] >> (7 - j)) & 1);
-            // Interpret the left/right record as number
-            if (right)
-                ptr += m_recordBytes;
-
-            quint32 id = 0;
-            auto *idPtr = reinterpret_cast<uchar *>(&id);
-            memcpy(&idPtr[4 - m_recordBytes], ptr, m_recordBytes);
-            fromBigEndian(idPtr, 4);
-
-            if (id == m_nodeCount)
-            {
-                return {};
-            }
-            if (id > m_nodeCount)
-            {
-                QString country = m_countries.value(id);
-                if (country.isEmpty())
-                {
-                    const quint32 offset = id - m_nodeCount - sizeof(DATA_SECTION_SEPARATOR);
-                    quint32 tmp = offset + m_indexSize + sizeof(DATA_SECTION_SEPARATOR);
-                    const QVariant val = readDataField(tmp);
-                    if (val.userType() == QMetaType::QVariantHash)
-                    {
-                        country = val.toHash()["country"].toHash()["iso_code"].toString();
-                        m_countries[id] = country;
-                    }
-                }
-                return country;
-            }
-
-            ptr = m_data + (id * m_nodeSize);
-        }
+        const QReadLocker locker {&m_countriesLock};
+        const auto iter = m_countries.constFind(record);
+        if (iter != m_countries.cend())
+            return iter.value();
     }
 
-    return {};
+    // Data records are decoded on first use, so loading doesn't have to
+    // walk the whole index. A country database has only a few hundreds
+    // of distinct data records, so the cache stays small.
+    const QString country = readCountry(record);
+    const QWriteLocker locker {&m_countriesLock};
+    m_countries.insert(record, country);
+    return country;
+}
+
+quint32 GeoIPDatabase::findRecord(const quint32 node, const uchar *addr, const int bitCount) const
+{
+    switch (m_recordSize)
+    {
+    case 24:
+        return findNodeRecord<24>(m_data, m_nodeCount, node, addr, bitCount);
+    case 28:
+        return findNodeRecord<28>(m_data, m_nodeCount, node, addr, bitCount);
+    default:
+        return findNodeRecord<32>(m_data, m_nodeCount, node, addr, bitCount);
+    }
 }
 
 #define CHECK_METADATA_REQ(key, type) \
@@ -258,13 +291,12 @@ bool GeoIPDatabase::parseMetadata(const QVariantHash &metadata, QString &error)
 
     CHECK_METADATA_REQ(record_size, UShort);
     m_recordSize = metadata.value("record_size").value<quint16>();
-    if (m_recordSize != 24)
+    if ((m_recordSize != 24) && (m_recordSize != 28) && (m_recordSize != 32))
     {
         error = tr("Unsupported record size: %1").arg(m_recordSize);
         return false;
     }
     m_nodeSize = m_recordSize / 4;
-    m_recordBytes = m_nodeSize / 2;
 
     CHECK_METADATA_REQ(node_count, UInt);
     m_nodeCount = metadata.value("node_count").value<quint32>();
@@ -282,12 +314,11 @@ bool GeoIPDatabase::parseMetadata(const QVariantHash &metadata, QString &error)
     return true;
 }
 
-bool GeoIPDatabase::loadDB(QString &error) const
+bool GeoIPDatabase::loadDB(QString &error)
 {
     qDebug() << "Parsing IP geolocation database index tree...";
 
-    const int nodeSize = m_recordSize / 4; // in bytes
-    const int indexSize = m_nodeCount * nodeSize;
+    const quint64 indexSize = static_cast<quint64>(m_nodeCount) * m_nodeSize;
     if ((m_size < (indexSize + sizeof(DATA_SECTION_SEPARATOR)))
         || (memcmp(m_data + indexSize, DATA_SECTION_SEPARATOR, sizeof(DATA_SECTION_SEPARATOR)) != 0))
         {
@@ -295,9 +326,27 @@ bool GeoIPDatabase::loadDB(QString &error) const
         return false;
     }
 
+    // IPv4 addresses are stored in "::/96" subtree
+    const uchar ipv4Prefix[12] = {0};
+    m_ipv4StartNode = findRecord(0, ipv4Prefix, 96);
+
     return true;
 }
 
+QString GeoIPDatabase::readCountry(const quint32 record) const
+{
+    const quint64 offset = static_cast<quint64>(record) - m_nodeCount + m_indexSize;
+    if ((record < (m_nodeCount + sizeof(DATA_SECTION_SEPARATOR))) || (offset >= m_size))
+        return {};
+
+    quint32 tmp = offset;
+    const QVariant val = readDataField(tmp);
+    if (val.userType() != QMetaType::QVariantHash)
+        return {};
+
+    return val.toHash()["country"].toHash()["iso_code"].toString();
+}
+
 QVariantHash GeoIPDatabase::readMetadata() const
 {
     const char *ptr = reinterpret_cast<const char *>(m_data);
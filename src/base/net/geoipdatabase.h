@@ -28,10 +28,13 @@
 
 #pragma once
 
+#include <QByteArray>
 #include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QReadWriteLock>
 #include <QtGlobal>
 
-class QByteArray;
 class QDateTime;
 class QHostAddress;
 class QString;
@@ -51,15 +54,19 @@ public:
     QString type() const;
     quint16 ipVersion() const;
     QDateTime buildEpoch() const;
+    // It is safe to call it concurrently, only the country cache is shared and it is guarded by a lock
     QString lookup(const QHostAddress &hostAddr) const;
 
 private:
-    explicit GeoIPDatabase(quint32 size);
+    GeoIPDatabase() = default;
 
     bool parseMetadata(const QVariantHash &metadata, QString &error);
-    bool loadDB(QString &error) const;
+    bool loadDB(QString &error);
+    QString readCountry(quint32 record) const;
     QVariantHash readMetadata() const;
 
+    quint32 findRecord(quint32 node, const uchar *addr, int bitCount) const;
+
     QVariant readDataField(quint32 &offset) const;
     bool readDataFieldDescriptor(quint32 &offset, DataFieldDescriptor &out) const;
     void fromBigEndian(uchar *buf, quint32 len) const;
@@ -86,16 +93,22 @@ private:
     }
 
     // Metadata
-    quint16 m_ipVersion;
-    quint16 m_recordSize;
-    quint32 m_nodeCount;
-    int m_nodeSize;
-    int m_indexSize;
-    int m_recordBytes;
+    quint16 m_ipVersion = 0;
+    quint16 m_recordSize = 0;
+    quint32 m_nodeCount = 0;
+    int m_nodeSize = 0;
+    int m_indexSize = 0;
     QDateTime m_buildEpoch;
     QString m_dbType;
     // Search data
+    // record of the IPv4 subtree root (i.e. of "::/96"), so IPv4 lookups skip the first 96 levels
+    quint32 m_ipv4StartNode = 0;
+    // country codes of the data records decoded so far
     mutable QHash<quint32, QString> m_countries;
-    quint32 m_size;
-    uchar *m_data;
+    mutable QReadWriteLock m_countriesLock;
+    // database content, either memory-mapped file or in-memory buffer
+    QFile m_file;
+    QByteArray m_buffer;
+    const uchar *m_data = nullptr;
+    quint32 m_size = 0;
 };
@@ -32,6 +32,10 @@
 #include <QString>
 
 const int CACHE_SIZE = 2048;
+// Limit the number of simultaneous lookups so that big peer lists don't flood the resolver
+const int MAX_CONCURRENT_LOOKUPS = 16;
+// Host names may change over time, failed lookups are cached as well
+const int CACHE_TTL = 30 * 60 * 1000; // ms
 
 using namespace Net;
 
@@ -58,13 +62,30 @@ ReverseResolution::~ReverseResolution()
 
 void ReverseResolution::resolve(const QHostAddress &ip)
 {
-    const QString *hostname = m_cache.object(ip);
-    if (hostname)
+    if (const CachedHostName *cached = m_cache.object(ip))
     {
-        emit ipResolved(ip, *hostname);
-        return;
+        if (!cached->expiration.hasExpired())
+        {
+            emit ipResolved(ip, cached->hostName);
+            return;
+        }
+
+        m_cache.remove(ip);
     }
 
+    // the result will be reported once the pending lookup is finished
+    if (m_pendingIPs.contains(ip))
+        return;
+
+    m_pendingIPs.insert(ip);
+    if (m_lookups.size() < MAX_CONCURRENT_LOOKUPS)
+        startLookup(ip);
+    else
+        m_queuedIPs.enqueue(ip);
+}
+
+void ReverseResolution::startLookup(const QHostAddress &ip)
+{
     // do reverse lookup: IP -> hostname
     const int lookupId = QHostInfo::lookupHost(ip.toString(), this, &ReverseResolution::hostResolved);
     m_lookups.insert(lookupId, ip);
@@ -73,16 +94,14 @@ void ReverseResolution::resolve(const QHostAddress &ip)
 void ReverseResolution::hostResolved(const QHostInfo &host)
 {
     const QHostAddress ip = m_lookups.take(host.lookupId());
+    m_pendingIPs.remove(ip);
 
-    if (host.error() != QHostInfo::NoError)
-    {
-        emit ipResolved(ip, {});
-        return;
-    }
+    if (!m_queuedIPs.isEmpty())
+        startLookup(m_queuedIPs.dequeue());
 
-    const QString hostname = isUsefulHostName(host.hostName(), ip)
+    const QString hostname = ((host.error() == QHostInfo::NoError) && isUsefulHostName(host.hostName(), ip))
         ? host.hostName()
         : QString();
-    m_cache.insert(ip, new QString(hostname));
+    m_cache.insert(ip, new CachedHostName {hostname, QDeadlineTimer(CACHE_TTL)});
     emit ipResolved(ip, hostname);
 }
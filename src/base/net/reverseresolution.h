@@ -29,8 +29,11 @@
 #pragma once
 
 #include <QCache>
+#include <QDeadlineTimer>
 #include <QHostAddress>
 #include <QObject>
+#include <QQueue>
+#include <QSet>
 
 class QHostInfo;
 class QString;
@@ -55,7 +58,17 @@ namespace Net
         void hostResolved(const QHostInfo &host);
 
     private:
+        struct CachedHostName
+        {
+            QString hostName;
+            QDeadlineTimer expiration;
+        };
+
+        void startLookup(const QHostAddress &ip);
+
         QHash<int, QHostAddress> m_lookups;  // <LookupID, IP>
-        QCache<QHostAddress, QString> m_cache;  // <IP, HostName>
+        QQueue<QHostAddress> m_queuedIPs;  // waiting for a free lookup slot
+        QSet<QHostAddress> m_pendingIPs;  // either being looked up or queued
+        QCache<QHostAddress, CachedHostName> m_cache;  // <IP, HostName>
     };
 }
@@ -44,6 +44,7 @@
 #include <QList>
 #include <QLocale>
 #include <QNetworkCookie>
+#include <QSet>
 #include <QSettings>
 #include <QSize>
 #include <QTime>
@@ -61,6 +62,29 @@
 
 namespace
 {
+    const QString KEY_HIDE_ZERO_VALUES = QStringLiteral("Preferences/General/HideZeroValues");
+    const QString KEY_HIDE_ZERO_COMBO_VALUES = QStringLiteral("Preferences/General/HideZeroComboValues");
+    const QString KEY_RECHECK_ON_COMPLETION = QStringLiteral("Preferences/Advanced/RecheckOnCompletion");
+    const QString KEY_RESOLVE_PEER_COUNTRIES = QStringLiteral("Preferences/Connection/ResolvePeerCountries");
+    const QString KEY_RESOLVE_PEER_HOST_NAMES = QStringLiteral("Preferences/Connection/ResolvePeerHostNames");
+    const QString KEY_TRANSFER_LIST_REGEX_FILTER = QStringLiteral("TransferList/UseRegexAsFilteringPattern");
+
+    // Keys of the preferences kept in PreferencesSnapshot
+    bool isSnapshotKey(const QString &key)
+    {
+        static const QSet<QString> snapshotKeys =
+        {
+            KEY_HIDE_ZERO_VALUES,
+            KEY_HIDE_ZERO_COMBO_VALUES,
+            KEY_RECHECK_ON_COMPLETION,
+            KEY_RESOLVE_PEER_COUNTRIES,
+            KEY_RESOLVE_PEER_HOST_NAMES,
+            KEY_TRANSFER_LIST_REGEX_FILTER
+        };
+
+        return snapshotKeys.contains(key);
+    }
+
 #ifdef Q_OS_WIN
     QString makeProfileID(const QString &profilePath, const QString &profileName)
     {
@@ -73,7 +97,10 @@ namespace
 
 Preferences *Preferences::m_instance = nullptr;
 
-Preferences::Preferences() = default;
+Preferences::Preferences()
+{
+    updateSnapshot();
+}
 
 Preferences *Preferences::instance()
 {
@@ -99,7 +126,29 @@ QVariant Preferences::value(const QString &key, const QVariant &defaultValue) co
 
 void Preferences::setValue(const QString &key, const QVariant &value)
 {
+    const bool isSnapshotChanged = isSnapshotKey(key) && (this->value(key) != value);
     SettingsStorage::instance()->storeValue(key, value);
+    if (isSnapshotChanged)
+        updateSnapshot();
+}
+
+const PreferencesSnapshot &Preferences::snapshot() const
+{
+    return *m_snapshot.load(std::memory_order_acquire);
+}
+
+void Preferences::updateSnapshot()
+{
+    auto snapshot = std::make_unique<PreferencesSnapshot>();
+    snapshot->hideZeroValues = getHideZeroValues();
+    snapshot->hideZeroComboValues = getHideZeroComboValues();
+    snapshot->recheckTorrentsOnCompletion = recheckTorrentsOnCompletion();
+    snapshot->resolvePeerCountries = resolvePeerCountries();
+    snapshot->resolvePeerHostNames = resolvePeerHostNames();
+    snapshot->regexAsFilteringPatternForTransferList = getRegexAsFilteringPatternForTransferList();
+
+    m_snapshot.store(snapshot.get(), std::memory_order_release);
+    m_snapshots.push_back(std::move(snapshot));
 }
 
 // General options
@@ -177,22 +226,22 @@ void Preferences::setAlternatingRowColors(const bool b)
 
 bool Preferences::getHideZeroValues() const
 {
-    return value("Preferences/General/HideZeroValues", false).toBool();
+    return value(KEY_HIDE_ZERO_VALUES, false).toBool();
 }
 
 void Preferences::setHideZeroValues(const bool b)
 {
-    setValue("Preferences/General/HideZeroValues", b);
+    setValue(KEY_HIDE_ZERO_VALUES, b);
 }
 
 int Preferences::getHideZeroComboValues() const
 {
-    return value("Preferences/General/HideZeroComboValues", 0).toInt();
+    return value(KEY_HIDE_ZERO_COMBO_VALUES, 0).toInt();
 }
 
 void Preferences::setHideZeroComboValues(const int n)
 {
-    setValue("Preferences/General/HideZeroComboValues", n);
+    setValue(KEY_HIDE_ZERO_COMBO_VALUES, n);
 }
 
 // In Mac OS X the dock is sufficient for our needs so we disable the sys tray functionality.
@@ -806,6 +855,26 @@ void Preferences::setWebUITrustedReverseProxiesList(const QString &addr)
     setValue("Preferences/WebUI/TrustedReverseProxiesList", addr);
 }
 
+bool Preferences::isWebUIMetricsEnabled() const
+{
+    return value("Preferences/WebUI/MetricsEnabled", false).toBool();
+}
+
+void Preferences::setWebUIMetricsEnabled(const bool enabled)
+{
+    setValue("Preferences/WebUI/MetricsEnabled", enabled);
+}
+
+bool Preferences::isWebUIMetricsAuthEnabled() const
+{
+    return value("Preferences/WebUI/MetricsAuthEnabled", true).toBool();
+}
+
+void Preferences::setWebUIMetricsAuthEnabled(const bool enabled)
+{
+    setValue("Preferences/WebUI/MetricsAuthEnabled", enabled);
+}
+
 bool Preferences::isDynDNSEnabled() const
 {
     return value("Preferences/DynDNS/Enabled", false).toBool();
@@ -961,32 +1030,32 @@ void Preferences::setDontConfirmAutoExit(const bool dontConfirmAutoExit)
 
 bool Preferences::recheckTorrentsOnCompletion() const
 {
-    return value("Preferences/Advanced/RecheckOnCompletion", false).toBool();
+    return value(KEY_RECHECK_ON_COMPLETION, false).toBool();
 }
 
 void Preferences::recheckTorrentsOnCompletion(const bool recheck)
 {
-    setValue("Preferences/Advanced/RecheckOnCompletion", recheck);
+    setValue(KEY_RECHECK_ON_COMPLETION, recheck);
 }
 
 bool Preferences::resolvePeerCountries() const
 {
-    return value("Preferences/Connection/ResolvePeerCountries", true).toBool();
+    return value(KEY_RESOLVE_PEER_COUNTRIES, true).toBool();
 }
 
 void Preferences::resolvePeerCountries(const bool resolve)
 {
-    setValue("Preferences/Connection/ResolvePeerCountries", resolve);
+    setValue(KEY_RESOLVE_PEER_COUNTRIES, resolve);
 }
 
 bool Preferences::resolvePeerHostNames() const
 {
-    return value("Preferences/Connection/ResolvePeerHostNames", false).toBool();
+    return value(KEY_RESOLVE_PEER_HOST_NAMES, false).toBool();
 }
 
 void Preferences::resolvePeerHostNames(const bool resolve)
 {
-    setValue("Preferences/Connection/ResolvePeerHostNames", resolve);
+    setValue(KEY_RESOLVE_PEER_HOST_NAMES, resolve);
 }
 
 #if (defined(Q_OS_UNIX) && !defined(Q_OS_MACOS))
@@ -1507,12 +1576,12 @@ void Preferences::setTransHeaderState(const QByteArray &state)
 
 bool Preferences::getRegexAsFilteringPatternForTransferList() const
 {
-    return value("TransferList/UseRegexAsFilteringPattern", false).toBool();
+    return value(KEY_TRANSFER_LIST_REGEX_FILTER, false).toBool();
 }
 
 void Preferences::setRegexAsFilteringPatternForTransferList(const bool checked)
 {
-    setValue("TransferList/UseRegexAsFilteringPattern", checked);
+    setValue(KEY_TRANSFER_LIST_REGEX_FILTER, checked);
 }
 
 // From old RssSettings class
@@ -1588,6 +1657,6 @@ void Preferences::setSpeedWidgetGraphEnable(const int id, const bool enable)
 
 void Preferences::apply()
 {
-    if (SettingsStorage::instance()->save())
-        emit changed();
+    SettingsStorage::instance()->save();
+    emit changed();
 }
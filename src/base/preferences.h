@@ -29,6 +29,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <QtContainerFwd>
 #include <QtGlobal>
 #include <QVariant>
@@ -74,6 +78,17 @@ namespace DNS
     };
 }
 
+// Typed copy of the preferences that are read in hot paths
+struct PreferencesSnapshot
+{
+    bool hideZeroValues = false;
+    int hideZeroComboValues = 0;
+    bool recheckTorrentsOnCompletion = false;
+    bool resolvePeerCountries = true;
+    bool resolvePeerHostNames = false;
+    bool regexAsFilteringPatternForTransferList = false;
+};
+
 class Preferences : public QObject
 {
     Q_OBJECT
@@ -84,8 +99,14 @@ class Preferences : public QObject
     QVariant value(const QString &key, const QVariant &defaultValue = {}) const;
     void setValue(const QString &key, const QVariant &value);
 
+    void updateSnapshot();
+
     static Preferences *m_instance;
 
+    std::atomic<const PreferencesSnapshot *> m_snapshot {nullptr};
+    // Replaced snapshots are kept, so the references handed out never dangle
+    std::vector<std::unique_ptr<const PreferencesSnapshot>> m_snapshots;
+
 signals:
     void changed();
 
@@ -94,6 +115,10 @@ public:
     static void freeInstance();
     static Preferences *instance();
 
+    // The snapshot is immutable and is replaced as a whole when one of its preferences is changed.
+    // It is cheap to get and the returned reference stays valid as long as Preferences exists.
+    const PreferencesSnapshot &snapshot() const;
+
     // General options
     QString getLocale() const;
     void setLocale(const QString &locale);
@@ -232,6 +257,12 @@ public:
     QString getWebUITrustedReverseProxiesList() const;
     void setWebUITrustedReverseProxiesList(const QString &addr);
 
+    // OpenMetrics endpoint
+    bool isWebUIMetricsEnabled() const;
+    void setWebUIMetricsEnabled(bool enabled);
+    bool isWebUIMetricsAuthEnabled() const;
+    void setWebUIMetricsAuthEnabled(bool enabled);
+
     // Dynamic DNS
     bool isDynDNSEnabled() const;
     void setDynDNSEnabled(bool enabled);
@@ -33,6 +33,7 @@
 #include <QJsonObject>
 #include <QVariant>
 
+#include "../memorystats.h"
 #include "rss_feed.h"
 
 using namespace RSS;
@@ -60,17 +61,7 @@ const QString Article::KeyLink(QStringLiteral("link"));
 const QString Article::KeyIsRead(QStringLiteral("isRead"));
 
 Article::Article(Feed *feed, const QVariantHash &varHash)
-    : QObject(feed)
-    , m_feed(feed)
-    , m_guid(varHash.value(KeyId).toString())
-    , m_date(varHash.value(KeyDate).toDateTime())
-    , m_title(varHash.value(KeyTitle).toString())
-    , m_author(varHash.value(KeyAuthor).toString())
-    , m_description(varHash.value(KeyDescription).toString())
-    , m_torrentURL(varHash.value(KeyTorrentURL).toString())
-    , m_link(varHash.value(KeyLink).toString())
-    , m_isRead(varHash.value(KeyIsRead, false).toBool())
-    , m_data(varHash)
+    : Article(feed, varHash, true)
 {
 }
 
@@ -79,6 +70,21 @@ Article::Article(Feed *feed, const QJsonObject &jsonObj)
 {
 }
 
+Article::Article(Feed *feed, const QVariantHash &header, const bool isDataLoaded)
+    : QObject(feed)
+    , m_feed(feed)
+    , m_guid(header.value(KeyId).toString())
+    , m_date(header.value(KeyDate).toDateTime())
+    , m_title(header.value(KeyTitle).toString())
+    , m_author(header.value(KeyAuthor).toString())
+    , m_torrentURL(header.value(KeyTorrentURL).toString())
+    , m_link(header.value(KeyLink).toString())
+    , m_isRead(header.value(KeyIsRead, false).toBool())
+    , m_isDataLoaded(isDataLoaded)
+    , m_data(isDataLoaded ? header : QVariantHash())
+{
+}
+
 QString Article::guid() const
 {
     return m_guid;
@@ -101,7 +107,7 @@ QString Article::author() const
 
 QString Article::description() const
 {
-    return m_description;
+    return data().value(KeyDescription).toString();
 }
 
 QString Article::torrentUrl() const
@@ -121,7 +127,50 @@ bool Article::isRead() const
 
 QVariantHash Article::data() const
 {
-    return m_data;
+    if (m_isDataLoaded)
+        return m_data;
+
+    // Not cached intentionally, so the full data of
+    // old articles doesn't stay resident once viewed
+    return completeData(m_feed->loadArticleData(m_guid));
+}
+
+QVariantHash Article::data(const QHash<QString, QVariantHash> &storedData) const
+{
+    if (m_isDataLoaded)
+        return m_data;
+
+    return completeData(storedData.value(m_guid));
+}
+
+QVariantHash Article::completeData(QVariantHash storedData) const
+{
+    storedData[KeyId] = m_guid;
+    storedData[KeyDate] = m_date;
+    storedData[KeyIsRead] = m_isRead;
+    return storedData;
+}
+
+QVariantHash Article::header() const
+{
+    return {
+        {KeyId, m_guid},
+        {KeyDate, m_date},
+        {KeyTitle, m_title},
+        {KeyAuthor, m_author},
+        {KeyTorrentURL, m_torrentURL},
+        {KeyLink, m_link},
+        {KeyIsRead, m_isRead}
+    };
+}
+
+qint64 Article::memoryUsage() const
+{
+    qint64 size = sizeof(Article) + MemoryStats::estimateSize(m_guid) + MemoryStats::estimateSize(m_title)
+        + MemoryStats::estimateSize(m_author) + MemoryStats::estimateSize(m_torrentURL) + MemoryStats::estimateSize(m_link);
+    for (auto i = m_data.cbegin(); i != m_data.cend(); ++i)
+        size += MemoryStats::estimateSize(i.key()) + MemoryStats::estimateSize(i.value());
+    return size;
 }
 
 void Article::markAsRead()
@@ -129,14 +178,26 @@ void Article::markAsRead()
     if (!m_isRead)
     {
         m_isRead = true;
-        m_data[KeyIsRead] = m_isRead;
+        if (m_isDataLoaded)
+            m_data[KeyIsRead] = m_isRead;
         emit read(this);
     }
 }
 
+void Article::unloadData()
+{
+    m_isDataLoaded = false;
+    m_data.clear();
+}
+
 QJsonObject Article::toJsonObject() const
 {
-    auto jsonObj = QJsonObject::fromVariantHash(m_data);
+    return toJsonObject(data());
+}
+
+QJsonObject Article::toJsonObject(const QVariantHash &data) const
+{
+    auto jsonObj = QJsonObject::fromVariantHash(data);
     // JSON object doesn't support DateTime so we need to convert it
     jsonObj[KeyDate] = m_date.toString(Qt::RFC2822Date);
 
@@ -48,6 +48,9 @@ namespace RSS
 
         Article(Feed *feed, const QVariantHash &varHash);
         Article(Feed *feed, const QJsonObject &jsonObj);
+        // Creates article from its header only, the rest of
+        // the data is loaded from the feed storage on demand
+        Article(Feed *feed, const QVariantHash &header, bool isDataLoaded);
 
     public:
         static const QString KeyId;
@@ -69,6 +72,11 @@ namespace RSS
         QString link() const;
         bool isRead() const;
         QVariantHash data() const;
+        // The fields kept in memory (all except the bulky ones like description),
+        // available without loading the article data from the feed storage
+        QVariantHash header() const;
+        // Approximate size of the article in memory, in bytes
+        qint64 memoryUsage() const;
 
         void markAsRead();
 
@@ -80,15 +88,21 @@ namespace RSS
         void read(Article *article = nullptr);
 
     private:
+        // Uses data of the feed articles loaded at once instead of loading it per article
+        QVariantHash data(const QHash<QString, QVariantHash> &storedData) const;
+        QVariantHash completeData(QVariantHash storedData) const;
+        QJsonObject toJsonObject(const QVariantHash &data) const;
+        void unloadData();
+
         Feed *m_feed = nullptr;
         QString m_guid;
         QDateTime m_date;
         QString m_title;
         QString m_author;
-        QString m_description;
         QString m_torrentURL;
         QString m_link;
         bool m_isRead = false;
+        bool m_isDataLoaded = true;
         QVariantHash m_data;
     };
 }
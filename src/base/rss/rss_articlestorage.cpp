@@ -0,0 +1,791 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "rss_articlestorage.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QThread>
+#include <QUuid>
+#include <QVector>
+
+#include "base/exceptions.h"
+#include "base/logger.h"
+#include "base/utils/fs.h"
+#include "rss_article.h"
+
+namespace
+{
+    const char DB_CONNECTION_NAME[] = "RSSArticleStorage";
+
+    const int DB_VERSION = 1;
+
+    const char DB_TABLE_META[] = "meta";
+    const char DB_TABLE_ARTICLES[] = "articles";
+    const char DB_TABLE_FEEDS[] = "feeds";
+
+    struct Column
+    {
+        QString name;
+        QString placeholder;
+    };
+
+    Column makeColumn(const char *columnName)
+    {
+        return {QLatin1String(columnName), (QLatin1Char(':') + QLatin1String(columnName))};
+    }
+
+    const Column DB_COLUMN_ID = makeColumn("id");
+    const Column DB_COLUMN_NAME = makeColumn("name");
+    const Column DB_COLUMN_VALUE = makeColumn("value");
+    const Column DB_COLUMN_FEED_UID = makeColumn("feed_uid");
+    const Column DB_COLUMN_GUID = makeColumn("guid");
+    const Column DB_COLUMN_DATE = makeColumn("date");
+    const Column DB_COLUMN_TITLE = makeColumn("title");
+    const Column DB_COLUMN_AUTHOR = makeColumn("author");
+    const Column DB_COLUMN_TORRENT_URL = makeColumn("torrent_url");
+    const Column DB_COLUMN_LINK = makeColumn("link");
+    const Column DB_COLUMN_IS_READ = makeColumn("is_read");
+    const Column DB_COLUMN_DATA = makeColumn("data");
+    const Column DB_COLUMN_ETAG = makeColumn("etag");
+    const Column DB_COLUMN_LAST_MODIFIED = makeColumn("last_modified");
+    const Column DB_COLUMN_DATA_HASH = makeColumn("data_hash");
+
+    QString quoted(const QString &name)
+    {
+        const QLatin1Char quote {'`'};
+
+        return (quote + name + quote);
+    }
+
+    QString makeColumnDefinition(const Column &column, const char *definition)
+    {
+        return QString::fromLatin1("%1 %2").arg(quoted(column.name), QLatin1String(definition));
+    }
+
+    QString makeCreateTableFeedsStatement()
+    {
+        return QString::fromLatin1("CREATE TABLE %1 (%2, %3, %4, %5)")
+                .arg(quoted(DB_TABLE_FEEDS)
+                     , makeColumnDefinition(DB_COLUMN_FEED_UID, "TEXT NOT NULL PRIMARY KEY")
+                     , makeColumnDefinition(DB_COLUMN_ETAG, "BLOB")
+                     , makeColumnDefinition(DB_COLUMN_LAST_MODIFIED, "BLOB")
+                     , makeColumnDefinition(DB_COLUMN_DATA_HASH, "BLOB"));
+    }
+
+    QString toUIDString(const QUuid &uid)
+    {
+        return uid.toString(QUuid::WithoutBraces);
+    }
+
+    QVariant toDBValue(const QDateTime &date)
+    {
+        return date.isValid() ? QVariant(date.toMSecsSinceEpoch()) : QVariant(QVariant::LongLong);
+    }
+
+    QDateTime fromDBValue(const QVariant &value)
+    {
+        return value.isNull() ? QDateTime() : QDateTime::fromMSecsSinceEpoch(value.toLongLong());
+    }
+
+    // Header fields and read state are kept in separate columns,
+    // everything else goes to the data blob
+    QByteArray serializeData(QVariantHash article)
+    {
+        article.remove(RSS::Article::KeyDate);
+        article.remove(RSS::Article::KeyIsRead);
+        return QJsonDocument(QJsonObject::fromVariantHash(article)).toJson(QJsonDocument::Compact);
+    }
+
+    void storeArticles(QSqlDatabase db, const QUuid &feedUID, const QVector<QVariantHash> &articles)
+    {
+        const QString insertArticleStatement = QString::fromLatin1(
+                    "INSERT INTO %1 (%2, %3, %4, %5, %6, %7, %8, %9, %10) VALUES (%11, %12, %13, %14, %15, %16, %17, %18, %19)"
+                    " ON CONFLICT (%2, %3) DO UPDATE SET (%4, %5, %6, %7, %8, %9, %10) = (%13, %14, %15, %16, %17, %18, %19)")
+                .arg(quoted(DB_TABLE_ARTICLES)
+                     , quoted(DB_COLUMN_FEED_UID.name), quoted(DB_COLUMN_GUID.name), quoted(DB_COLUMN_DATE.name)
+                     , quoted(DB_COLUMN_TITLE.name), quoted(DB_COLUMN_AUTHOR.name), quoted(DB_COLUMN_TORRENT_URL.name)
+                     , quoted(DB_COLUMN_LINK.name), quoted(DB_COLUMN_IS_READ.name))
+                .arg(quoted(DB_COLUMN_DATA.name)
+                     , DB_COLUMN_FEED_UID.placeholder, DB_COLUMN_GUID.placeholder, DB_COLUMN_DATE.placeholder
+                     , DB_COLUMN_TITLE.placeholder, DB_COLUMN_AUTHOR.placeholder, DB_COLUMN_TORRENT_URL.placeholder
+                     , DB_COLUMN_LINK.placeholder, DB_COLUMN_IS_READ.placeholder)
+                .arg(DB_COLUMN_DATA.placeholder);
+
+        if (!db.transaction())
+            throw RuntimeError(db.lastError().text());
+
+        try
+        {
+            QSqlQuery query {db};
+            if (!query.prepare(insertArticleStatement))
+                throw RuntimeError(query.lastError().text());
+
+            const QString uid = toUIDString(feedUID);
+            for (const QVariantHash &article : articles)
+            {
+                query.bindValue(DB_COLUMN_FEED_UID.placeholder, uid);
+                query.bindValue(DB_COLUMN_GUID.placeholder, article.value(RSS::Article::KeyId).toString());
+                query.bindValue(DB_COLUMN_DATE.placeholder, toDBValue(article.value(RSS::Article::KeyDate).toDateTime()));
+                query.bindValue(DB_COLUMN_TITLE.placeholder, article.value(RSS::Article::KeyTitle).toString());
+                query.bindValue(DB_COLUMN_AUTHOR.placeholder, article.value(RSS::Article::KeyAuthor).toString());
+                query.bindValue(DB_COLUMN_TORRENT_URL.placeholder, article.value(RSS::Article::KeyTorrentURL).toString());
+                query.bindValue(DB_COLUMN_LINK.placeholder, article.value(RSS::Article::KeyLink).toString());
+                query.bindValue(DB_COLUMN_IS_READ.placeholder, article.value(RSS::Article::KeyIsRead, false).toBool());
+                query.bindValue(DB_COLUMN_DATA.placeholder, serializeData(article));
+                if (!query.exec())
+                    throw RuntimeError(query.lastError().text());
+            }
+
+            if (!db.commit())
+                throw RuntimeError(db.lastError().text());
+        }
+        catch (const RuntimeError &)
+        {
+            db.rollback();
+            throw;
+        }
+    }
+}
+
+namespace RSS::Private
+{
+    class ArticleStorage::Worker final : public QObject
+    {
+        Q_DISABLE_COPY_MOVE(Worker)
+
+    public:
+        Worker(const QString &dbPath, const QString &dbConnectionName);
+
+        void openDatabase() const;
+        void closeDatabase() const;
+
+        bool store(const QUuid &feedUID, const QVector<QVariantHash> &articles) const;
+        void markAsRead(const QUuid &feedUID, const QStringList &guids) const;
+        void remove(const QUuid &feedUID, const QStringList &guids) const;
+        void removeFeed(const QUuid &feedUID) const;
+        void storeCacheInfo(const QUuid &feedUID, const FeedCacheInfo &cacheInfo) const;
+
+    private:
+        const QString m_path;
+        const QString m_connectionName;
+    };
+}
+
+using namespace RSS::Private;
+
+ArticleStorage::ArticleStorage(const QString &dbPath, QObject *parent)
+    : QObject {parent}
+    , m_ioThread {new QThread(this)}
+{
+    bool needCreateDB = !QFile::exists(dbPath);
+
+    auto db = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), DB_CONNECTION_NAME);
+    db.setDatabaseName(dbPath);
+    if (!db.open())
+        throw RuntimeError(db.lastError().text());
+
+    if (!needCreateDB)
+    {
+        QSqlQuery versionQuery {db};
+        const auto selectVersionStatement = QString::fromLatin1("SELECT %1 FROM %2 WHERE %3 = 'version';")
+                .arg(quoted(DB_COLUMN_VALUE.name), quoted(DB_TABLE_META), quoted(DB_COLUMN_NAME.name));
+        if (!versionQuery.exec(selectVersionStatement) || !versionQuery.next())
+            throw RuntimeError(versionQuery.lastError().text());
+
+        const int dbVersion = versionQuery.value(0).toInt();
+        versionQuery.finish();
+        if (dbVersion > DB_VERSION)
+        {
+            // The database was created by a newer version of qBittorrent and its schema
+            // is unknown, so keep it untouched for that version and start a new one
+            db.close();
+
+            const QString backupPath = dbPath + QString::fromLatin1(".v%1.bak").arg(dbVersion);
+            Utils::Fs::forceRemove(backupPath);
+            if (!QFile::rename(dbPath, backupPath))
+                throw RuntimeError(tr("Couldn't move unsupported database to '%1'.").arg(backupPath));
+
+            LogMsg(tr("RSS article storage was created by a newer version of qBittorrent (database version %1)."
+                      " It was moved to '%2' and a new one is created.").arg(QString::number(dbVersion), backupPath)
+                   , Log::WARNING);
+
+            if (!db.open())
+                throw RuntimeError(db.lastError().text());
+            needCreateDB = true;
+        }
+    }
+
+    // Write-ahead logging allows to read articles while
+    // the I/O thread is writing to the database
+    QSqlQuery pragmaQuery {db};
+    if (!pragmaQuery.exec(QLatin1String("PRAGMA journal_mode = WAL;")))
+        throw RuntimeError(pragmaQuery.lastError().text());
+
+    if (needCreateDB)
+        createDB();
+
+    m_asyncWorker = new Worker(dbPath, QLatin1String("RSSArticleStorageWorker"));
+    m_asyncWorker->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_asyncWorker, &QObject::deleteLater);
+    m_ioThread->start();
+
+    RuntimeError *errPtr = nullptr;
+    QMetaObject::invokeMethod(m_asyncWorker, [this, &errPtr]()
+    {
+        try
+        {
+            m_asyncWorker->openDatabase();
+        }
+        catch (const RuntimeError &err)
+        {
+            errPtr = new RuntimeError(err);
+        }
+    }, Qt::BlockingQueuedConnection);
+
+    if (errPtr)
+    {
+        const RuntimeError err = *errPtr;
+        delete errPtr;
+        throw err;
+    }
+}
+
+ArticleStorage::~ArticleStorage()
+{
+    // blocking call ensures that all the pending jobs are finished
+    QMetaObject::invokeMethod(m_asyncWorker, [this]() { m_asyncWorker->closeDatabase(); }
+                              , Qt::BlockingQueuedConnection);
+    QSqlDatabase::removeDatabase(DB_CONNECTION_NAME);
+
+    m_ioThread->quit();
+    m_ioThread->wait();
+}
+
+QVector<QVariantHash> ArticleStorage::loadHeaders(const QUuid &feedUID) const
+{
+    const QString selectArticlesStatement = QString::fromLatin1("SELECT %1, %2, %3, %4, %5, %6, %7 FROM %8 WHERE %9 = %10 ORDER BY %2 DESC;")
+            .arg(quoted(DB_COLUMN_GUID.name), quoted(DB_COLUMN_DATE.name), quoted(DB_COLUMN_TITLE.name)
+                 , quoted(DB_COLUMN_AUTHOR.name), quoted(DB_COLUMN_TORRENT_URL.name), quoted(DB_COLUMN_LINK.name)
+                 , quoted(DB_COLUMN_IS_READ.name), quoted(DB_TABLE_ARTICLES), quoted(DB_COLUMN_FEED_UID.name))
+            .arg(DB_COLUMN_FEED_UID.placeholder);
+
+    auto db = QSqlDatabase::database(DB_CONNECTION_NAME);
+    QSqlQuery query {db};
+    query.setForwardOnly(true);
+
+    try
+    {
+        if (!query.prepare(selectArticlesStatement))
+            throw RuntimeError(query.lastError().text());
+
+        query.bindValue(DB_COLUMN_FEED_UID.placeholder, toUIDString(feedUID));
+        if (!query.exec())
+            throw RuntimeError(query.lastError().text());
+    }
+    catch (const RuntimeError &err)
+    {
+        LogMsg(tr("Couldn't load RSS articles of feed '%1'. Error: %2")
+            .arg(toUIDString(feedUID), err.message()), Log::WARNING);
+        return {};
+    }
+
+    QVector<QVariantHash> headers;
+    while (query.next())
+    {
+        headers.append(QVariantHash {
+            {Article::KeyId, query.value(0)},
+            {Article::KeyDate, fromDBValue(query.value(1))},
+            {Article::KeyTitle, query.value(2)},
+            {Article::KeyAuthor, query.value(3)},
+            {Article::KeyTorrentURL, query.value(4)},
+            {Article::KeyLink, query.value(5)},
+            {Article::KeyIsRead, query.value(6).toBool()}
+        });
+    }
+
+    return headers;
+}
+
+QVariantHash ArticleStorage::loadData(const QUuid &feedUID, const QString &guid) const
+{
+    const QString selectArticleStatement = QString::fromLatin1("SELECT %1, %2, %3 FROM %4 WHERE %5 = %6 AND %7 = %8;")
+            .arg(quoted(DB_COLUMN_DATE.name), quoted(DB_COLUMN_IS_READ.name), quoted(DB_COLUMN_DATA.name)
+                 , quoted(DB_TABLE_ARTICLES), quoted(DB_COLUMN_FEED_UID.name), DB_COLUMN_FEED_UID.placeholder
+                 , quoted(DB_COLUMN_GUID.name), DB_COLUMN_GUID.placeholder);
+
+    auto db = QSqlDatabase::database(DB_CONNECTION_NAME);
+    QSqlQuery query {db};
+
+    try
+    {
+        if (!query.prepare(selectArticleStatement))
+            throw RuntimeError(query.lastError().text());
+
+        query.bindValue(DB_COLUMN_FEED_UID.placeholder, toUIDString(feedUID));
+        query.bindValue(DB_COLUMN_GUID.placeholder, guid);
+        if (!query.exec())
+            throw RuntimeError(query.lastError().text());
+
+        if (!query.next())
+            throw RuntimeError(tr("Not found."));
+    }
+    catch (const RuntimeError &err)
+    {
+        LogMsg(tr("Couldn't load RSS article '%1'. Error: %2").arg(guid, err.message()), Log::WARNING);
+        return {};
+    }
+
+    QVariantHash data = QJsonDocument::fromJson(query.value(2).toByteArray()).object().toVariantHash();
+    data[Article::KeyDate] = fromDBValue(query.value(0));
+    data[Article::KeyIsRead] = query.value(1).toBool();
+    return data;
+}
+
+QHash<QString, QVariantHash> ArticleStorage::loadData(const QUuid &feedUID) const
+{
+    const QString selectArticlesStatement = QString::fromLatin1("SELECT %1, %2, %3, %4 FROM %5 WHERE %6 = %7;")
+            .arg(quoted(DB_COLUMN_GUID.name), quoted(DB_COLUMN_DATE.name), quoted(DB_COLUMN_IS_READ.name)
+                 , quoted(DB_COLUMN_DATA.name), quoted(DB_TABLE_ARTICLES), quoted(DB_COLUMN_FEED_UID.name)
+                 , DB_COLUMN_FEED_UID.placeholder);
+
+    auto db = QSqlDatabase::database(DB_CONNECTION_NAME);
+    QSqlQuery query {db};
+    query.setForwardOnly(true);
+
+    try
+    {
+        if (!query.prepare(selectArticlesStatement))
+            throw RuntimeError(query.lastError().text());
+
+        query.bindValue(DB_COLUMN_FEED_UID.placeholder, toUIDString(feedUID));
+        if (!query.exec())
+            throw RuntimeError(query.lastError().text());
+    }
+    catch (const RuntimeError &err)
+    {
+        LogMsg(tr("Couldn't load RSS articles of feed '%1'. Error: %2")
+            .arg(toUIDString(feedUID), err.message()), Log::WARNING);
+        return {};
+    }
+
+    QHash<QString, QVariantHash> articles;
+    while (query.next())
+    {
+        QVariantHash data = QJsonDocument::fromJson(query.value(3).toByteArray()).object().toVariantHash();
+        data[Article::KeyDate] = fromDBValue(query.value(1));
+        data[Article::KeyIsRead] = query.value(2).toBool();
+        articles.insert(query.value(0).toString(), data);
+    }
+
+    return articles;
+}
+
+bool ArticleStorage::import(const QUuid &feedUID, const QVector<QVariantHash> &articles) const
+{
+    const QString insertFeedStatement = QString::fromLatin1("INSERT INTO %1 (%2) VALUES (%3) ON CONFLICT (%2) DO NOTHING;")
+            .arg(quoted(DB_TABLE_FEEDS), quoted(DB_COLUMN_FEED_UID.name), DB_COLUMN_FEED_UID.placeholder);
+
+    try
+    {
+        auto db = QSqlDatabase::database(DB_CONNECTION_NAME);
+        storeArticles(db, feedUID, articles);
+
+        // The feed record marks the feed as imported
+        QSqlQuery query {db};
+        if (!query.prepare(insertFeedStatement))
+            throw RuntimeError(query.lastError().text());
+
+        query.bindValue(DB_COLUMN_FEED_UID.placeholder, toUIDString(feedUID));
+        if (!query.exec())
+            throw RuntimeError(query.lastError().text());
+    }
+    catch (const RuntimeError &err)
+    {
+        LogMsg(tr("Couldn't store RSS articles of feed '%1'. Error: %2")
+            .arg(toUIDString(feedUID), err.message()), Log::WARNING);
+        return false;
+    }
+
+    return true;
+}
+
+bool ArticleStorage::isImported(const QUuid &feedUID) const
+{
+    const QString selectFeedStatement = QString::fromLatin1("SELECT 1 FROM %1 WHERE %2 = %3;")
+            .arg(quoted(DB_TABLE_FEEDS), quoted(DB_COLUMN_FEED_UID.name), DB_COLUMN_FEED_UID.placeholder);
+
+    auto db = QSqlDatabase::database(DB_CONNECTION_NAME);
+    QSqlQuery query {db};
+
+    if (!query.prepare(selectFeedStatement))
+        return false;
+
+    query.bindValue(DB_COLUMN_FEED_UID.placeholder, toUIDString(feedUID));
+    return (query.exec() && query.next());
+}
+
+void ArticleStorage::store(const QUuid &feedUID, const QVector<QVariantHash> &articles) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, feedUID, articles]()
+    {
+        const bool isStored = m_asyncWorker->store(feedUID, articles);
+
+        QStringList guids;
+        guids.reserve(articles.size());
+        for (const QVariantHash &article : articles)
+            guids.append(article.value(Article::KeyId).toString());
+
+        QMetaObject::invokeMethod(this, [this, feedUID, guids, isStored]()
+        {
+            if (isStored)
+                emit articlesStored(feedUID, guids);
+            else
+                emit articlesStoreFailed(feedUID, guids);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ArticleStorage::markAsRead(const QUuid &feedUID, const QStringList &guids) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, feedUID, guids]()
+    {
+        m_asyncWorker->markAsRead(feedUID, guids);
+    });
+}
+
+void ArticleStorage::remove(const QUuid &feedUID, const QStringList &guids) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, feedUID, guids]()
+    {
+        m_asyncWorker->remove(feedUID, guids);
+    });
+}
+
+void ArticleStorage::removeFeed(const QUuid &feedUID) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, feedUID]()
+    {
+        m_asyncWorker->removeFeed(feedUID);
+    });
+}
+
+void ArticleStorage::createDB() const
+{
+    auto db = QSqlDatabase::database(DB_CONNECTION_NAME);
+
+    if (!db.transaction())
+        throw RuntimeError(db.lastError().text());
+
+    QSqlQuery query {db};
+
+    try
+    {
+        const auto createTableMetaQuery = QString::fromLatin1("CREATE TABLE %1 (%2, %3, %4)")
+                .arg(quoted(DB_TABLE_META)
+                     , makeColumnDefinition(DB_COLUMN_ID, "INTEGER PRIMARY KEY")
+                     , makeColumnDefinition(DB_COLUMN_NAME, "TEXT NOT NULL UNIQUE")
+                     , makeColumnDefinition(DB_COLUMN_VALUE, "BLOB"));
+        if (!query.exec(createTableMetaQuery))
+            throw RuntimeError(query.lastError().text());
+
+        const auto insertMetaVersionQuery = QString::fromLatin1("INSERT INTO %1 (%2, %3) VALUES (%4, %5)")
+                .arg(quoted(DB_TABLE_META), quoted(DB_COLUMN_NAME.name), quoted(DB_COLUMN_VALUE.name)
+                     , DB_COLUMN_NAME.placeholder, DB_COLUMN_VALUE.placeholder);
+        if (!query.prepare(insertMetaVersionQuery))
+            throw RuntimeError(query.lastError().text());
+
+        query.bindValue(DB_COLUMN_NAME.placeholder, QString::fromLatin1("version"));
+        query.bindValue(DB_COLUMN_VALUE.placeholder, DB_VERSION);
+        if (!query.exec())
+            throw RuntimeError(query.lastError().text());
+
+        // UNIQUE constraint creates the index used both for GUID lookup and per feed selection
+        const QStringList tableArticlesItems = {
+            makeColumnDefinition(DB_COLUMN_ID, "INTEGER PRIMARY KEY"),
+            makeColumnDefinition(DB_COLUMN_FEED_UID, "TEXT NOT NULL"),
+            makeColumnDefinition(DB_COLUMN_GUID, "TEXT NOT NULL"),
+            makeColumnDefinition(DB_COLUMN_DATE, "INTEGER"),
+            makeColumnDefinition(DB_COLUMN_TITLE, "TEXT"),
+            makeColumnDefinition(DB_COLUMN_AUTHOR, "TEXT"),
+            makeColumnDefinition(DB_COLUMN_TORRENT_URL, "TEXT"),
+            makeColumnDefinition(DB_COLUMN_LINK, "TEXT"),
+            makeColumnDefinition(DB_COLUMN_IS_READ, "INTEGER NOT NULL DEFAULT 0"),
+            makeColumnDefinition(DB_COLUMN_DATA, "BLOB"),
+            QString::fromLatin1("UNIQUE (%1, %2)").arg(quoted(DB_COLUMN_FEED_UID.name), quoted(DB_COLUMN_GUID.name))
+        };
+        const auto createTableArticlesQuery = QString::fromLatin1("CREATE TABLE %1 (%2)")
+                .arg(quoted(DB_TABLE_ARTICLES), tableArticlesItems.join(QLatin1Char(',')));
+        if (!query.exec(createTableArticlesQuery))
+            throw RuntimeError(query.lastError().text());
+
+        if (!query.exec(makeCreateTableFeedsStatement()))
+            throw RuntimeError(query.lastError().text());
+
+        if (!db.commit())
+            throw RuntimeError(db.lastError().text());
+    }
+    catch (const RuntimeError &)
+    {
+        db.rollback();
+        throw;
+    }
+}
+
+FeedCacheInfo ArticleStorage::loadCacheInfo(const QUuid &feedUID) const
+{
+    const QString selectFeedStatement = QString::fromLatin1("SELECT %1, %2, %3 FROM %4 WHERE %5 = %6;")
+            .arg(quoted(DB_COLUMN_ETAG.name), quoted(DB_COLUMN_LAST_MODIFIED.name), quoted(DB_COLUMN_DATA_HASH.name)
+                 , quoted(DB_TABLE_FEEDS), quoted(DB_COLUMN_FEED_UID.name), DB_COLUMN_FEED_UID.placeholder);
+
+    auto db = QSqlDatabase::database(DB_CONNECTION_NAME);
+    QSqlQuery query {db};
+
+    if (!query.prepare(selectFeedStatement))
+        return {};
+
+    query.bindValue(DB_COLUMN_FEED_UID.placeholder, toUIDString(feedUID));
+    if (!query.exec() || !query.next())
+        return {};
+
+    return {query.value(0).toByteArray(), query.value(1).toByteArray(), query.value(2).toByteArray()};
+}
+
+void ArticleStorage::storeCacheInfo(const QUuid &feedUID, const FeedCacheInfo &cacheInfo) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, feedUID, cacheInfo]()
+    {
+        m_asyncWorker->storeCacheInfo(feedUID, cacheInfo);
+    });
+}
+
+ArticleStorage::Worker::Worker(const QString &dbPath, const QString &dbConnectionName)
+    : m_path {dbPath}
+    , m_connectionName {dbConnectionName}
+{
+}
+
+void ArticleStorage::Worker::openDatabase() const
+{
+    auto db = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), m_connectionName);
+    db.setDatabaseName(m_path);
+    if (!db.open())
+        throw RuntimeError(db.lastError().text());
+}
+
+void ArticleStorage::Worker::closeDatabase() const
+{
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+bool ArticleStorage::Worker::store(const QUuid &feedUID, const QVector<QVariantHash> &articles) const
+{
+    try
+    {
+        storeArticles(QSqlDatabase::database(m_connectionName), feedUID, articles);
+    }
+    catch (const RuntimeError &err)
+    {
+        LogMsg(tr("Couldn't store RSS articles of feed '%1'. Error: %2")
+            .arg(toUIDString(feedUID), err.message()), Log::WARNING);
+        return false;
+    }
+
+    return true;
+}
+
+void ArticleStorage::Worker::markAsRead(const QUuid &feedUID, const QStringList &guids) const
+{
+    const QString updateArticleStatement = QString::fromLatin1("UPDATE %1 SET %2 = 1 WHERE %3 = %4 AND %5 = %6;")
+            .arg(quoted(DB_TABLE_ARTICLES), quoted(DB_COLUMN_IS_READ.name)
+                 , quoted(DB_COLUMN_FEED_UID.name), DB_COLUMN_FEED_UID.placeholder
+                 , quoted(DB_COLUMN_GUID.name), DB_COLUMN_GUID.placeholder);
+
+    auto db = QSqlDatabase::database(m_connectionName);
+
+    try
+    {
+        if (!db.transaction())
+            throw RuntimeError(db.lastError().text());
+
+        QSqlQuery query {db};
+
+        try
+        {
+            if (!query.prepare(updateArticleStatement))
+                throw RuntimeError(query.lastError().text());
+
+            const QString uid = toUIDString(feedUID);
+            for (const QString &guid : guids)
+            {
+                query.bindValue(DB_COLUMN_FEED_UID.placeholder, uid);
+                query.bindValue(DB_COLUMN_GUID.placeholder, guid);
+                if (!query.exec())
+                    throw RuntimeError(query.lastError().text());
+            }
+
+            if (!db.commit())
+                throw RuntimeError(db.lastError().text());
+        }
+        catch (const RuntimeError &)
+        {
+            db.rollback();
+            throw;
+        }
+    }
+    catch (const RuntimeError &err)
+    {
+        LogMsg(tr("Couldn't store RSS articles of feed '%1'. Error: %2")
+            .arg(toUIDString(feedUID), err.message()), Log::WARNING);
+    }
+}
+
+void ArticleStorage::Worker::remove(const QUuid &feedUID, const QStringList &guids) const
+{
+    const QString deleteArticleStatement = QString::fromLatin1("DELETE FROM %1 WHERE %2 = %3 AND %4 = %5;")
+            .arg(quoted(DB_TABLE_ARTICLES), quoted(DB_COLUMN_FEED_UID.name), DB_COLUMN_FEED_UID.placeholder
+                 , quoted(DB_COLUMN_GUID.name), DB_COLUMN_GUID.placeholder);
+
+    auto db = QSqlDatabase::database(m_connectionName);
+
+    try
+    {
+        if (!db.transaction())
+            throw RuntimeError(db.lastError().text());
+
+        QSqlQuery query {db};
+
+        try
+        {
+            if (!query.prepare(deleteArticleStatement))
+                throw RuntimeError(query.lastError().text());
+
+            const QString uid = toUIDString(feedUID);
+            for (const QString &guid : guids)
+            {
+                query.bindValue(DB_COLUMN_FEED_UID.placeholder, uid);
+                query.bindValue(DB_COLUMN_GUID.placeholder, guid);
+                if (!query.exec())
+                    throw RuntimeError(query.lastError().text());
+            }
+
+            if (!db.commit())
+                throw RuntimeError(db.lastError().text());
+        }
+        catch (const RuntimeError &)
+        {
+            db.rollback();
+            throw;
+        }
+    }
+    catch (const RuntimeError &err)
+    {
+        LogMsg(tr("Couldn't delete RSS articles of feed '%1'. Error: %2")
+            .arg(toUIDString(feedUID), err.message()), Log::WARNING);
+    }
+}
+
+void ArticleStorage::Worker::removeFeed(const QUuid &feedUID) const
+{
+    auto db = QSqlDatabase::database(m_connectionName);
+
+    try
+    {
+        if (!db.transaction())
+            throw RuntimeError(db.lastError().text());
+
+        QSqlQuery query {db};
+
+        try
+        {
+            for (const char *tableName : {DB_TABLE_ARTICLES, DB_TABLE_FEEDS})
+            {
+                const QString deleteFeedStatement = QString::fromLatin1("DELETE FROM %1 WHERE %2 = %3;")
+                        .arg(quoted(QLatin1String(tableName)), quoted(DB_COLUMN_FEED_UID.name), DB_COLUMN_FEED_UID.placeholder);
+                if (!query.prepare(deleteFeedStatement))
+                    throw RuntimeError(query.lastError().text());
+
+                query.bindValue(DB_COLUMN_FEED_UID.placeholder, toUIDString(feedUID));
+                if (!query.exec())
+                    throw RuntimeError(query.lastError().text());
+            }
+
+            if (!db.commit())
+                throw RuntimeError(db.lastError().text());
+        }
+        catch (const RuntimeError &)
+        {
+            db.rollback();
+            throw;
+        }
+    }
+    catch (const RuntimeError &err)
+    {
+        LogMsg(tr("Couldn't delete RSS articles of feed '%1'. Error: %2")
+            .arg(toUIDString(feedUID), err.message()), Log::WARNING);
+    }
+}
+
+void ArticleStorage::Worker::storeCacheInfo(const QUuid &feedUID, const FeedCacheInfo &cacheInfo) const
+{
+    const QString insertFeedStatement = QString::fromLatin1(
+                "INSERT INTO %1 (%2, %3, %4, %5) VALUES (%6, %7, %8, %9)"
+                " ON CONFLICT (%2) DO UPDATE SET (%3, %4, %5) = (%7, %8, %9)")
+            .arg(quoted(DB_TABLE_FEEDS), quoted(DB_COLUMN_FEED_UID.name), quoted(DB_COLUMN_ETAG.name)
+                 , quoted(DB_COLUMN_LAST_MODIFIED.name), quoted(DB_COLUMN_DATA_HASH.name)
+                 , DB_COLUMN_FEED_UID.placeholder, DB_COLUMN_ETAG.placeholder
+                 , DB_COLUMN_LAST_MODIFIED.placeholder, DB_COLUMN_DATA_HASH.placeholder);
+
+    auto db = QSqlDatabase::database(m_connectionName);
+    QSqlQuery query {db};
+
+    try
+    {
+        if (!query.prepare(insertFeedStatement))
+            throw RuntimeError(query.lastError().text());
+
+        query.bindValue(DB_COLUMN_FEED_UID.placeholder, toUIDString(feedUID));
+        query.bindValue(DB_COLUMN_ETAG.placeholder, cacheInfo.eTag);
+        query.bindValue(DB_COLUMN_LAST_MODIFIED.placeholder, cacheInfo.lastModified);
+        query.bindValue(DB_COLUMN_DATA_HASH.placeholder, cacheInfo.dataHash);
+        if (!query.exec())
+            throw RuntimeError(query.lastError().text());
+    }
+    catch (const RuntimeError &err)
+    {
+        LogMsg(tr("Couldn't store RSS feed state '%1'. Error: %2")
+            .arg(toUIDString(feedUID), err.message()), Log::WARNING);
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QStringList>
+#include <QtContainerFwd>
+#include <QVariantHash>
+
+class QThread;
+class QUuid;
+
+namespace RSS
+{
+    namespace Private
+    {
+        // HTTP cache validators and the hash of the last successfully parsed
+        // feed content, used to avoid downloading and parsing unchanged feeds
+        struct FeedCacheInfo
+        {
+            QByteArray eTag;
+            QByteArray lastModified;
+            QByteArray dataHash;
+        };
+
+        // Keeps the articles of all feeds in a single SQLite database.
+        // Articles are indexed by (feed UID, GUID) so that a feed can load
+        // only lightweight article headers at startup and fetch the full
+        // article data (e.g. description) on demand. Modifications are
+        // applied incrementally on a dedicated I/O thread.
+        class ArticleStorage final : public QObject
+        {
+            Q_OBJECT
+            Q_DISABLE_COPY_MOVE(ArticleStorage)
+
+        public:
+            explicit ArticleStorage(const QString &dbPath, QObject *parent = nullptr);
+            ~ArticleStorage() override;
+
+            // Returns the headers (all the article fields except the bulky ones
+            // like description) of the feed articles in reverse chronological order
+            QVector<QVariantHash> loadHeaders(const QUuid &feedUID) const;
+            QVariantHash loadData(const QUuid &feedUID, const QString &guid) const;
+            // Returns the data of all the feed articles mapped by GUID
+            QHash<QString, QVariantHash> loadData(const QUuid &feedUID) const;
+            // Synchronously stores the articles, e.g. when migrating from the legacy format,
+            // and marks the feed as imported
+            bool import(const QUuid &feedUID, const QVector<QVariantHash> &articles) const;
+            bool isImported(const QUuid &feedUID) const;
+
+            void store(const QUuid &feedUID, const QVector<QVariantHash> &articles) const;
+            void markAsRead(const QUuid &feedUID, const QStringList &guids) const;
+            void remove(const QUuid &feedUID, const QStringList &guids) const;
+            void removeFeed(const QUuid &feedUID) const;
+
+            FeedCacheInfo loadCacheInfo(const QUuid &feedUID) const;
+            void storeCacheInfo(const QUuid &feedUID, const FeedCacheInfo &cacheInfo) const;
+
+        signals:
+            void articlesStored(const QUuid &feedUID, const QStringList &guids);
+            void articlesStoreFailed(const QUuid &feedUID, const QStringList &guids);
+
+        private:
+            void createDB() const;
+
+            QThread *m_ioThread = nullptr;
+
+            class Worker;
+            Worker *m_asyncWorker = nullptr;
+        };
+    }
+}
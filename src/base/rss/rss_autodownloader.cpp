@@ -30,6 +30,7 @@
 
 #include <QDataStream>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
@@ -59,6 +60,10 @@ struct ProcessingJob
     QVariantHash articleData;
 };
 
+// Jobs are processed in batches, each of them can take up to this time (ms)
+// so that the event loop isn't blocked while the backlog is being processed
+const int ProcessingBatchDuration = 50;
+
 const QString ConfFolderName(QStringLiteral("rss"));
 const QString RulesFileName(QStringLiteral("download_rules.json"));
 
@@ -204,6 +209,7 @@ bool AutoDownloader::renameRule(const QString &ruleName, const QString &newRuleN
     AutoDownloadRule rule = m_rules.take(ruleName);
     rule.setName(newRuleName);
     m_rules.insert(newRuleName, rule);
+    invalidateRulesIndex();
     m_dirty = true;
     store();
     emit ruleRenamed(newRuleName, ruleName);
@@ -216,6 +222,7 @@ void AutoDownloader::removeRule(const QString &ruleName)
     {
         emit ruleAboutToBeRemoved(ruleName);
         m_rules.remove(ruleName);
+        invalidateRulesIndex();
         m_dirty = true;
         store();
     }
@@ -333,7 +340,16 @@ void AutoDownloader::process()
 {
     if (m_processingQueue.isEmpty()) return; // processing was disabled
 
-    processJob(m_processingQueue.takeFirst());
+    updateRulesIndex();
+
+    QElapsedTimer timer;
+    timer.start();
+    do
+    {
+        processJob(m_processingQueue.takeFirst());
+    }
+    while (!m_processingQueue.isEmpty() && !timer.hasExpired(ProcessingBatchDuration));
+
     if (!m_processingQueue.isEmpty())
         // Schedule to process the next torrent (if any)
         m_processingTimer->start();
@@ -364,6 +380,28 @@ void AutoDownloader::handleNewArticle(const Article *article)
 void AutoDownloader::setRule_impl(const AutoDownloadRule &rule)
 {
     m_rules.insert(rule.name(), rule);
+    invalidateRulesIndex();
+}
+
+void AutoDownloader::invalidateRulesIndex()
+{
+    m_rulesByFeedURL.clear();
+    m_isRulesIndexValid = false;
+}
+
+void AutoDownloader::updateRulesIndex()
+{
+    if (m_isRulesIndexValid) return;
+
+    for (const AutoDownloadRule &rule : asConst(m_rules))
+    {
+        if (!rule.isEnabled()) continue;
+
+        for (const QString &feedURL : asConst(rule.feedURLs()))
+            m_rulesByFeedURL[feedURL].append(rule.name());
+    }
+
+    m_isRulesIndexValid = true;
 }
 
 void AutoDownloader::addJobForArticle(const Article *article)
@@ -373,7 +411,7 @@ void AutoDownloader::addJobForArticle(const Article *article)
 
     QSharedPointer<ProcessingJob> job(new ProcessingJob);
     job->feedURL = article->feed()->url();
-    job->articleData = article->data();
+    job->articleData = article->header();
     m_processingQueue.append(job);
     if (!m_processingTimer->isActive())
         m_processingTimer->start();
@@ -381,10 +419,11 @@ void AutoDownloader::addJobForArticle(const Article *article)
 
 void AutoDownloader::processJob(const QSharedPointer<ProcessingJob> &job)
 {
-    for (AutoDownloadRule &rule : m_rules)
+    Q_ASSERT(m_isRulesIndexValid);
+
+    for (const QString &ruleName : asConst(m_rulesByFeedURL.value(job->feedURL)))
     {
-        if (!rule.isEnabled()) continue;
-        if (!rule.feedURLs().contains(job->feedURL)) continue;
+        AutoDownloadRule &rule = m_rules[ruleName];
         if (!rule.accepts(job->articleData)) continue;
 
         m_dirty = true;
@@ -35,6 +35,7 @@
 #include <QPointer>
 #include <QRegularExpression>
 #include <QSharedPointer>
+#include <QStringList>
 
 #include "base/exceptions.h"
 
@@ -115,6 +116,8 @@ namespace RSS
     private:
         void timerEvent(QTimerEvent *event) override;
         void setRule_impl(const AutoDownloadRule &rule);
+        void invalidateRulesIndex();
+        void updateRulesIndex();
         void resetProcessingQueue();
         void startProcessing();
         void addJobForArticle(const Article *article);
@@ -136,6 +139,9 @@ namespace RSS
         QThread *m_ioThread;
         AsyncFileStorage *m_fileStorage;
         QHash<QString, AutoDownloadRule> m_rules;
+        // feed URL -> names of the enabled rules affecting it
+        QHash<QString, QStringList> m_rulesByFeedURL;
+        bool m_isRulesIndexValid = false;
         QList<QSharedPointer<ProcessingJob>> m_processingQueue;
         QHash<QString, QSharedPointer<ProcessingJob>> m_waitingJobs;
         bool m_dirty = false;
@@ -39,6 +39,7 @@
 #include <QSharedData>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include "base/global.h"
 #include "base/preferences.h"
@@ -98,6 +99,54 @@ namespace
             return {};
         return Utils::String::fromEnum(*contentLayout);
     }
+
+    // All the regexes of the group must match. Empty group matches anything.
+    using RegexGroup = QVector<QRegularExpression>;
+
+    QRegularExpression compileRegex(const QString &pattern)
+    {
+        QRegularExpression regex {pattern, QRegularExpression::CaseInsensitiveOption};
+        regex.optimize();
+        return regex;
+    }
+
+    QVector<RegexGroup> compileExpressions(const QStringList &expressions, const bool isRegex)
+    {
+        // Each expression is either a regex, or a set of wildcards separated by whitespace.
+        // Only match if every wildcard token is present in the article name.
+        // Order of wildcard tokens is unimportant (if order is important, they should have used *).
+        const QRegularExpression whitespace {"\\s+"};
+
+        QVector<RegexGroup> groups;
+        groups.reserve(expressions.size());
+        for (const QString &expression : expressions)
+        {
+            RegexGroup group;
+            if (isRegex)
+            {
+                // A regex of the form "expr|" will always match, so do the same for wildcards
+                if (!expression.isEmpty())
+                    group.append(compileRegex(expression));
+            }
+            else
+            {
+                for (const QString &wildcard : asConst(expression.split(whitespace, Qt::SkipEmptyParts)))
+                    group.append(compileRegex(Utils::String::wildcardToRegexPattern(wildcard)));
+            }
+
+            groups.append(group);
+        }
+
+        return groups;
+    }
+
+    bool matchesGroup(const RegexGroup &group, const QString &articleTitle)
+    {
+        return std::all_of(group.cbegin(), group.cend(), [&articleTitle](const QRegularExpression &regex)
+        {
+            return regex.match(articleTitle).hasMatch();
+        });
+    }
 }
 
 const QString Str_Name(QStringLiteral("name"));
@@ -142,6 +191,10 @@ namespace RSS
 
         mutable QStringList lastComputedEpisodes;
         mutable QHash<QString, QRegularExpression> cachedRegexes;
+        // "must contain" and "must not contain" expressions compiled on first use
+        mutable bool isCompiled = false;
+        mutable QVector<RegexGroup> mustContainRegexes;
+        mutable QVector<RegexGroup> mustNotContainRegexes;
 
         bool operator==(const AutoDownloadRuleData &other) const
         {
@@ -220,33 +273,15 @@ QRegularExpression AutoDownloadRule::cachedRegex(const QString &expression, cons
     return regex;
 }
 
-bool AutoDownloadRule::matchesExpression(const QString &articleTitle, const QString &expression) const
+void AutoDownloadRule::compileExpressions() const
 {
-    const QRegularExpression whitespace {"\\s+"};
+    // The compiled expressions are reset whenever the regex/wildcard, must or must not contain fields are modified.
+    if (m_dataPtr->isCompiled)
+        return;
 
-    if (expression.isEmpty())
-    {
-        // A regex of the form "expr|" will always match, so do the same for wildcards
-        return true;
-    }
-
-    if (m_dataPtr->useRegex)
-    {
-        const QRegularExpression reg(cachedRegex(expression));
-        return reg.match(articleTitle).hasMatch();
-    }
-
-    // Only match if every wildcard token (separated by spaces) is present in the article name.
-    // Order of wildcard tokens is unimportant (if order is important, they should have used *).
-    const QStringList wildcards {expression.split(whitespace, Qt::SkipEmptyParts)};
-    for (const QString &wildcard : wildcards)
-    {
-        const QRegularExpression reg {cachedRegex(wildcard, false)};
-        if (!reg.match(articleTitle).hasMatch())
-            return false;
-    }
-
-    return true;
+    m_dataPtr->mustContainRegexes = ::compileExpressions(m_dataPtr->mustContain, m_dataPtr->useRegex);
+    m_dataPtr->mustNotContainRegexes = ::compileExpressions(m_dataPtr->mustNotContain, m_dataPtr->useRegex);
+    m_dataPtr->isCompiled = true;
 }
 
 bool AutoDownloadRule::matchesMustContainExpression(const QString &articleTitle) const
@@ -254,12 +289,13 @@ bool AutoDownloadRule::matchesMustContainExpression(const QString &articleTitle)
     if (m_dataPtr->mustContain.empty())
         return true;
 
-    // Each expression is either a regex, or a set of wildcards separated by whitespace.
+    compileExpressions();
+
     // Accept if any complete expression matches.
-    return std::any_of(m_dataPtr->mustContain.cbegin(), m_dataPtr->mustContain.cend(), [this, &articleTitle](const QString &expression)
+    const QVector<RegexGroup> &groups = m_dataPtr->mustContainRegexes;
+    return std::any_of(groups.cbegin(), groups.cend(), [&articleTitle](const RegexGroup &group)
     {
-        // A regex of the form "expr|" will always match, so do the same for wildcards
-        return matchesExpression(articleTitle, expression);
+        return matchesGroup(group, articleTitle);
     });
 }
 
@@ -268,12 +304,13 @@ bool AutoDownloadRule::matchesMustNotContainExpression(const QString &articleTit
     if (m_dataPtr->mustNotContain.empty())
         return true;
 
-    // Each expression is either a regex, or a set of wildcards separated by whitespace.
+    compileExpressions();
+
     // Reject if any complete expression matches.
-    return std::none_of(m_dataPtr->mustNotContain.cbegin(), m_dataPtr->mustNotContain.cend(), [this, &articleTitle](const QString &expression)
+    const QVector<RegexGroup> &groups = m_dataPtr->mustNotContainRegexes;
+    return std::none_of(groups.cbegin(), groups.cend(), [&articleTitle](const RegexGroup &group)
     {
-        // A regex of the form "expr|" will always match, so do the same for wildcards
-        return matchesExpression(articleTitle, expression);
+        return matchesGroup(group, articleTitle);
     });
 }
 
@@ -579,6 +616,7 @@ AutoDownloadRule AutoDownloadRule::fromLegacyDict(const QVariantHash &dict)
 void AutoDownloadRule::setMustContain(const QString &tokens)
 {
     m_dataPtr->cachedRegexes.clear();
+    m_dataPtr->isCompiled = false;
 
     if (m_dataPtr->useRegex)
         m_dataPtr->mustContain = QStringList() << tokens;
@@ -593,6 +631,7 @@ void AutoDownloadRule::setMustContain(const QString &tokens)
 void AutoDownloadRule::setMustNotContain(const QString &tokens)
 {
     m_dataPtr->cachedRegexes.clear();
+    m_dataPtr->isCompiled = false;
 
     if (m_dataPtr->useRegex)
         m_dataPtr->mustNotContain = QStringList() << tokens;
@@ -723,6 +762,7 @@ void AutoDownloadRule::setUseRegex(const bool enabled)
 {
     m_dataPtr->useRegex = enabled;
     m_dataPtr->cachedRegexes.clear();
+    m_dataPtr->isCompiled = false;
 }
 
 QStringList AutoDownloadRule::previouslyMatchedEpisodes() const
@@ -86,6 +86,7 @@ namespace RSS
         QString assignedCategory() const;
         void setCategory(const QString &category);
 
+        // Only the article header (date and title) is used, see Article::header()
         bool matches(const QVariantHash &articleData) const;
         bool accepts(const QVariantHash &articleData);
 
@@ -104,7 +105,7 @@ namespace RSS
         bool matchesMustNotContainExpression(const QString &articleTitle) const;
         bool matchesEpisodeFilterExpression(const QString &articleTitle) const;
         bool matchesSmartEpisodeFilter(const QString &articleTitle) const;
-        bool matchesExpression(const QString &articleTitle, const QString &expression) const;
+        void compileExpressions() const;
         QRegularExpression cachedRegex(const QString &expression, bool isRegex = true) const;
 
         QSharedDataPointer<AutoDownloadRuleData> m_dataPtr;
@@ -31,13 +31,16 @@
 #include "rss_feed.h"
 
 #include <algorithm>
+#include <utility>
 #include <vector>
 
+#include <QCryptographicHash>
 #include <QDir>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
+#include <QThreadPool>
 #include <QUrl>
 
 #include "base/asyncfilestorage.h"
@@ -47,6 +50,7 @@
 #include "base/profile.h"
 #include "base/utils/fs.h"
 #include "rss_article.h"
+#include "rss_articlestorage.h"
 #include "rss_parser.h"
 #include "rss_session.h"
 
@@ -79,11 +83,6 @@ Feed::Feed(const QUuid &uid, const QString &url, const QString &path, Session *s
 
     m_iconPath = Utils::Fs::toUniformPath(storageDir.absoluteFilePath(uidHex + QLatin1String(".ico")));
 
-    m_parser = new Private::Parser(m_lastBuildDate);
-    m_parser->moveToThread(m_session->workingThread());
-    connect(this, &Feed::destroyed, m_parser, &Private::Parser::deleteLater);
-    connect(m_parser, &Private::Parser::finished, this, &Feed::handleParsingFinished);
-
     connect(m_session, &Session::maxArticlesPerFeedChanged, this, &Feed::handleMaxArticlesPerFeedChanged);
 
     if (m_session->isProcessingEnabled())
@@ -98,6 +97,7 @@ Feed::Feed(const QUuid &uid, const QString &url, const QString &path, Session *s
 
 Feed::~Feed()
 {
+    cancelParsing();
     emit aboutToBeDestroyed(this);
 }
 
@@ -115,6 +115,7 @@ void Feed::markAsRead()
         {
             article->disconnect(this);
             article->markAsRead();
+            m_readArticles.insert(article->guid());
             --m_unreadCount;
             emit articleRead(article);
         }
@@ -135,7 +136,15 @@ void Feed::refresh()
 
     // NOTE: Should we allow manually refreshing for disabled session?
 
-    m_downloadHandler = Net::DownloadManager::instance()->download(m_url);
+    // Use conditional request so the server can reply with "304 Not Modified"
+    // instead of sending the whole feed again
+    Net::DownloadRequest request {m_url};
+    if (!m_cacheInfo.eTag.isEmpty())
+        request.rawHeader("If-None-Match", m_cacheInfo.eTag);
+    if (!m_cacheInfo.lastModified.isEmpty())
+        request.rawHeader("If-Modified-Since", m_cacheInfo.lastModified);
+
+    m_downloadHandler = Net::DownloadManager::instance()->download(request);
     connect(m_downloadHandler, &Net::DownloadHandler::finished, this, &Feed::handleDownloadFinished);
 
     if (!QFile::exists(m_iconPath))
@@ -182,9 +191,14 @@ Article *Feed::articleByGUID(const QString &guid) const
 
 void Feed::handleMaxArticlesPerFeedChanged(const int n)
 {
+    if (m_articlesByDate.size() <= n)
+        return;
+
     while (m_articlesByDate.size() > n)
         removeOldestArticle();
-    // We don't need store articles here
+
+    m_dirty = true;
+    storeDeferred();
 }
 
 void Feed::handleIconDownloadFinished(const Net::DownloadResult &result)
@@ -204,12 +218,46 @@ void Feed::handleDownloadFinished(const Net::DownloadResult &result)
 {
     m_downloadHandler = nullptr; // will be deleted by DownloadManager later
 
-    if (result.status == Net::DownloadStatus::Success)
+    if (result.status == Net::DownloadStatus::NotModified)
+    {
+        LogMsg(tr("RSS feed at '%1' is not modified since last update.").arg(result.url));
+        m_hasError = false;
+        if (!m_parser)
+        {
+            m_isLoading = false;
+            emit stateChanged(this);
+        }
+    }
+    else if (result.status == Net::DownloadStatus::Success)
     {
+        const Private::FeedCacheInfo cacheInfo {result.eTag, result.lastModified
+                , QCryptographicHash::hash(result.data, QCryptographicHash::Sha1)};
+
+        if (m_parser)
+        {
+            // parse it once the current job is finished, only the most recent data is kept
+            m_queuedFeedData = result.data;
+            m_queuedCacheInfo = cacheInfo;
+            return;
+        }
+
+        m_pendingCacheInfo = cacheInfo;
+
+        // Some servers don't support conditional requests so we also
+        // compare the content itself to avoid parsing the same data again
+        if (!m_hasError && (m_pendingCacheInfo.dataHash == m_cacheInfo.dataHash))
+        {
+            LogMsg(tr("RSS feed at '%1' is not modified since last update.").arg(result.url));
+            updateCacheInfo();
+            m_isLoading = false;
+            emit stateChanged(this);
+            return;
+        }
+
         LogMsg(tr("RSS feed at '%1' is successfully downloaded. Starting to parse it.")
                 .arg(result.url));
         // Parse the download RSS
-        m_parser->parse(result.data);
+        parse(result.data);
     }
     else
     {
@@ -247,6 +295,9 @@ void Feed::handleParsingFinished(const RSS::Private::ParsingResult &result)
     const int newArticlesCount = updateArticles(result.articles);
     store();
 
+    if (!m_hasError)
+        updateCacheInfo();
+
     if (m_hasError)
     {
         LogMsg(tr("Failed to parse RSS feed at '%1'. Reason: %2").arg(m_url, result.error)
@@ -255,31 +306,101 @@ void Feed::handleParsingFinished(const RSS::Private::ParsingResult &result)
     LogMsg(tr("RSS feed at '%1' updated. Added %2 new articles.")
            .arg(url(), QString::number(newArticlesCount)));
 
+    m_parser = nullptr;
+    if (!m_queuedFeedData.isEmpty())
+    {
+        m_pendingCacheInfo = m_queuedCacheInfo;
+        parse(std::exchange(m_queuedFeedData, {}));
+        return;
+    }
+
     m_isLoading = false;
     emit stateChanged(this);
 }
 
+void Feed::parse(const QByteArray &feedData)
+{
+    Q_ASSERT(!m_parser);
+
+    m_parser = new Private::Parser(m_lastBuildDate, feedData);
+    connect(m_parser, &Private::Parser::finished, this, &Feed::handleParsingFinished);
+    m_session->parsingThreadPool()->start(m_parser);
+}
+
+void Feed::cancelParsing()
+{
+    // Parser deletes itself once it is run, so the one that
+    // is still queued has to be taken back and deleted here
+    if (m_parser && m_session->parsingThreadPool()->tryTake(m_parser))
+        delete m_parser;
+
+    m_parser = nullptr;
+    m_queuedFeedData.clear();
+}
+
 void Feed::load()
 {
     QFile file(m_session->dataFileStorage()->storageDir().absoluteFilePath(m_dataFileName));
 
-    if (!file.exists())
+    if (file.exists())
+    {
+        // Articles are stored in the legacy per-feed JSON file (before v4.4.0)
+        if (file.open(QFile::ReadOnly))
+        {
+            loadArticles(file.readAll());
+            file.close();
+            importArticles();
+        }
+        else
+        {
+            LogMsg(tr("Couldn't read RSS Session data from %1. Error: %2")
+                   .arg(m_dataFileName, file.errorString())
+                   , Log::WARNING);
+        }
+        return;
+    }
+
+    m_cacheInfo = m_session->articleStorage()->loadCacheInfo(m_uid);
+
+    if (!m_session->articleStorage()->isImported(m_uid))
     {
+        // Articles may still be stored in the legacy settings (before v4.1.0).
+        // The feed is marked as imported even if it has no articles there,
+        // so the legacy settings aren't read again on every startup.
         loadArticlesLegacy();
-        m_dirty = true;
-        store(); // convert to new format
+        importArticles();
+        return;
     }
-    else if (file.open(QFile::ReadOnly))
+
+    const QVector<QVariantHash> headers = m_session->articleStorage()->loadHeaders(m_uid);
+    for (const QVariantHash &header : headers)
     {
-        loadArticles(file.readAll());
-        file.close();
+        auto article = new Article(this, header, false);
+        if (!addArticle(article))
+        {
+            // stored articles exceed the current limit
+            m_removedArticles.insert(article->guid());
+            delete article;
+        }
     }
-    else
+
+    // Only the articles trimmed to the current limit need to be written
+    m_dirty = !m_removedArticles.isEmpty();
+    if (m_dirty)
+        storeDeferred();
+}
+
+void Feed::updateCacheInfo()
+{
+    if ((m_pendingCacheInfo.eTag == m_cacheInfo.eTag)
+            && (m_pendingCacheInfo.lastModified == m_cacheInfo.lastModified)
+            && (m_pendingCacheInfo.dataHash == m_cacheInfo.dataHash))
     {
-        LogMsg(tr("Couldn't read RSS Session data from %1. Error: %2")
-               .arg(m_dataFileName, file.errorString())
-               , Log::WARNING);
+        return;
     }
+
+    m_cacheInfo = m_pendingCacheInfo;
+    m_session->articleStorage()->storeCacheInfo(m_uid, m_cacheInfo);
 }
 
 void Feed::loadArticles(const QByteArray &data)
@@ -343,6 +464,32 @@ void Feed::loadArticlesLegacy()
     }
 }
 
+void Feed::importArticles()
+{
+    QVector<QVariantHash> articlesData;
+    articlesData.reserve(m_articlesByDate.size());
+    for (const Article *article : asConst(m_articlesByDate))
+        articlesData.append(article->data());
+
+    if (!m_session->articleStorage()->import(m_uid, articlesData))
+        return;
+
+    for (Article *article : asConst(m_articlesByDate))
+        article->unloadData();
+
+    Utils::Fs::forceRemove(m_session->dataFileStorage()->storageDir().absoluteFilePath(m_dataFileName));
+}
+
+QVariantHash Feed::loadArticleData(const QString &guid) const
+{
+    return m_session->articleStorage()->loadData(m_uid, guid);
+}
+
+QHash<QString, QVariantHash> Feed::loadArticlesData() const
+{
+    return m_session->articleStorage()->loadData(m_uid);
+}
+
 void Feed::store()
 {
     if (!m_dirty) return;
@@ -350,11 +497,31 @@ void Feed::store()
     m_dirty = false;
     m_savingTimer.stop();
 
-    QJsonArray jsonArr;
-    for (Article *article :asConst(m_articles))
-        jsonArr << article->toJsonObject();
+    // Only the changes are written, the storage is updated in place
+    const Private::ArticleStorage *storage = m_session->articleStorage();
 
-    m_session->dataFileStorage()->store(m_dataFileName, QJsonDocument(jsonArr).toJson());
+    if (!m_removedArticles.isEmpty())
+    {
+        storage->remove(m_uid, m_removedArticles.values());
+        m_removedArticles.clear();
+    }
+
+    if (!m_newArticles.isEmpty())
+    {
+        QVector<QVariantHash> articlesData;
+        articlesData.reserve(m_newArticles.size());
+        for (const QString &guid : asConst(m_newArticles))
+            articlesData.append(m_articles.value(guid)->data());
+
+        storage->store(m_uid, articlesData);
+        m_newArticles.clear();
+    }
+
+    if (!m_readArticles.isEmpty())
+    {
+        storage->markAsRead(m_uid, m_readArticles.values());
+        m_readArticles.clear();
+    }
 }
 
 void Feed::storeDeferred()
@@ -397,8 +564,12 @@ void Feed::removeOldestArticle()
     auto oldestArticle = m_articlesByDate.last();
     emit articleAboutToBeRemoved(oldestArticle);
 
-    m_articles.remove(oldestArticle->guid());
+    const QString guid = oldestArticle->guid();
+    m_articles.remove(guid);
     m_articlesByDate.removeLast();
+    m_readArticles.remove(guid);
+    if (!m_newArticles.remove(guid))
+        m_removedArticles.insert(guid);
     const bool isRead = oldestArticle->isRead();
     delete oldestArticle;
 
@@ -491,7 +662,9 @@ int Feed::updateArticles(const QList<QVariantHash> &loadedArticles)
     {
         if (a.second)
         {
-            addArticle(new Article {this, *a.second});
+            auto article = new Article {this, *a.second};
+            m_newArticles.insert(article->guid());
+            addArticle(article);
             ++newArticlesCount;
         }
     });
@@ -517,9 +690,16 @@ QJsonValue Feed::toJsonValue(const bool withData) const
         jsonObj.insert(KEY_ISLOADING, isLoading());
         jsonObj.insert(KEY_HASERROR, hasError());
 
+        // Load the data of all the stored articles with a single query
+        // instead of querying the storage once per article
+        const bool hasUnloadedArticles = std::any_of(m_articles.cbegin(), m_articles.cend()
+            , [](const Article *article) { return !article->m_isDataLoaded; });
+        const QHash<QString, QVariantHash> storedData = hasUnloadedArticles
+            ? loadArticlesData() : QHash<QString, QVariantHash>();
+
         QJsonArray jsonArr;
         for (Article *article : asConst(m_articles))
-            jsonArr << article->toJsonObject();
+            jsonArr << article->toJsonObject(article->data(storedData));
         jsonObj.insert(KEY_ARTICLES, jsonArr);
     }
 
@@ -542,12 +722,41 @@ void Feed::handleArticleRead(Article *article)
     decreaseUnreadCount();
     emit articleRead(article);
     // will be stored deferred
+    m_readArticles.insert(article->guid());
+    m_dirty = true;
+    storeDeferred();
+}
+
+void Feed::handleArticlesStored(const QStringList &guids)
+{
+    // Stored articles can be loaded on demand so we don't need to keep their data anymore
+    for (const QString &guid : guids)
+    {
+        Article *article = m_articles.value(guid);
+        if (article && !m_newArticles.contains(guid))
+            article->unloadData();
+    }
+}
+
+void Feed::handleArticlesStoreFailed(const QStringList &guids)
+{
+    // The article data is kept until it is stored, so the articles can be written again
+    for (const QString &guid : guids)
+    {
+        if (m_articles.contains(guid))
+            m_newArticles.insert(guid);
+    }
+
     m_dirty = true;
     storeDeferred();
 }
 
 void Feed::cleanup()
 {
+    m_newArticles.clear();
+    m_readArticles.clear();
+    m_removedArticles.clear();
+    m_session->articleStorage()->removeFeed(m_uid);
     Utils::Fs::forceRemove(m_session->dataFileStorage()->storageDir().absoluteFilePath(m_dataFileName));
     Utils::Fs::forceRemove(m_iconPath);
 }
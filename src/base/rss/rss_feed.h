@@ -33,8 +33,10 @@
 #include <QBasicTimer>
 #include <QHash>
 #include <QList>
+#include <QSet>
 #include <QUuid>
 
+#include "rss_articlestorage.h"
 #include "rss_item.h"
 
 class AsyncFileStorage;
@@ -61,6 +63,7 @@ namespace RSS
         Q_OBJECT
         Q_DISABLE_COPY_MOVE(Feed)
 
+        friend class Article;
         friend class Session;
 
         Feed(const QUuid &uid, const QString &url, const QString &path, Session *session);
@@ -102,6 +105,10 @@ namespace RSS
         void load();
         void loadArticles(const QByteArray &data);
         void loadArticlesLegacy();
+        void importArticles();
+        void updateCacheInfo();
+        QVariantHash loadArticleData(const QString &guid) const;
+        QHash<QString, QVariantHash> loadArticlesData() const;
         void store();
         void storeDeferred();
         bool addArticle(Article *article);
@@ -109,16 +116,20 @@ namespace RSS
         void increaseUnreadCount();
         void decreaseUnreadCount();
         void downloadIcon();
+        void parse(const QByteArray &feedData);
+        void cancelParsing();
         int updateArticles(const QList<QVariantHash> &loadedArticles);
+        void handleArticlesStored(const QStringList &guids);
+        void handleArticlesStoreFailed(const QStringList &guids);
 
         Session *m_session;
-        Private::Parser *m_parser;
         const QUuid m_uid;
         const QString m_url;
         QString m_title;
         QString m_lastBuildDate;
         bool m_hasError = false;
         bool m_isLoading = false;
+        Private::Parser *m_parser = nullptr;
         QHash<QString, Article *> m_articles;
         QList<Article *> m_articlesByDate;
         int m_unreadCount = 0;
@@ -126,6 +137,16 @@ namespace RSS
         QString m_dataFileName;
         QBasicTimer m_savingTimer;
         bool m_dirty = false;
+        // pending changes that are not written to article storage yet
+        QSet<QString> m_newArticles;
+        QSet<QString> m_readArticles;
+        QSet<QString> m_removedArticles;
         Net::DownloadHandler *m_downloadHandler = nullptr;
+        Private::FeedCacheInfo m_cacheInfo;
+        // validators of the content that is being parsed, stored once parsing succeeded
+        Private::FeedCacheInfo m_pendingCacheInfo;
+        // content downloaded while the previous one is still being parsed
+        QByteArray m_queuedFeedData;
+        Private::FeedCacheInfo m_queuedCacheInfo;
     };
 }
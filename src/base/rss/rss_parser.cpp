@@ -33,7 +33,6 @@
 #include <QDebug>
 #include <QGlobalStatic>
 #include <QHash>
-#include <QMetaObject>
 #include <QRegularExpression>
 #include <QStringList>
 #include <QVariant>
@@ -542,15 +541,18 @@ using namespace RSS::Private;
 
 const int ParsingResultTypeId = qRegisterMetaType<ParsingResult>();
 
-Parser::Parser(const QString lastBuildDate)
+Parser::Parser(const QString &lastBuildDate, const QByteArray &feedData)
+    : m_feedData(feedData)
 {
     m_result.lastBuildDate = lastBuildDate;
+    // QThreadPool would delete it in the worker thread
+    setAutoDelete(false);
 }
 
-void Parser::parse(const QByteArray &feedData)
+void Parser::run()
 {
-    QMetaObject::invokeMethod(this, [this, feedData]() { parse_impl(feedData); }
-                              , Qt::QueuedConnection);
+    parse_impl(m_feedData);
+    deleteLater();
 }
 
 // read and create items from a rss document
@@ -603,8 +605,6 @@ void Parser::parse_impl(const QByteArray &feedData)
     }
 
     emit finished(m_result);
-    m_result.articles.clear(); // clear articles only
-    m_articleIDs.clear();
 }
 
 void Parser::parseRssArticle(QXmlStreamReader &xml)
@@ -31,6 +31,7 @@
 
 #include <QList>
 #include <QObject>
+#include <QRunnable>
 #include <QSet>
 #include <QString>
 #include <QVariantHash>
@@ -49,25 +50,30 @@ namespace RSS
             QList<QVariantHash> articles;
         };
 
-        class Parser : public QObject
+        // Parses single feed document. It is intended to be run in a thread pool
+        // and deletes itself (in the thread it was created in) once it is done.
+        class Parser final : public QObject, public QRunnable
         {
             Q_OBJECT
+            Q_DISABLE_COPY_MOVE(Parser)
 
         public:
-            explicit Parser(QString lastBuildDate);
-            void parse(const QByteArray &feedData);
+            Parser(const QString &lastBuildDate, const QByteArray &feedData);
+
+            void run() override;
 
         signals:
             void finished(const RSS::Private::ParsingResult &result);
 
         private:
-            Q_INVOKABLE void parse_impl(const QByteArray &feedData);
+            void parse_impl(const QByteArray &feedData);
             void parseRssArticle(QXmlStreamReader &xml);
             void parseRSSChannel(QXmlStreamReader &xml);
             void parseAtomArticle(QXmlStreamReader &xml);
             void parseAtomChannel(QXmlStreamReader &xml);
             void addArticle(QVariantHash article);
 
+            QByteArray m_feedData;
             QString m_baseUrl;
             ParsingResult m_result;
             QSet<QString> m_articleIDs;
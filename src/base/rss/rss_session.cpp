@@ -30,28 +30,41 @@
 
 #include "rss_session.h"
 
+#include <algorithm>
+
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QString>
 #include <QThread>
+#include <QThreadPool>
 
 #include "../asyncfilestorage.h"
 #include "../global.h"
 #include "../logger.h"
+#include "../memorystats.h"
 #include "../profile.h"
 #include "../settingsstorage.h"
 #include "../utils/fs.h"
+#include "../utils/random.h"
 #include "rss_article.h"
+#include "rss_articlestorage.h"
 #include "rss_feed.h"
 #include "rss_folder.h"
 #include "rss_item.h"
 
 const int MsecsPerMin = 60000;
+// Feeds are refreshed one after another with the delay of at least FeedRefreshMinDelay (ms)
+// and at most FeedRefreshMaxDelay (ms), the whole pass is spread within FeedRefreshMaxSpread (ms)
+const int FeedRefreshMinDelay = 50;
+const int FeedRefreshMaxDelay = 1000;
+const int FeedRefreshMaxSpread = 5 * MsecsPerMin;
+const int MaxParsingThreads = 4;
 const QString ConfFolderName(QStringLiteral("rss"));
 const QString DataFolderName(QStringLiteral("rss/articles"));
 const QString FeedsFileName(QStringLiteral("feeds.json"));
+const QString ArticlesDBFileName(QStringLiteral("articles.db"));
 
 const QString SettingsKey_ProcessingEnabled(QStringLiteral("RSS/Session/EnableProcessing"));
 const QString SettingsKey_RefreshInterval(QStringLiteral("RSS/Session/RefreshInterval"));
@@ -64,12 +77,17 @@ QPointer<Session> Session::m_instance = nullptr;
 Session::Session()
     : m_processingEnabled(SettingsStorage::instance()->loadValue(SettingsKey_ProcessingEnabled, false))
     , m_workingThread(new QThread(this))
+    , m_parsingThreadPool(new QThreadPool(this))
     , m_refreshInterval(SettingsStorage::instance()->loadValue(SettingsKey_RefreshInterval, 30))
     , m_maxArticlesPerFeed(SettingsStorage::instance()->loadValue(SettingsKey_MaxArticlesPerFeed, 50))
 {
     Q_ASSERT(!m_instance); // only one instance is allowed
     m_instance = this;
 
+    // Parsing is kept apart from the storage I/O thread so that large feeds
+    // are parsed in parallel and don't wait for pending disk writes
+    m_parsingThreadPool->setMaxThreadCount(std::clamp(QThread::idealThreadCount(), 1, MaxParsingThreads));
+
     m_confFileStorage = new AsyncFileStorage(
                 Utils::Fs::expandPathAbs(specialFolderLocation(SpecialFolder::Config) + ConfFolderName));
     m_confFileStorage->moveToThread(m_workingThread);
@@ -90,12 +108,29 @@ Session::Session()
                                        .arg(fileName, errorString), Log::WARNING);
     });
 
+    m_articleStorage = new Private::ArticleStorage(
+                m_dataFileStorage->storageDir().absoluteFilePath(ArticlesDBFileName), this);
+    connect(m_articleStorage, &Private::ArticleStorage::articlesStored, this, &Session::handleArticlesStored);
+    connect(m_articleStorage, &Private::ArticleStorage::articlesStoreFailed, this, &Session::handleArticlesStoreFailed);
+
     m_itemsByPath.insert("", new Folder); // root folder
 
     m_workingThread->start();
     load();
 
+    MemoryStats::registerProvider(QLatin1String("rss/articles"), tr("RSS articles"), [this]()
+    {
+        qint64 size = 0;
+        for (const Feed *feed : asConst(m_feedsByUID))
+        {
+            for (const Article *article : asConst(feed->articles()))
+                size += article->memoryUsage();
+        }
+        return size;
+    });
+
     connect(&m_refreshTimer, &QTimer::timeout, this, &Session::refresh);
+    connect(&m_feedRefreshTimer, &QTimer::timeout, this, &Session::refreshNextFeed);
     if (m_processingEnabled)
     {
         m_refreshTimer.start(m_refreshInterval * MsecsPerMin);
@@ -128,6 +163,17 @@ Session::~Session()
 {
     qDebug() << "Deleting RSS Session...";
 
+    MemoryStats::unregisterProvider(QLatin1String("rss/articles"));
+
+    // parsing results are of no use anymore
+    for (Feed *feed : asConst(m_feedsByUID))
+        feed->cancelParsing();
+    m_parsingThreadPool->waitForDone();
+
+    // write pending article changes
+    for (Feed *feed : asConst(m_feedsByUID))
+        feed->store();
+
     m_workingThread->quit();
     m_workingThread->wait();
 
@@ -446,6 +492,8 @@ void Session::setProcessingEnabled(bool enabled)
         else
         {
             m_refreshTimer.stop();
+            m_feedRefreshTimer.stop();
+            m_feedRefreshQueue.clear();
         }
 
         emit processingStateChanged(m_processingEnabled);
@@ -462,6 +510,11 @@ AsyncFileStorage *Session::dataFileStorage() const
     return m_dataFileStorage;
 }
 
+Private::ArticleStorage *Session::articleStorage() const
+{
+    return m_articleStorage;
+}
+
 Folder *Session::rootFolder() const
 {
     return static_cast<Folder *>(m_itemsByPath.value(""));
@@ -497,6 +550,11 @@ QThread *Session::workingThread() const
     return m_workingThread;
 }
 
+QThreadPool *Session::parsingThreadPool() const
+{
+    return m_parsingThreadPool;
+}
+
 void Session::handleItemAboutToBeDestroyed(Item *item)
 {
     m_itemsByPath.remove(item->path());
@@ -516,6 +574,20 @@ void Session::handleFeedTitleChanged(Feed *feed)
         moveItem(feed, Item::joinPath(Item::parentPath(feed->path()), feed->title()));
 }
 
+void Session::handleArticlesStored(const QUuid &feedUID, const QStringList &guids)
+{
+    Feed *feed = m_feedsByUID.value(feedUID);
+    if (feed)
+        feed->handleArticlesStored(guids);
+}
+
+void Session::handleArticlesStoreFailed(const QUuid &feedUID, const QStringList &guids)
+{
+    Feed *feed = m_feedsByUID.value(feedUID);
+    if (feed)
+        feed->handleArticlesStoreFailed(guids);
+}
+
 QUuid Session::generateUID() const
 {
     QUuid uid = QUuid::createUuid();
@@ -543,5 +615,41 @@ void Session::setMaxArticlesPerFeed(const int n)
 void Session::refresh()
 {
     // NOTE: Should we allow manually refreshing for disabled session?
-    rootFolder()->refresh();
+
+    // Feeds are refreshed one by one in random order instead of all at once so
+    // that neither network nor parsing thread get all the requests in one burst
+    QList<QUuid> feedUIDs = m_feedsByUID.keys();
+    for (int i = feedUIDs.size() - 1; i > 0; --i)
+        feedUIDs.swapItemsAt(i, static_cast<int>(Utils::Random::rand(0, i)));
+
+    m_feedRefreshQueue.clear();
+    for (const QUuid &uid : asConst(feedUIDs))
+        m_feedRefreshQueue.enqueue(uid);
+
+    if (m_feedRefreshQueue.isEmpty())
+    {
+        m_feedRefreshTimer.stop();
+        return;
+    }
+
+    const int spread = std::min((m_refreshInterval * MsecsPerMin / 2), FeedRefreshMaxSpread);
+    m_feedRefreshTimer.start(std::clamp(static_cast<int>(spread / m_feedRefreshQueue.size()), FeedRefreshMinDelay, FeedRefreshMaxDelay));
+    refreshNextFeed();
+}
+
+void Session::refreshNextFeed()
+{
+    while (!m_feedRefreshQueue.isEmpty())
+    {
+        // feed could be removed since it was queued
+        Feed *feed = m_feedsByUID.value(m_feedRefreshQueue.dequeue());
+        if (feed)
+        {
+            feed->refresh();
+            break;
+        }
+    }
+
+    if (m_feedRefreshQueue.isEmpty())
+        m_feedRefreshTimer.stop();
 }
@@ -71,11 +71,14 @@
 #include <QHash>
 #include <QObject>
 #include <QPointer>
+#include <QQueue>
 #include <QTimer>
+#include <QUuid>
 
 #include "base/3rdparty/expected.hpp"
 
 class QThread;
+class QThreadPool;
 
 class Application;
 class AsyncFileStorage;
@@ -86,6 +89,11 @@ namespace RSS
     class Folder;
     class Item;
 
+    namespace Private
+    {
+        class ArticleStorage;
+    }
+
     class Session : public QObject
     {
         Q_OBJECT
@@ -103,8 +111,10 @@ namespace RSS
         void setProcessingEnabled(bool enabled);
 
         QThread *workingThread() const;
+        QThreadPool *parsingThreadPool() const;
         AsyncFileStorage *confFileStorage() const;
         AsyncFileStorage *dataFileStorage() const;
+        Private::ArticleStorage *articleStorage() const;
 
         int maxArticlesPerFeed() const;
         void setMaxArticlesPerFeed(int n);
@@ -140,6 +150,9 @@ namespace RSS
     private slots:
         void handleItemAboutToBeDestroyed(Item *item);
         void handleFeedTitleChanged(Feed *feed);
+        void handleArticlesStored(const QUuid &feedUID, const QStringList &guids);
+        void handleArticlesStoreFailed(const QUuid &feedUID, const QStringList &guids);
+        void refreshNextFeed();
 
     private:
         QUuid generateUID() const;
@@ -156,9 +169,13 @@ namespace RSS
 
         bool m_processingEnabled;
         QThread *m_workingThread;
+        QThreadPool *m_parsingThreadPool;
         AsyncFileStorage *m_confFileStorage;
         AsyncFileStorage *m_dataFileStorage;
+        Private::ArticleStorage *m_articleStorage;
         QTimer m_refreshTimer;
+        QTimer m_feedRefreshTimer;
+        QQueue<QUuid> m_feedRefreshQueue;
         int m_refreshInterval;
         int m_maxArticlesPerFeed;
         QHash<QString, Item *> m_itemsByPath;
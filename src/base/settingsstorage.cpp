@@ -30,8 +30,10 @@
 #include "settingsstorage.h"
 
 #include <memory>
-#include <QFile>
+
+#include <QFileInfo>
 #include <QHash>
+#include <QThread>
 
 #include "global.h"
 #include "logger.h"
@@ -153,8 +155,14 @@ namespace
 SettingsStorage *SettingsStorage::m_instance = nullptr;
 
 SettingsStorage::SettingsStorage()
-    : m_data {TransactionalSettings(QLatin1String("qBittorrent")).read()}
+    : m_ioThread {new QThread(this)}
+    , m_asyncWorker {new QObject}
+    , m_data {TransactionalSettings(QLatin1String("qBittorrent")).read()}
 {
+    m_asyncWorker->moveToThread(m_ioThread);
+    connect(m_ioThread, &QThread::finished, m_asyncWorker, &QObject::deleteLater);
+    m_ioThread->start();
+
     m_timer.setSingleShot(true);
     m_timer.setInterval(5 * 1000);
     connect(&m_timer, &QTimer::timeout, this, &SettingsStorage::save);
@@ -162,7 +170,15 @@ SettingsStorage::SettingsStorage()
 
 SettingsStorage::~SettingsStorage()
 {
-    save();
+    // waits for the write in progress (if any) to finish
+    m_ioThread->quit();
+    m_ioThread->wait();
+
+    // the outcome of the last background write is unknown at this point
+    // so write the data once again unless it is known to be saved
+    const QWriteLocker locker(&m_lock);
+    if (m_dirty || m_isSaving)
+        TransactionalSettings(QLatin1String("qBittorrent")).write(m_data);
 }
 
 void SettingsStorage::initInstance()
@@ -182,20 +198,61 @@ SettingsStorage *SettingsStorage::instance()
     return m_instance;
 }
 
-bool SettingsStorage::save()
+void SettingsStorage::save()
 {
-    const QWriteLocker locker(&m_lock);  // guard for `m_dirty` too
-    if (!m_dirty) return true;
+    if (m_isSaving)
+    {
+        m_isSavePending = true;
+        return;
+    }
 
-    const TransactionalSettings settings(QLatin1String("qBittorrent"));
-    if (!settings.write(m_data))
+    QVariantHash data;
     {
-        m_timer.start();
-        return false;
+        const QWriteLocker locker(&m_lock);  // guard for `m_dirty` too
+        if (!m_dirty) return;
+
+        // implicitly shared, so the copy is cheap and the lock is held only briefly
+        data = m_data;
+        m_dirty = false;
     }
 
-    m_dirty = false;
-    return true;
+    m_timer.stop();
+    m_isSaving = true;
+    QMetaObject::invokeMethod(m_asyncWorker, [this, data]()
+    {
+        const bool success = TransactionalSettings(QLatin1String("qBittorrent")).write(data);
+        QMetaObject::invokeMethod(this, [this, success]() { handleSaveFinished(success); }, Qt::QueuedConnection);
+    });
+}
+
+void SettingsStorage::handleSaveFinished(const bool success)
+{
+    m_isSaving = false;
+
+    bool dirty = false;
+    {
+        const QWriteLocker locker(&m_lock);
+        if (!success)
+            m_dirty = true;
+        dirty = m_dirty;
+    }
+
+    if (!dirty)
+    {
+        m_isSavePending = false;
+        return;
+    }
+
+    if (success && m_isSavePending)
+    {
+        m_isSavePending = false;
+        save();
+    }
+    else
+    {
+        // retry (or save the changes made in the meantime) later
+        m_timer.start();
+    }
 }
 
 QVariant SettingsStorage::loadValueImpl(const QString &key, const QVariant &defaultValue) const
@@ -260,8 +317,7 @@ QVariantHash TransactionalSettings::read() const
         int index = finalPath.lastIndexOf("_new", -1, Qt::CaseInsensitive);
         finalPath.remove(index, 4);
 
-        Utils::Fs::forceRemove(finalPath);
-        QFile::rename(newPath, finalPath);
+        Utils::Fs::replaceFile(newPath, finalPath);
     }
     else
     {
@@ -285,12 +341,31 @@ bool TransactionalSettings::write(const QVariantHash &data) const
         return false;
     }
 
+    // Make sure the new file contents reached the disk before it replaces the old one.
+    // Otherwise a power loss right after renaming could leave an empty or truncated file.
+    if (!Utils::Fs::syncFile(newPath))
+    {
+        LogMsg(QObject::tr("Couldn't flush settings file to disk. File: \"%1\"")
+            .arg(Utils::Fs::toNativePath(newPath)), Log::WARNING);
+    }
+
     QString finalPath = newPath;
     int index = finalPath.lastIndexOf("_new", -1, Qt::CaseInsensitive);
     finalPath.remove(index, 4);
 
-    Utils::Fs::forceRemove(finalPath);
-    return QFile::rename(newPath, finalPath);
+    // The old file stays in place until the new one atomically replaces it
+    if (!Utils::Fs::replaceFile(newPath, finalPath))
+        return false;
+
+    // Make the replacement itself durable
+    const QString dirPath = QFileInfo(finalPath).absolutePath();
+    if (!Utils::Fs::syncDirectory(dirPath))
+    {
+        LogMsg(QObject::tr("Couldn't flush settings folder to disk. Folder: \"%1\"")
+            .arg(Utils::Fs::toNativePath(dirPath)), Log::WARNING);
+    }
+
+    return true;
 }
 
 QString TransactionalSettings::deserialize(const QString &name, QVariantHash &data) const
@@ -316,6 +391,8 @@ QString TransactionalSettings::deserialize(const QString &name, QVariantHash &da
 QString TransactionalSettings::serialize(const QString &name, const QVariantHash &data) const
 {
     SettingsPtr settings = Profile::instance()->applicationSettings(name);
+    // drop any leftovers of an interrupted write so removed keys don't come back
+    settings->clear();
     for (auto i = data.begin(); i != data.end(); ++i)
         settings->setValue(i.key(), i.value());
 
@@ -38,6 +38,8 @@
 
 #include "utils/string.h"
 
+class QThread;
+
 class SettingsStorage : public QObject
 {
     Q_OBJECT
@@ -82,14 +84,21 @@ public:
     bool hasKey(const QString &key) const;
 
 public slots:
-    bool save();
+    // Schedules writing of the current data in background.
+    // Requests made while a write is in progress are coalesced into one.
+    void save();
 
 private:
     QVariant loadValueImpl(const QString &key, const QVariant &defaultValue = {}) const;
     void storeValueImpl(const QString &key, const QVariant &value);
+    void handleSaveFinished(bool success);
 
     static SettingsStorage *m_instance;
 
+    QThread *m_ioThread = nullptr;
+    QObject *m_asyncWorker = nullptr;
+    bool m_isSaving = false;
+    bool m_isSavePending = false;
     bool m_dirty = false;
     QVariantHash m_data;
     QTimer m_timer;
@@ -30,21 +30,34 @@
 #include "torrentfileswatcher.h"
 
 #include <chrono>
+#include <utility>
 
 #include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
 #include <QFileSystemWatcher>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QSet>
+#ifdef Q_OS_LINUX
+#include <QSocketNotifier>
+#endif
 #include <QTextStream>
 #include <QThread>
+#include <QThreadPool>
 #include <QTimer>
 #include <QVariant>
+#include <QVector>
 
 #include "base/algorithm.h"
 #include "base/bittorrent/magneturi.h"
@@ -65,7 +78,13 @@
 using namespace std::chrono_literals;
 
 const std::chrono::duration WATCH_INTERVAL = 10s;
+// Delay before rescanning a folder reported as changed, so that bursts of changes are handled at once
+const std::chrono::duration RESCAN_DELAY = 2s;
+// Delay before handling the files reported by file level events, so that they are handled in batches
+const std::chrono::duration FILE_EVENTS_DELAY = 500ms;
 const int MAX_FAILED_RETRIES = 5;
+// Maximum number of torrents passed to the session at once
+const int MAX_FOUND_TORRENTS_BATCH_SIZE = 100;
 const QString CONF_FILE_NAME {QStringLiteral("watched_folders.json")};
 
 const QString OPTION_ADDTORRENTPARAMS {QStringLiteral("add_torrent_params")};
@@ -84,8 +103,17 @@ const QString PARAM_DOWNLOADLIMIT {QStringLiteral("download_limit")};
 const QString PARAM_SEEDINGTIMELIMIT {QStringLiteral("seeding_time_limit")};
 const QString PARAM_RATIOLIMIT {QStringLiteral("ratio_limit")};
 
+const int torrentInfoVectorTypeId = qRegisterMetaType<QVector<BitTorrent::TorrentInfo>>();
+const int addTorrentParamsVectorTypeId = qRegisterMetaType<QVector<BitTorrent::AddTorrentParams>>();
+
 namespace
 {
+    bool isWatchedFileName(const QString &fileName)
+    {
+        return fileName.endsWith(QLatin1String(".torrent"), Qt::CaseInsensitive)
+            || fileName.endsWith(QLatin1String(".magnet"), Qt::CaseInsensitive);
+    }
+
     TagSet parseTagSet(const QJsonArray &jsonArr)
     {
         TagSet tags;
@@ -199,6 +227,7 @@ class TorrentFilesWatcher::Worker final : public QObject
 
 public:
     Worker();
+    ~Worker() override;
 
 public slots:
     void setWatchedFolder(const QString &path, const TorrentFilesWatcher::WatchedFolderOptions &options);
@@ -206,22 +235,53 @@ public slots:
 
 signals:
     void magnetFound(const BitTorrent::MagnetUri &magnetURI, const BitTorrent::AddTorrentParams &addTorrentParams);
-    void torrentFound(const BitTorrent::TorrentInfo &torrentInfo, const BitTorrent::AddTorrentParams &addTorrentParams);
+    void torrentsFound(const QVector<BitTorrent::TorrentInfo> &torrentInfos, const QVector<BitTorrent::AddTorrentParams> &addTorrentParams);
 
 private:
     void onTimeout();
     void scheduleWatchedFolderProcessing(const QString &path);
+    void processPendingFolders();
+    void processPendingFiles();
     void processWatchedFolder(const QString &path);
     void processFolder(const QString &path, const QString &watchedFolderPath, const TorrentFilesWatcher::WatchedFolderOptions &options);
+    void processFile(const QString &filePath, const QString &watchedFolderPath, const BitTorrent::AddTorrentParams &addTorrentParams);
+    void loadTorrentFile(const QString &filePath, const QString &watchedFolderPath, const BitTorrent::AddTorrentParams &addTorrentParams);
+    void handleTorrentFileLoaded(const QString &filePath, const QString &watchedFolderPath
+        , const BitTorrent::AddTorrentParams &addTorrentParams, const nonstd::expected<BitTorrent::TorrentInfo, QString> &result);
+    void emitFoundTorrents();
     void processFailedTorrents();
     void addWatchedFolder(const QString &watchedFolderID, const TorrentFilesWatcher::WatchedFolderOptions &options);
     void updateWatchedFolder(const QString &watchedFolderID, const TorrentFilesWatcher::WatchedFolderOptions &options);
+    void startWatching(const QString &path);
+    void stopWatching(const QString &path);
+#ifdef Q_OS_LINUX
+    void readFileEvents();
+#endif
 
     QFileSystemWatcher *m_watcher = nullptr;
     QTimer *m_watchTimer = nullptr;
     QHash<QString, TorrentFilesWatcher::WatchedFolderOptions> m_watchedFolders;
     QSet<QString> m_watchedByTimeoutFolders;
 
+#ifdef Q_OS_LINUX
+    // File level events of local non-recursive folders
+    int m_inotifyFD = -1;
+    QSocketNotifier *m_inotifyNotifier = nullptr;
+    QHash<int, QString> m_inotifyWatches;
+#endif
+
+    // Changes waiting to be processed
+    QTimer *m_rescanTimer = nullptr;
+    QSet<QString> m_pendingFolders;
+    QTimer *m_fileEventsTimer = nullptr;
+    QHash<QString, QSet<QString>> m_pendingFiles;
+
+    // Torrent files are loaded in parallel and the results are passed on in batches
+    QThreadPool *m_loadingThreadPool = nullptr;
+    QSet<QString> m_loadingTorrentFiles;
+    QVector<BitTorrent::TorrentInfo> m_foundTorrentInfos;
+    QVector<BitTorrent::AddTorrentParams> m_foundTorrentParams;
+
     // Failed torrents
     QTimer *m_retryTorrentTimer = nullptr;
     QHash<QString, QHash<QString, int>> m_failedTorrents;
@@ -252,7 +312,7 @@ TorrentFilesWatcher::TorrentFilesWatcher(QObject *parent)
     , m_asyncWorker {new TorrentFilesWatcher::Worker}
 {
     connect(m_asyncWorker, &TorrentFilesWatcher::Worker::magnetFound, this, &TorrentFilesWatcher::onMagnetFound);
-    connect(m_asyncWorker, &TorrentFilesWatcher::Worker::torrentFound, this, &TorrentFilesWatcher::onTorrentFound);
+    connect(m_asyncWorker, &TorrentFilesWatcher::Worker::torrentsFound, this, &TorrentFilesWatcher::onTorrentsFound);
 
     m_asyncWorker->moveToThread(m_ioThread);
     m_ioThread->start();
@@ -429,21 +489,59 @@ void TorrentFilesWatcher::onMagnetFound(const BitTorrent::MagnetUri &magnetURI
     BitTorrent::Session::instance()->addTorrent(magnetURI, addTorrentParams);
 }
 
-void TorrentFilesWatcher::onTorrentFound(const BitTorrent::TorrentInfo &torrentInfo
-                                         , const BitTorrent::AddTorrentParams &addTorrentParams)
+void TorrentFilesWatcher::onTorrentsFound(const QVector<BitTorrent::TorrentInfo> &torrentInfos
+                                          , const QVector<BitTorrent::AddTorrentParams> &addTorrentParams)
 {
-    BitTorrent::Session::instance()->addTorrent(torrentInfo, addTorrentParams);
+    Q_ASSERT(torrentInfos.size() == addTorrentParams.size());
+
+    for (int i = 0; i < torrentInfos.size(); ++i)
+        BitTorrent::Session::instance()->addTorrent(torrentInfos[i], addTorrentParams[i]);
 }
 
 TorrentFilesWatcher::Worker::Worker()
     : m_watcher {new QFileSystemWatcher(this)}
     , m_watchTimer {new QTimer(this)}
+    , m_rescanTimer {new QTimer(this)}
+    , m_fileEventsTimer {new QTimer(this)}
+    , m_loadingThreadPool {new QThreadPool(this)}
     , m_retryTorrentTimer {new QTimer(this)}
 {
     connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &Worker::scheduleWatchedFolderProcessing);
     connect(m_watchTimer, &QTimer::timeout, this, &Worker::onTimeout);
 
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(RESCAN_DELAY);
+    connect(m_rescanTimer, &QTimer::timeout, this, &Worker::processPendingFolders);
+
+    m_fileEventsTimer->setSingleShot(true);
+    m_fileEventsTimer->setInterval(FILE_EVENTS_DELAY);
+    connect(m_fileEventsTimer, &QTimer::timeout, this, &Worker::processPendingFiles);
+
     connect(m_retryTorrentTimer, &QTimer::timeout, this, &Worker::processFailedTorrents);
+
+#ifdef Q_OS_LINUX
+    m_inotifyFD = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFD >= 0)
+    {
+        m_inotifyNotifier = new QSocketNotifier(m_inotifyFD, QSocketNotifier::Read, this);
+        connect(m_inotifyNotifier, qOverload<QSocketDescriptor, QSocketNotifier::Type>(&QSocketNotifier::activated)
+                , this, &Worker::readFileEvents);
+    }
+#endif
+}
+
+TorrentFilesWatcher::Worker::~Worker()
+{
+    m_loadingThreadPool->clear();
+    m_loadingThreadPool->waitForDone();
+
+#ifdef Q_OS_LINUX
+    if (m_inotifyFD >= 0)
+    {
+        delete m_inotifyNotifier;
+        ::close(m_inotifyFD);
+    }
+#endif
 }
 
 void TorrentFilesWatcher::Worker::onTimeout()
@@ -464,31 +562,134 @@ void TorrentFilesWatcher::Worker::removeWatchedFolder(const QString &path)
 {
     m_watchedFolders.remove(path);
 
-    m_watcher->removePath(path);
+    stopWatching(path);
     m_watchedByTimeoutFolders.remove(path);
     if (m_watchedByTimeoutFolders.isEmpty())
         m_watchTimer->stop();
 
+    m_pendingFolders.remove(path);
+    m_pendingFiles.remove(path);
+
     m_failedTorrents.remove(path);
     if (m_failedTorrents.isEmpty())
         m_retryTorrentTimer->stop();
 }
 
+void TorrentFilesWatcher::Worker::startWatching(const QString &path)
+{
+#ifdef Q_OS_LINUX
+    if (m_inotifyFD >= 0)
+    {
+        // Files are reported once they are completely written or moved into the folder
+        const int wd = ::inotify_add_watch(m_inotifyFD, QFile::encodeName(path).constData()
+                                           , (IN_CLOSE_WRITE | IN_MOVED_TO));
+        if (wd >= 0)
+        {
+            m_inotifyWatches[wd] = path;
+            return;
+        }
+    }
+#endif
+
+    m_watcher->addPath(path);
+}
+
+void TorrentFilesWatcher::Worker::stopWatching(const QString &path)
+{
+#ifdef Q_OS_LINUX
+    const int wd = m_inotifyWatches.key(path, -1);
+    if (wd >= 0)
+    {
+        ::inotify_rm_watch(m_inotifyFD, wd);
+        m_inotifyWatches.remove(wd);
+        return;
+    }
+#endif
+
+    m_watcher->removePath(path);
+}
+
+#ifdef Q_OS_LINUX
+void TorrentFilesWatcher::Worker::readFileEvents()
+{
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    ssize_t length = 0;
+    while ((length = ::read(m_inotifyFD, buffer, sizeof(buffer))) > 0)
+    {
+        for (const char *ptr = buffer; ptr < (buffer + length); )
+        {
+            const auto *event = reinterpret_cast<const inotify_event *>(ptr);
+            ptr += (sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                // Some events were lost so fall back to rescanning the folders
+                for (const QString &folderPath : asConst(m_inotifyWatches))
+                    scheduleWatchedFolderProcessing(folderPath);
+                continue;
+            }
+
+            if (event->mask & IN_IGNORED)
+            {
+                // The folder was removed or unmounted
+                m_inotifyWatches.remove(event->wd);
+                continue;
+            }
+
+            if ((event->mask & IN_ISDIR) || (event->len == 0))
+                continue;
+
+            const QString folderPath = m_inotifyWatches.value(event->wd);
+            const QString fileName = QFile::decodeName(event->name);
+            if (folderPath.isEmpty() || !isWatchedFileName(fileName))
+                continue;
+
+            m_pendingFiles[folderPath].insert(folderPath + QLatin1Char('/') + fileName);
+        }
+    }
+
+    if (!m_pendingFiles.isEmpty() && !m_fileEventsTimer->isActive())
+        m_fileEventsTimer->start();
+}
+#endif
+
 void TorrentFilesWatcher::Worker::scheduleWatchedFolderProcessing(const QString &path)
 {
-    QTimer::singleShot(2000, this, [this, path]()
+    m_pendingFolders.insert(path);
+    if (!m_rescanTimer->isActive())
+        m_rescanTimer->start();
+}
+
+void TorrentFilesWatcher::Worker::processPendingFolders()
+{
+    const QSet<QString> pendingFolders = std::exchange(m_pendingFolders, {});
+    for (const QString &path : pendingFolders)
     {
-        processWatchedFolder(path);
-    });
+        if (m_watchedFolders.contains(path))
+            processWatchedFolder(path);
+    }
+}
+
+void TorrentFilesWatcher::Worker::processPendingFiles()
+{
+    const QHash<QString, QSet<QString>> pendingFiles = std::exchange(m_pendingFiles, {});
+    for (auto it = pendingFiles.cbegin(); it != pendingFiles.cend(); ++it)
+    {
+        const QString &watchedFolderPath = it.key();
+        const auto watchedFolderIter = m_watchedFolders.constFind(watchedFolderPath);
+        if (watchedFolderIter == m_watchedFolders.cend())
+            continue;
+
+        for (const QString &filePath : it.value())
+            processFile(filePath, watchedFolderPath, watchedFolderIter->addTorrentParams);
+    }
 }
 
 void TorrentFilesWatcher::Worker::processWatchedFolder(const QString &path)
 {
     const TorrentFilesWatcher::WatchedFolderOptions options = m_watchedFolders.value(path);
     processFolder(path, path, options);
-
-    if (!m_failedTorrents.empty() && !m_retryTorrentTimer->isActive())
-        m_retryTorrentTimer->start(WATCH_INTERVAL);
 }
 
 void TorrentFilesWatcher::Worker::processFolder(const QString &path, const QString &watchedFolderPath
@@ -496,63 +697,116 @@ void TorrentFilesWatcher::Worker::processFolder(const QString &path, const QStri
 {
     const QDir watchedDir {watchedFolderPath};
 
+    BitTorrent::AddTorrentParams addTorrentParams = options.addTorrentParams;
+    if (path != watchedFolderPath)
+    {
+        const QString subdirPath = watchedDir.relativeFilePath(path);
+        addTorrentParams.savePath = QDir::cleanPath(QDir(addTorrentParams.savePath).filePath(subdirPath));
+    }
+
     QDirIterator dirIter {path, {"*.torrent", "*.magnet"}, QDir::Files};
     while (dirIter.hasNext())
+        processFile(dirIter.next(), watchedFolderPath, addTorrentParams);
+
+    if (options.recursive)
     {
-        const QString filePath = dirIter.next();
-        BitTorrent::AddTorrentParams addTorrentParams = options.addTorrentParams;
-        if (path != watchedFolderPath)
+        QDirIterator dirIter {path, (QDir::Dirs | QDir::NoDot | QDir::NoDotDot)};
+        while (dirIter.hasNext())
         {
-            const QString subdirPath = watchedDir.relativeFilePath(path);
-            addTorrentParams.savePath = QDir::cleanPath(QDir(addTorrentParams.savePath).filePath(subdirPath));
+            const QString folderPath = dirIter.next();
+            // Skip processing of subdirectory that is explicitly set as watched folder
+            if (!m_watchedFolders.contains(folderPath))
+                processFolder(folderPath, watchedFolderPath, options);
         }
+    }
+}
 
-        if (filePath.endsWith(QLatin1String(".magnet"), Qt::CaseInsensitive))
+void TorrentFilesWatcher::Worker::processFile(const QString &filePath, const QString &watchedFolderPath
+                                            , const BitTorrent::AddTorrentParams &addTorrentParams)
+{
+    if (filePath.endsWith(QLatin1String(".magnet"), Qt::CaseInsensitive))
+    {
+        QFile file {filePath};
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text))
         {
-            QFile file {filePath};
-            if (file.open(QIODevice::ReadOnly | QIODevice::Text))
-            {
-                QTextStream str {&file};
-                while (!str.atEnd())
-                    emit magnetFound(BitTorrent::MagnetUri(str.readLine()), addTorrentParams);
+            QTextStream str {&file};
+            while (!str.atEnd())
+                emit magnetFound(BitTorrent::MagnetUri(str.readLine()), addTorrentParams);
 
-                file.close();
-                Utils::Fs::forceRemove(filePath);
-            }
-            else
-            {
-                LogMsg(tr("Failed to open magnet file: %1").arg(file.errorString()));
-            }
+            file.close();
+            Utils::Fs::forceRemove(filePath);
         }
         else
         {
-            const nonstd::expected<BitTorrent::TorrentInfo, QString> result = BitTorrent::TorrentInfo::loadFromFile(filePath);
-            if (result)
-            {
-                emit torrentFound(result.value(), addTorrentParams);
-                Utils::Fs::forceRemove(filePath);
-            }
-            else
-            {
-                if (!m_failedTorrents.value(path).contains(filePath))
-                {
-                    m_failedTorrents[path][filePath] = 0;
-                }
-            }
+            LogMsg(tr("Failed to open magnet file: %1").arg(file.errorString()));
         }
     }
+    else
+    {
+        // Failed torrent files are retried by processFailedTorrents()
+        if (!m_failedTorrents.value(watchedFolderPath).contains(filePath))
+            loadTorrentFile(filePath, watchedFolderPath, addTorrentParams);
+    }
+}
 
-    if (options.recursive)
+void TorrentFilesWatcher::Worker::loadTorrentFile(const QString &filePath, const QString &watchedFolderPath
+                                                , const BitTorrent::AddTorrentParams &addTorrentParams)
+{
+    if (m_loadingTorrentFiles.contains(filePath))
+        return;
+
+    m_loadingTorrentFiles.insert(filePath);
+    m_loadingThreadPool->start([this, filePath, watchedFolderPath, addTorrentParams]()
     {
-        QDirIterator dirIter {path, (QDir::Dirs | QDir::NoDot | QDir::NoDotDot)};
-        while (dirIter.hasNext())
+        const nonstd::expected<BitTorrent::TorrentInfo, QString> result = BitTorrent::TorrentInfo::loadFromFile(filePath);
+        QMetaObject::invokeMethod(this, [this, filePath, watchedFolderPath, addTorrentParams, result]()
         {
-            const QString folderPath = dirIter.next();
-            // Skip processing of subdirectory that is explicitly set as watched folder
-            if (!m_watchedFolders.contains(folderPath))
-                processFolder(folderPath, watchedFolderPath, options);
+            handleTorrentFileLoaded(filePath, watchedFolderPath, addTorrentParams, result);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void TorrentFilesWatcher::Worker::handleTorrentFileLoaded(const QString &filePath, const QString &watchedFolderPath
+    , const BitTorrent::AddTorrentParams &addTorrentParams, const nonstd::expected<BitTorrent::TorrentInfo, QString> &result)
+{
+    m_loadingTorrentFiles.remove(filePath);
+
+    // The folder could be removed from the watched ones while the file was loading
+    if (m_watchedFolders.contains(watchedFolderPath))
+    {
+        if (result)
+        {
+            const auto failedTorrentsIter = m_failedTorrents.find(watchedFolderPath);
+            if (failedTorrentsIter != m_failedTorrents.end())
+                failedTorrentsIter->remove(filePath);
+
+            m_foundTorrentInfos.append(result.value());
+            m_foundTorrentParams.append(addTorrentParams);
+            Utils::Fs::forceRemove(filePath);
+        }
+        else
+        {
+            if (!m_failedTorrents.value(watchedFolderPath).contains(filePath))
+                m_failedTorrents[watchedFolderPath][filePath] = 0;
+
+            if (!m_retryTorrentTimer->isActive())
+                m_retryTorrentTimer->start(WATCH_INTERVAL);
         }
     }
+
+    if (m_loadingTorrentFiles.isEmpty() || (m_foundTorrentInfos.size() >= MAX_FOUND_TORRENTS_BATCH_SIZE))
+        emitFoundTorrents();
+}
+
+void TorrentFilesWatcher::Worker::emitFoundTorrents()
+{
+    if (m_foundTorrentInfos.isEmpty())
+        return;
+
+    emit torrentsFound(m_foundTorrentInfos, m_foundTorrentParams);
+
+    m_foundTorrentInfos.clear();
+    m_foundTorrentParams.clear();
 }
 
 void TorrentFilesWatcher::Worker::processFailedTorrents()
@@ -562,28 +816,11 @@ void TorrentFilesWatcher::Worker::processFailedTorrents()
     {
         const QDir dir {watchedFolderPath};
         const TorrentFilesWatcher::WatchedFolderOptions options = m_watchedFolders.value(watchedFolderPath);
-        Algorithm::removeIf(partialTorrents, [this, &dir, &options](const QString &torrentPath, int &value)
+        Algorithm::removeIf(partialTorrents, [this, &dir, &watchedFolderPath, &options](const QString &torrentPath, int &value)
         {
             if (!QFile::exists(torrentPath))
                 return true;
 
-            const nonstd::expected<BitTorrent::TorrentInfo, QString> result = BitTorrent::TorrentInfo::loadFromFile(torrentPath);
-            if (result)
-            {
-                BitTorrent::AddTorrentParams addTorrentParams = options.addTorrentParams;
-                const QString exactDirPath = QFileInfo(torrentPath).canonicalPath();
-                if (exactDirPath != dir.path())
-                {
-                    const QString subdirPath = dir.relativeFilePath(exactDirPath);
-                    addTorrentParams.savePath = QDir(addTorrentParams.savePath).filePath(subdirPath);
-                }
-
-                emit torrentFound(result.value(), addTorrentParams);
-                Utils::Fs::forceRemove(torrentPath);
-
-                return true;
-            }
-
             if (value >= MAX_FAILED_RETRIES)
             {
                 LogMsg(tr("Rejecting failed torrent file: %1").arg(torrentPath));
@@ -592,6 +829,17 @@ void TorrentFilesWatcher::Worker::processFailedTorrents()
             }
 
             ++value;
+
+            BitTorrent::AddTorrentParams addTorrentParams = options.addTorrentParams;
+            const QString exactDirPath = QFileInfo(torrentPath).canonicalPath();
+            if (exactDirPath != dir.path())
+            {
+                const QString subdirPath = dir.relativeFilePath(exactDirPath);
+                addTorrentParams.savePath = QDir(addTorrentParams.savePath).filePath(subdirPath);
+            }
+
+            // the file is removed from the failed ones once it is loaded successfully
+            loadTorrentFile(torrentPath, watchedFolderPath, addTorrentParams);
             return false;
         });
 
@@ -623,7 +871,7 @@ void TorrentFilesWatcher::Worker::addWatchedFolder(const QString &path, const To
     }
     else
     {
-        m_watcher->addPath(path);
+        startWatching(path);
         scheduleWatchedFolderProcessing(path);
     }
 
@@ -643,7 +891,7 @@ void TorrentFilesWatcher::Worker::updateWatchedFolder(const QString &path, const
     {
         if (options.recursive)
         {
-            m_watcher->removePath(path);
+            stopWatching(path);
 
             m_watchedByTimeoutFolders.insert(path);
             if (!m_watchTimer->isActive())
@@ -655,7 +903,7 @@ void TorrentFilesWatcher::Worker::updateWatchedFolder(const QString &path, const
             if (m_watchedByTimeoutFolders.isEmpty())
                 m_watchTimer->stop();
 
-            m_watcher->addPath(path);
+            startWatching(path);
             scheduleWatchedFolderProcessing(path);
         }
     }
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <QHash>
+#include <QtContainerFwd>
 
 #include "base/bittorrent/addtorrentparams.h"
 
@@ -43,7 +44,8 @@ namespace BitTorrent
 /*
  * Watches the configured directories for new .torrent files in order
  * to add torrents to BitTorrent session. Supports Network File System
- * watching (NFS, CIFS) on Linux and Mac OS.
+ * watching (NFS, CIFS) on Linux and Mac OS. On Linux, local folders are
+ * watched for file level events so that only new files are processed.
  */
 class TorrentFilesWatcher final : public QObject
 {
@@ -73,7 +75,7 @@ signals:
 
 private slots:
     void onMagnetFound(const BitTorrent::MagnetUri &magnetURI, const BitTorrent::AddTorrentParams &addTorrentParams);
-    void onTorrentFound(const BitTorrent::TorrentInfo &torrentInfo, const BitTorrent::AddTorrentParams &addTorrentParams);
+    void onTorrentsFound(const QVector<BitTorrent::TorrentInfo> &torrentInfos, const QVector<BitTorrent::AddTorrentParams> &addTorrentParams);
 
 private:
     explicit TorrentFilesWatcher(QObject *parent = nullptr);
@@ -0,0 +1,127 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "bitfield.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <libtorrent/bitfield.hpp>
+
+#include <QBitArray>
+#include <QByteArray>
+#include <QtAlgorithms>
+
+namespace
+{
+    constexpr std::array<quint8, 256> makeBitReverseTable()
+    {
+        std::array<quint8, 256> table {};
+        for (int i = 0; i < 256; ++i)
+        {
+            quint8 reversed = 0;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                if (i & (1 << bit))
+                    reversed |= (0x80 >> bit);
+            }
+            table[i] = reversed;
+        }
+        return table;
+    }
+
+    constexpr std::array<quint8, 256> BIT_REVERSE_TABLE = makeBitReverseTable();
+
+    int bytesForBits(const int bits)
+    {
+        return (bits + 7) / 8;
+    }
+
+    // libtorrent stores bit `i` in byte `i / 8` under mask `0x80 >> (i % 8)`
+    quint8 trailingByteMask(const int bits)
+    {
+        const int used = bits % 8;
+        return (used == 0) ? 0xFF : static_cast<quint8>(0xFF << (8 - used));
+    }
+}
+
+int Utils::Bitfield::countAndNot(const lt::bitfield &bits, const lt::bitfield &mask)
+{
+    const int size = std::min(bits.size(), mask.size());
+    if (size <= 0)
+        return 0;
+
+    const auto *bitsData = reinterpret_cast<const uchar *>(bits.data());
+    const auto *maskData = reinterpret_cast<const uchar *>(mask.data());
+    const int byteCount = bytesForBits(size);
+    // The bitfields may differ in size, so the bits past `size` have to be
+    // masked out and the last partial byte is never part of a word
+    const int fullByteCount = size / 8;
+
+    // Only popcount is order-independent here, so the words can be loaded
+    // in host byte order regardless of libtorrent's network-order storage.
+    // The loop body is branch-free which lets compilers vectorize it.
+    int result = 0;
+    int i = 0;
+    for (; (i + 8) <= fullByteCount; i += 8)
+    {
+        quint64 bitsWord = 0;
+        quint64 maskWord = 0;
+        std::memcpy(&bitsWord, (bitsData + i), sizeof(bitsWord));
+        std::memcpy(&maskWord, (maskData + i), sizeof(maskWord));
+        result += qPopulationCount(bitsWord & ~maskWord);
+    }
+
+    for (; i < byteCount; ++i)
+    {
+        auto byte = static_cast<quint8>(bitsData[i] & ~maskData[i]);
+        if (i == (byteCount - 1))
+            byte &= trailingByteMask(size);
+        result += qPopulationCount(byte);
+    }
+
+    return result;
+}
+
+QBitArray Utils::Bitfield::toQBitArray(const lt::bitfield &bits)
+{
+    const int size = bits.size();
+    if (size <= 0)
+        return {};
+
+    const auto *data = reinterpret_cast<const uchar *>(bits.data());
+    const int byteCount = bytesForBits(size);
+
+    QByteArray buffer {byteCount, Qt::Uninitialized};
+    for (int i = 0; i < byteCount; ++i)
+        buffer[i] = static_cast<char>(BIT_REVERSE_TABLE[data[i]]);
+
+    // trailing bits beyond `size` are ignored by QBitArray::fromBits()
+    return QBitArray::fromBits(buffer.constData(), size);
+}
@@ -29,6 +29,7 @@
 #include "fs.h"
 
 #include <cerrno>
+#include <cstdio>
 #include <cstring>
 
 #if defined(Q_OS_WIN)
@@ -39,17 +40,24 @@
 #include <sys/types.h>
 
 #if defined(Q_OS_WIN)
+#include <io.h>
 #include <Windows.h>
 #elif defined(Q_OS_MACOS) || defined(Q_OS_FREEBSD) || defined(Q_OS_OPENBSD)
 #include <sys/param.h>
 #include <sys/mount.h>
+#include <unistd.h>
 #elif defined(Q_OS_HAIKU)
 #include <kernel/fs_info.h>
+#include <unistd.h>
 #else
 #include <sys/vfs.h>
 #include <unistd.h>
 #endif
 
+#if !defined(Q_OS_WIN)
+#include <fcntl.h>
+#endif
+
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
@@ -272,6 +280,32 @@ qint64 Utils::Fs::freeDiskSpaceOnPath(const QString &path)
     return QStorageInfo(path).bytesAvailable();
 }
 
+QString Utils::Fs::storageDeviceID(const QString &path)
+{
+    // The path may not exist yet (e.g. a new save path)
+    QString existingPath = QDir::cleanPath(path);
+    while (!QFileInfo::exists(existingPath))
+    {
+        const QString parentPath = QFileInfo(existingPath).path();
+        if (parentPath == existingPath)
+            return {};
+        existingPath = parentPath;
+    }
+
+#if defined(Q_OS_WIN)
+    const std::wstring pathW {toNativePath(existingPath).toStdWString()};
+    auto volumePath = std::make_unique<wchar_t[]>(pathW.length() + 2);
+    if (!::GetVolumePathNameW(pathW.c_str(), volumePath.get(), static_cast<DWORD>(pathW.length() + 2)))
+        return {};
+    return QString::fromWCharArray(volumePath.get()).toLower();
+#else
+    struct stat buf {};
+    if (::stat(QFile::encodeName(existingPath).constData(), &buf) != 0)
+        return {};
+    return QString::number(static_cast<quint64>(buf.st_dev));
+#endif
+}
+
 QString Utils::Fs::branchPath(const QString &filePath, QString *removed)
 {
     QString ret = toUniformPath(filePath);
@@ -332,6 +366,47 @@ bool Utils::Fs::isRegularFile(const QString &path)
     return (st.st_mode & S_IFMT) == S_IFREG;
 }
 
+bool Utils::Fs::syncFile(const QString &path)
+{
+    QFile file {path};
+    if (!file.open(QIODevice::ReadWrite))
+        return false;
+
+#if defined(Q_OS_WIN)
+    const auto handle = reinterpret_cast<HANDLE>(::_get_osfhandle(file.handle()));
+    return ((handle != INVALID_HANDLE_VALUE) && ::FlushFileBuffers(handle));
+#else
+    return (::fsync(file.handle()) == 0);
+#endif
+}
+
+bool Utils::Fs::syncDirectory(const QString &path)
+{
+#if defined(Q_OS_WIN)
+    // Directories can't be flushed on Windows, replaceFile() writes the rename through instead
+    Q_UNUSED(path);
+    return true;
+#else
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    const bool isSynced = (::fsync(fd) == 0);
+    ::close(fd);
+    return isSynced;
+#endif
+}
+
+bool Utils::Fs::replaceFile(const QString &sourcePath, const QString &targetPath)
+{
+#if defined(Q_OS_WIN)
+    return ::MoveFileExW(toNativePath(sourcePath).toStdWString().c_str(), toNativePath(targetPath).toStdWString().c_str()
+        , (MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH));
+#else
+    return (::rename(QFile::encodeName(sourcePath).constData(), QFile::encodeName(targetPath).constData()) == 0);
+#endif
+}
+
 #if !defined Q_OS_HAIKU
 bool Utils::Fs::isNetworkFileSystem(const QString &path)
 {
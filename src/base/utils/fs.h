@@ -59,11 +59,21 @@ namespace Utils::Fs
             , const QString &pad = QLatin1String(" "));
     bool isValidFileSystemName(const QString &name, bool allowSeparators = false);
     qint64 freeDiskSpaceOnPath(const QString &path);
+    // Returns an identifier of the storage device holding 'path' or its nearest
+    // existing parent folder. Returns an empty string if it can't be determined.
+    QString storageDeviceID(const QString &path);
     QString branchPath(const QString &filePath, QString *removed = nullptr);
     bool sameFileNames(const QString &first, const QString &second);
     QString expandPath(const QString &path);
     QString expandPathAbs(const QString &path);
     bool isRegularFile(const QString &path);
+    // Flushes the contents of the file at 'path' to the storage device
+    bool syncFile(const QString &path);
+    // Flushes the directory entries (e.g. a rename) to the storage device
+    bool syncDirectory(const QString &path);
+    // Atomically replaces the file at 'targetPath' with the one at 'sourcePath',
+    // so there is no moment when neither of them exists at 'targetPath'
+    bool replaceFile(const QString &sourcePath, const QString &targetPath);
 
     bool smartRemoveEmptyFolderTree(const QString &path);
     bool forceRemove(const QString &filePath);
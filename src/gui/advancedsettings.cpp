@@ -71,8 +71,13 @@ namespace
         NETWORK_IFACE_ADDRESS,
         // behavior
         SAVE_RESUME_DATA_INTERVAL,
+        SHUTDOWN_TIMEOUT,
+        MEMORY_BUDGET,
+        METADATA_UNLOAD_DELAY,
         CONFIRM_RECHECK_TORRENT,
         RECHECK_COMPLETED,
+        MAX_CONCURRENT_MOVES_PER_DEVICE,
+        MAX_CONCURRENT_CHECKS_PER_DEVICE,
         // UI related
         LIST_REFRESH,
         RESOLVE_HOSTS,
@@ -232,6 +237,12 @@ void AdvancedSettings::saveAdvancedSettings()
     session->setSocketBacklogSize(m_spinBoxSocketBacklogSize.value());
     // Save resume data interval
     session->setSaveResumeDataInterval(m_spinBoxSaveResumeDataInterval.value());
+    // Shutdown timeout
+    session->setShutdownTimeout(m_spinBoxShutdownTimeout.value());
+    // Memory budget
+    session->setMemoryBudget(m_spinBoxMemoryBudget.value());
+    // Metadata unload delay
+    session->setMetadataUnloadDelay(m_spinBoxMetadataUnloadDelay.value());
     // Outgoing ports
     session->setOutgoingPortsMin(m_spinBoxOutgoingPortsMin.value());
     session->setOutgoingPortsMax(m_spinBoxOutgoingPortsMax.value());
@@ -253,6 +264,10 @@ void AdvancedSettings::saveAdvancedSettings()
     session->setBlockPeersOnPrivilegedPorts(m_checkBoxBlockPeersOnPrivilegedPorts.isChecked());
     // Recheck torrents on completion
     pref->recheckTorrentsOnCompletion(m_checkBoxRecheckCompleted.isChecked());
+    // Concurrent storage moves per device
+    session->setMaxConcurrentMovesPerDevice(m_spinBoxMaxConcurrentMovesPerDevice.value());
+    // Concurrent rechecks per device
+    session->setMaxConcurrentChecksPerDevice(m_spinBoxMaxConcurrentChecksPerDevice.value());
     // Transfer list refresh interval
     session->setRefreshInterval(m_spinBoxListRefresh.value());
     // Peer resolution
@@ -554,6 +569,26 @@ void AdvancedSettings::loadAdvancedSettings()
         , this, &AdvancedSettings::updateSaveResumeDataIntervalSuffix);
     updateSaveResumeDataIntervalSuffix(m_spinBoxSaveResumeDataInterval.value());
     addRow(SAVE_RESUME_DATA_INTERVAL, tr("Save resume data interval", "How often the fastresume file is saved."), &m_spinBoxSaveResumeDataInterval);
+    // Shutdown timeout
+    m_spinBoxShutdownTimeout.setMinimum(1);
+    m_spinBoxShutdownTimeout.setMaximum(3600);
+    m_spinBoxShutdownTimeout.setValue(session->shutdownTimeout());
+    m_spinBoxShutdownTimeout.setSuffix(tr(" s", " seconds"));
+    addRow(SHUTDOWN_TIMEOUT, tr("Resume data saving timeout on exit"), &m_spinBoxShutdownTimeout);
+    // Memory budget
+    m_spinBoxMemoryBudget.setMinimum(0);
+    m_spinBoxMemoryBudget.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxMemoryBudget.setValue(session->memoryBudget());
+    m_spinBoxMemoryBudget.setSuffix(tr(" MiB"));
+    m_spinBoxMemoryBudget.setSpecialValueText(tr("Disabled"));
+    addRow(MEMORY_BUDGET, tr("Memory budget"), &m_spinBoxMemoryBudget);
+    // Metadata unload delay
+    m_spinBoxMetadataUnloadDelay.setMinimum(0);
+    m_spinBoxMetadataUnloadDelay.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxMetadataUnloadDelay.setValue(session->metadataUnloadDelay());
+    m_spinBoxMetadataUnloadDelay.setSuffix(tr(" min", " minutes"));
+    m_spinBoxMetadataUnloadDelay.setSpecialValueText(tr("Disabled"));
+    addRow(METADATA_UNLOAD_DELAY, tr("Unload metadata of seeds inactive for"), &m_spinBoxMetadataUnloadDelay);
     // Outgoing port Min
     m_spinBoxOutgoingPortsMin.setMinimum(0);
     m_spinBoxOutgoingPortsMin.setMaximum(65535);
@@ -613,6 +648,18 @@ void AdvancedSettings::loadAdvancedSettings()
     // Recheck completed torrents
     m_checkBoxRecheckCompleted.setChecked(pref->recheckTorrentsOnCompletion());
     addRow(RECHECK_COMPLETED, tr("Recheck torrents on completion"), &m_checkBoxRecheckCompleted);
+    // Concurrent storage moves per device
+    m_spinBoxMaxConcurrentMovesPerDevice.setMinimum(1);
+    m_spinBoxMaxConcurrentMovesPerDevice.setMaximum(64);
+    m_spinBoxMaxConcurrentMovesPerDevice.setValue(session->maxConcurrentMovesPerDevice());
+    addRow(MAX_CONCURRENT_MOVES_PER_DEVICE, tr("Concurrent torrent moves per storage device")
+        , &m_spinBoxMaxConcurrentMovesPerDevice);
+    // Concurrent rechecks per device
+    m_spinBoxMaxConcurrentChecksPerDevice.setMinimum(1);
+    m_spinBoxMaxConcurrentChecksPerDevice.setMaximum(64);
+    m_spinBoxMaxConcurrentChecksPerDevice.setValue(session->maxConcurrentChecksPerDevice());
+    addRow(MAX_CONCURRENT_CHECKS_PER_DEVICE, tr("Concurrent torrent rechecks per storage device")
+        , &m_spinBoxMaxConcurrentChecksPerDevice);
     // Transfer list refresh interval
     m_spinBoxListRefresh.setMinimum(30);
     m_spinBoxListRefresh.setMaximum(99999);
@@ -528,6 +528,8 @@ OptionsDialog::OptionsDialog(QWidget *parent)
     connect(m_ui->textWebUICustomHTTPHeaders, &QPlainTextEdit::textChanged, this, &OptionsDialog::enableApplyButton);
     connect(m_ui->groupEnableReverseProxySupport, &QGroupBox::toggled, this, &ThisType::enableApplyButton);
     connect(m_ui->textTrustedReverseProxiesList, &QLineEdit::textChanged, this, &ThisType::enableApplyButton);
+    connect(m_ui->groupWebUIMetrics, &QGroupBox::toggled, this, &ThisType::enableApplyButton);
+    connect(m_ui->checkWebUIMetricsAuth, &QAbstractButton::toggled, this, &ThisType::enableApplyButton);
 #endif // DISABLE_WEBUI
 
     // RSS tab
@@ -1098,6 +1100,9 @@ void OptionsDialog::saveOptions()
         // Reverse proxy
         pref->setWebUIReverseProxySupportEnabled(m_ui->groupEnableReverseProxySupport->isChecked());
         pref->setWebUITrustedReverseProxiesList(m_ui->textTrustedReverseProxiesList->text());
+        // OpenMetrics endpoint
+        pref->setWebUIMetricsEnabled(m_ui->groupWebUIMetrics->isChecked());
+        pref->setWebUIMetricsAuthEnabled(m_ui->checkWebUIMetricsAuth->isChecked());
     }
     // End Web UI
     // End preferences
@@ -1501,6 +1506,9 @@ void OptionsDialog::loadOptions()
     // Reverse proxy
     m_ui->groupEnableReverseProxySupport->setChecked(pref->isWebUIReverseProxySupportEnabled());
     m_ui->textTrustedReverseProxiesList->setText(pref->getWebUITrustedReverseProxiesList());
+    // OpenMetrics endpoint
+    m_ui->groupWebUIMetrics->setChecked(pref->isWebUIMetricsEnabled());
+    m_ui->checkWebUIMetricsAuth->setChecked(pref->isWebUIMetricsAuthEnabled());
     // End Web UI preferences
 }
 
@@ -307,7 +307,7 @@ void PeerListWidget::banSelectedPeers()
     // Store selected rows first as selected peers may disconnect
     const QModelIndexList selectedIndexes = selectionModel()->selectedRows();
 
-    QVector<QString> selectedIPs;
+    QStringList selectedIPs;
     selectedIPs.reserve(selectedIndexes.size());
 
     for (const QModelIndex &index : selectedIndexes)
@@ -322,11 +322,9 @@ void PeerListWidget::banSelectedPeers()
         , tr("Are you sure you want to permanently ban the selected peers?"));
     if (btn != QMessageBox::Yes) return;
 
+    BitTorrent::Session::instance()->banIPs(selectedIPs);
     for (const QString &ip : selectedIPs)
-    {
-        BitTorrent::Session::instance()->banIP(ip);
         LogMsg(tr("Peer \"%1\" is manually banned").arg(ip));
-    }
     // Refresh list
     loadPeers(m_properties->getCurrentTorrent());
 }
@@ -444,7 +442,7 @@ void PeerListWidget::updatePeer(const BitTorrent::Torrent *torrent, const BitTor
     }
 
     const int row = (*itemIter)->row();
-    const bool hideValues = Preferences::instance()->getHideZeroValues();
+    const bool hideValues = Preferences::instance()->snapshot().hideZeroValues;
 
     setModelData(row, PeerListColumns::CONNECTION, peer.connectionType(), peer.connectionType());
     setModelData(row, PeerListColumns::FLAGS, peer.flags(), peer.flags(), {}, peer.flagsDescription());
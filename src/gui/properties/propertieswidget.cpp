@@ -342,6 +342,9 @@ void PropertiesWidget::loadTorrentInfos(BitTorrent::Torrent *const torrent)
     m_piecesAvailability->setTorrent(m_torrent);
     if (!m_torrent) return;
 
+    // The file list and pieces need the complete metadata
+    m_torrent->loadMetadata();
+
     // Save path
     updateSavePath(m_torrent);
     // Info hashes
@@ -432,6 +435,13 @@ void PropertiesWidget::loadDynamicData()
     // Refresh only if the torrent handle is valid and visible
     if (!m_torrent || (m_state != VISIBLE)) return;
 
+    // The metadata of the displayed torrent could be unloaded meanwhile
+    if (m_torrent->isMetadataUnloaded())
+    {
+        loadTorrentInfos(m_torrent);
+        return;
+    }
+
     // Transfer infos
     switch (m_ui->stackedProperties->currentIndex())
     {
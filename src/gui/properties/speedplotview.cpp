@@ -99,66 +99,8 @@ namespace
     }
 }
 
-SpeedPlotView::Averager::Averager(const milliseconds duration, const milliseconds resolution)
-    : m_resolution {resolution}
-    , m_maxDuration {duration}
-    , m_sink {static_cast<DataCircularBuffer::size_type>(duration / resolution)}
-{
-    m_lastSampleTime.start();
-}
-
-bool SpeedPlotView::Averager::push(const SampleData &sampleData)
-{
-    // Accumulator overflow will be hit in worst case on longest used averaging span,
-    // defined by resolution. Maximum resolution is 144 seconds
-    // Using int32 for accumulator we get overflow when transfer speed reaches 2^31/144 ~~ 14.2 MBytes/s.
-    // With quint64 this speed limit is 2^64/144 ~~ 114 PBytes/s.
-    // This speed is inaccessible to an ordinary user.
-    ++m_counter;
-    for (int id = UP; id < NB_GRAPHS; ++id)
-        m_accumulator[id] += sampleData[id];
-
-    // system may go to sleep, that can cause very big elapsed interval
-    const milliseconds updateInterval {static_cast<int64_t>(BitTorrent::Session::instance()->refreshInterval() * 1.25)};
-    const milliseconds maxElapsed {std::max(updateInterval, m_resolution)};
-    const milliseconds elapsed {std::min(milliseconds {m_lastSampleTime.elapsed()}, maxElapsed)};
-    if (elapsed < m_resolution)
-        return false; // still accumulating
-
-    // it is time final averaging calculations
-    for (int id = UP; id < NB_GRAPHS; ++id)
-        m_accumulator[id] /= m_counter;
-
-    m_currentDuration += elapsed;
-
-    // remove extra data from front if we reached max duration
-    if (m_currentDuration > m_maxDuration)
-    {
-        // once we go above the max duration never go below that
-        // otherwise it will cause empty space in graphs
-        while (!m_sink.empty()
-               && ((m_currentDuration - m_sink.front().duration) >= m_maxDuration))
-        {
-            m_currentDuration -= m_sink.front().duration;
-            m_sink.pop_front();
-        }
-    }
-
-    // now flush out averaged data
-    Q_ASSERT(m_sink.size() < m_sink.capacity());
-    m_sink.push_back({elapsed, m_accumulator});
-
-    // reset
-    m_accumulator = {};
-    m_counter = 0;
-    m_lastSampleTime.restart();
-    return true;
-}
-
-const SpeedPlotView::DataCircularBuffer &SpeedPlotView::Averager::data() const
-{
-    return m_sink;
-}
+static_assert(static_cast<int>(SpeedPlotView::NB_GRAPHS) == static_cast<int>(BitTorrent::TransferHistory::RateCount)
+    , "Graphs should match the rates of transfer history");
 
 SpeedPlotView::SpeedPlotView(QWidget *parent)
     : QGraphicsView {parent}
@@ -192,6 +134,9 @@ SpeedPlotView::SpeedPlotView(QWidget *parent)
     greenPen.setStyle(Qt::DotLine);
     m_properties[TRACKER_UP] = GraphProperties(tr("Tracker Upload"), bluePen);
     m_properties[TRACKER_DOWN] = GraphProperties(tr("Tracker Download"), greenPen);
+
+    connect(BitTorrent::Session::instance()->transferHistory(), &BitTorrent::TransferHistory::samplesAdded
+        , this, &SpeedPlotView::handleSamplesAdded);
 }
 
 void SpeedPlotView::setGraphEnable(GraphID id, bool enable)
@@ -200,18 +145,10 @@ void SpeedPlotView::setGraphEnable(GraphID id, bool enable)
     viewport()->update();
 }
 
-void SpeedPlotView::pushPoint(const SpeedPlotView::SampleData &point)
+void SpeedPlotView::handleSamplesAdded(const BitTorrent::TransferHistory::Span span)
 {
-    for (Averager *averager : {&m_averager5Min, &m_averager30Min
-                                , &m_averager6Hour, &m_averager12Hour
-                                , &m_averager24Hour})
-    {
-        if (averager->push(point))
-        {
-            if (m_currentAverager == averager)
-                viewport()->update();
-        }
-    }
+    if (span == m_currentSpan)
+        viewport()->update();
 }
 
 void SpeedPlotView::setPeriod(const TimePeriod period)
@@ -220,45 +157,45 @@ void SpeedPlotView::setPeriod(const TimePeriod period)
     {
     case SpeedPlotView::MIN1:
         m_currentMaxDuration = 1min;
-        m_currentAverager = &m_averager5Min;
+        m_currentSpan = BitTorrent::TransferHistory::Span5Min;
         break;
     case SpeedPlotView::MIN5:
         m_currentMaxDuration = 5min;
-        m_currentAverager = &m_averager5Min;
+        m_currentSpan = BitTorrent::TransferHistory::Span5Min;
         break;
     case SpeedPlotView::MIN30:
         m_currentMaxDuration = 30min;
-        m_currentAverager = &m_averager30Min;
+        m_currentSpan = BitTorrent::TransferHistory::Span30Min;
         break;
     case SpeedPlotView::HOUR3:
         m_currentMaxDuration = 3h;
-        m_currentAverager = &m_averager6Hour;
+        m_currentSpan = BitTorrent::TransferHistory::Span6Hour;
         break;
     case SpeedPlotView::HOUR6:
         m_currentMaxDuration = 6h;
-        m_currentAverager = &m_averager6Hour;
+        m_currentSpan = BitTorrent::TransferHistory::Span6Hour;
         break;
     case SpeedPlotView::HOUR12:
         m_currentMaxDuration = 12h;
-        m_currentAverager = &m_averager12Hour;
+        m_currentSpan = BitTorrent::TransferHistory::Span12Hour;
         break;
     case SpeedPlotView::HOUR24:
         m_currentMaxDuration = 24h;
-        m_currentAverager = &m_averager24Hour;
+        m_currentSpan = BitTorrent::TransferHistory::Span24Hour;
         break;
     }
 
     viewport()->update();
 }
 
-const SpeedPlotView::DataCircularBuffer &SpeedPlotView::currentData() const
+const BitTorrent::TransferHistory::SampleBuffer &SpeedPlotView::currentData() const
 {
-    return m_currentAverager->data();
+    return BitTorrent::Session::instance()->transferHistory()->samples(m_currentSpan);
 }
 
 quint64 SpeedPlotView::maxYValue() const
 {
-    const DataCircularBuffer &queue = currentData();
+    const BitTorrent::TransferHistory::SampleBuffer &queue = currentData();
 
     quint64 maxYValue = 0;
     for (int id = UP; id < NB_GRAPHS; ++id)
@@ -270,8 +207,8 @@ quint64 SpeedPlotView::maxYValue() const
         milliseconds duration {0ms};
         for (int i = static_cast<int>(queue.size()) - 1; i >= 0; --i)
         {
-            maxYValue = std::max(maxYValue, queue[i].data[id]);
-            duration += queue[i].duration;
+            maxYValue = std::max(maxYValue, queue[i].rates[id]);
+            duration += milliseconds {queue[i].duration};
             if (duration >= m_currentMaxDuration)
                 break;
         }
@@ -347,10 +284,10 @@ void SpeedPlotView::paintEvent(QPaintEvent *)
     painter.setClipping(true);
     painter.setClipRect(rect);
 
-    const DataCircularBuffer &queue = currentData();
+    const BitTorrent::TransferHistory::SampleBuffer &queue = currentData();
 
     // last point will be drawn at x=0, so we don't need it in the calculation of xTickSize
-    const milliseconds lastDuration {queue.empty() ? 0ms : queue.back().duration};
+    const milliseconds lastDuration {queue.empty() ? 0 : queue.back().duration};
     const double xTickSize = static_cast<double>(rect.width()) / (m_currentMaxDuration - lastDuration).count();
     const double yMultiplier = (niceScale.arg == 0) ? 0 : (static_cast<double>(rect.height()) / niceScale.sizeInBytes());
 
@@ -365,10 +302,10 @@ void SpeedPlotView::paintEvent(QPaintEvent *)
         for (int i = static_cast<int>(queue.size()) - 1; i >= 0; --i)
         {
             const int newX = rect.right() - (duration.count() * xTickSize);
-            const int newY = rect.bottom() - (queue[i].data[id] * yMultiplier);
+            const int newY = rect.bottom() - (queue[i].rates[id] * yMultiplier);
             points.push_back(QPoint(newX, newY));
 
-            duration += queue[i].duration;
+            duration += milliseconds {queue[i].duration};
             if (duration >= m_currentMaxDuration)
                 break;
         }
@@ -29,17 +29,13 @@
 
 #pragma once
 
-#include <array>
 #include <chrono>
 
-#ifndef Q_MOC_RUN
-#include <boost/circular_buffer.hpp>
-#endif
-
-#include <QElapsedTimer>
 #include <QGraphicsView>
 #include <QMap>
 
+#include "base/bittorrent/transferhistory.h"
+
 class QPen;
 
 using std::chrono::milliseconds;
@@ -77,46 +73,15 @@ public:
         HOUR24
     };
 
-    using SampleData = std::array<quint64, NB_GRAPHS>;
-
     explicit SpeedPlotView(QWidget *parent = nullptr);
 
     void setGraphEnable(GraphID id, bool enable);
     void setPeriod(TimePeriod period);
 
-    void pushPoint(const SampleData &point);
-
 protected:
     void paintEvent(QPaintEvent *event) override;
 
 private:
-    struct Sample
-    {
-        milliseconds duration;
-        SampleData data;
-    };
-
-    using DataCircularBuffer = boost::circular_buffer<Sample>;
-
-    class Averager
-    {
-    public:
-        Averager(milliseconds duration, milliseconds resolution);
-
-        bool push(const SampleData &sampleData); // returns true if there is new data to display
-
-        const DataCircularBuffer &data() const;
-
-    private:
-        const milliseconds m_resolution;
-        const milliseconds m_maxDuration;
-        milliseconds m_currentDuration {0ms};
-        int m_counter = 0;
-        SampleData m_accumulator {};
-        DataCircularBuffer m_sink {};
-        QElapsedTimer m_lastSampleTime;
-    };
-
     struct GraphProperties
     {
         GraphProperties();
@@ -127,15 +92,12 @@ private:
         bool enable;
     };
 
+    void handleSamplesAdded(BitTorrent::TransferHistory::Span span);
+
     quint64 maxYValue() const;
-    const DataCircularBuffer &currentData() const;
-
-    Averager m_averager5Min {5min, 1s};
-    Averager m_averager30Min {30min, 6s};
-    Averager m_averager6Hour {6h, 36s};
-    Averager m_averager12Hour {12h, 72s};
-    Averager m_averager24Hour {24h, 144s};
-    Averager *m_currentAverager {&m_averager5Min};
+    const BitTorrent::TransferHistory::SampleBuffer &currentData() const;
+
+    BitTorrent::TransferHistory::Span m_currentSpan = BitTorrent::TransferHistory::Span5Min;
 
     QMap<GraphID, GraphProperties> m_properties;
     milliseconds m_currentMaxDuration;
@@ -36,7 +36,6 @@
 #include <QVBoxLayout>
 
 #include "base/bittorrent/session.h"
-#include "base/bittorrent/sessionstatus.h"
 #include "base/preferences.h"
 #include "propertieswidget.h"
 #include "speedplotview.h"
@@ -110,7 +109,6 @@ SpeedWidget::SpeedWidget(PropertiesWidget *parent)
     m_hlayout->addWidget(m_graphsButton);
 
     m_plot = new SpeedPlotView(this);
-    connect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated, this, &SpeedWidget::update);
 
     m_layout->addLayout(m_hlayout);
     m_layout->addWidget(m_plot);
@@ -127,25 +125,6 @@ SpeedWidget::~SpeedWidget()
     qDebug("SpeedWidget::~SpeedWidget() EXIT");
 }
 
-void SpeedWidget::update()
-{
-    const BitTorrent::SessionStatus &btStatus = BitTorrent::Session::instance()->status();
-
-    SpeedPlotView::SampleData sampleData;
-    sampleData[SpeedPlotView::UP] = btStatus.uploadRate;
-    sampleData[SpeedPlotView::DOWN] = btStatus.downloadRate;
-    sampleData[SpeedPlotView::PAYLOAD_UP] = btStatus.payloadUploadRate;
-    sampleData[SpeedPlotView::PAYLOAD_DOWN] = btStatus.payloadDownloadRate;
-    sampleData[SpeedPlotView::OVERHEAD_UP] = btStatus.ipOverheadUploadRate;
-    sampleData[SpeedPlotView::OVERHEAD_DOWN] = btStatus.ipOverheadDownloadRate;
-    sampleData[SpeedPlotView::DHT_UP] = btStatus.dhtUploadRate;
-    sampleData[SpeedPlotView::DHT_DOWN] = btStatus.dhtDownloadRate;
-    sampleData[SpeedPlotView::TRACKER_UP] = btStatus.trackerUploadRate;
-    sampleData[SpeedPlotView::TRACKER_DOWN] = btStatus.trackerDownloadRate;
-
-    m_plot->pushPoint(sampleData);
-}
-
 void SpeedWidget::onPeriodChange(int period)
 {
     m_plot->setPeriod(static_cast<SpeedPlotView::TimePeriod>(period));
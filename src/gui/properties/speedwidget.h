@@ -63,7 +63,6 @@ public:
 private slots:
     void onPeriodChange(int period);
     void onGraphChange(int id);
-    void update();
 
 private:
     void loadSettings();
@@ -621,7 +621,7 @@ void AutomatedRssDownloader::updateMatchingArticles()
 
             QStringList matchingArticles;
             for (const auto article : asConst(feed->articles()))
-                if (rule.matches(article->data()))
+                if (rule.matches(article->header()))
                     matchingArticles << article->title();
             if (!matchingArticles.isEmpty())
                 addFeedArticlesToTree(feed, matchingArticles);
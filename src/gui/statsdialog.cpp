@@ -30,11 +30,16 @@
 
 #include <algorithm>
 
+#include <QTreeWidget>
+
 #include "base/bittorrent/cachestatus.h"
+#include "base/bittorrent/recheckscheduler.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
 #include "base/bittorrent/torrent.h"
 #include "base/global.h"
+#include "base/latencystats.h"
+#include "base/memorystats.h"
 #include "base/utils/misc.h"
 #include "base/utils/string.h"
 #include "ui_statsdialog.h"
@@ -42,6 +47,11 @@
 
 #define SETTINGS_KEY(name) "StatisticsDialog/" name
 
+namespace
+{
+    const qint64 MEMORY_STATS_REFRESH_INTERVAL = 10000; // milliseconds
+}
+
 StatsDialog::StatsDialog(QWidget *parent)
     : QDialog(parent)
     , m_ui(new Ui::StatsDialog)
@@ -60,6 +70,9 @@ StatsDialog::StatsDialog(QWidget *parent)
     m_ui->labelCacheHits->hide();
 #endif
 
+    if (!LatencyStats::isEnabled())
+        m_ui->groupLatency->hide();
+
     Utils::Gui::resize(this, m_storeDialogSize);
     show();
 }
@@ -114,4 +127,78 @@ void StatsDialog::update()
 
     // Total connected peers
     m_ui->labelPeers->setText(QString::number(ss.peersCount));
+
+    // Forced rechecks
+    const BitTorrent::RecheckStatus rs = BitTorrent::Session::instance()->recheckStatus();
+    const int batchCount = rs.queuedCount + rs.runningCount + rs.finishedCount;
+    m_ui->labelRecheckTorrents->setText(tr("%1 of %2 (%3 running)", "2 of 10 (1 running)")
+        .arg(QString::number(rs.finishedCount), QString::number(batchCount), QString::number(rs.runningCount)));
+    m_ui->labelRecheckProgress->setText(tr("%1 of %2", "1.5 GiB of 4 GiB")
+        .arg(Utils::Misc::friendlyUnit(rs.checkedSize), Utils::Misc::friendlyUnit(rs.totalSize)));
+    m_ui->labelRecheckSpeed->setText(Utils::Misc::friendlyUnit(rs.speed, true));
+    m_ui->labelRecheckETA->setText(Utils::Misc::userFriendlyDuration(rs.eta));
+
+    // The accounting walks all the torrents and articles, so it is refreshed less often
+    if (!m_memoryStatsTimer.isValid() || m_memoryStatsTimer.hasExpired(MEMORY_STATS_REFRESH_INTERVAL))
+    {
+        updateMemoryStats();
+        m_memoryStatsTimer.start();
+    }
+
+    if (LatencyStats::isEnabled())
+        updateLatencyStats();
+}
+
+void StatsDialog::updateMemoryStats()
+{
+    QVector<MemoryStats::Entry> rows = MemoryStats::snapshot();
+    rows.append({{}, tr("Total of the above"), MemoryStats::totalSize(rows)});
+    const qint64 residentSize = MemoryStats::processResidentSize();
+    if (residentSize >= 0)
+        rows.append({{}, tr("Process resident memory"), residentSize});
+    const qint64 privateSize = MemoryStats::processPrivateSize();
+    if (privateSize >= 0)
+        rows.append({{}, tr("Process private memory"), privateSize});
+
+    QTreeWidget *tree = m_ui->treeMemory;
+    while (tree->topLevelItemCount() > rows.size())
+        delete tree->takeTopLevelItem(tree->topLevelItemCount() - 1);
+    while (tree->topLevelItemCount() < rows.size())
+        tree->addTopLevelItem(new QTreeWidgetItem);
+
+    for (int i = 0; i < rows.size(); ++i)
+    {
+        QTreeWidgetItem *item = tree->topLevelItem(i);
+        item->setText(0, rows[i].name);
+        item->setText(1, Utils::Misc::friendlyUnit(rows[i].size));
+    }
+}
+
+void StatsDialog::updateLatencyStats()
+{
+    const auto formatDuration = [](const quint64 microseconds) -> QString
+    {
+        if (microseconds < 1000)
+            return tr("%1 µs", "18 microseconds").arg(microseconds);
+        return tr("%1 ms", "18 milliseconds").arg(Utils::String::fromDouble((microseconds / 1000.), 1));
+    };
+
+    const QVector<LatencyStats::HistogramSnapshot> snapshots = LatencyStats::snapshots();
+    QTreeWidget *tree = m_ui->treeLatency;
+    while (tree->topLevelItemCount() > snapshots.size())
+        delete tree->takeTopLevelItem(tree->topLevelItemCount() - 1);
+    while (tree->topLevelItemCount() < snapshots.size())
+        tree->addTopLevelItem(new QTreeWidgetItem);
+
+    for (int i = 0; i < snapshots.size(); ++i)
+    {
+        const LatencyStats::HistogramSnapshot &snapshot = snapshots[i];
+        QTreeWidgetItem *item = tree->topLevelItem(i);
+        item->setText(0, snapshot.name);
+        item->setText(1, QString::number(snapshot.count));
+        item->setText(2, formatDuration(snapshot.mean));
+        item->setText(3, formatDuration(snapshot.p50));
+        item->setText(4, formatDuration(snapshot.p99));
+        item->setText(5, formatDuration(snapshot.max));
+    }
 }
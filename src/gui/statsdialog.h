@@ -29,6 +29,7 @@
 #pragma once
 
 #include <QDialog>
+#include <QElapsedTimer>
 
 #include "base/settingvalue.h"
 
@@ -50,6 +51,10 @@ private slots:
     void update();
 
 private:
+    void updateMemoryStats();
+    void updateLatencyStats();
+
     Ui::StatsDialog *m_ui;
     SettingValue<QSize> m_storeDialogSize;
+    QElapsedTimer m_memoryStatsTimer;
 };
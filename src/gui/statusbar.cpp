@@ -148,6 +148,7 @@ StatusBar::StatusBar(QWidget *parent)
     m_DHTLbl->setVisible(session->isDHTEnabled());
     refresh();
     connect(session, &BitTorrent::Session::statsUpdated, this, &StatusBar::refresh);
+    connect(session, &BitTorrent::Session::startupFinished, this, &QStatusBar::clearMessage);
 }
 
 StatusBar::~StatusBar()
@@ -237,6 +238,17 @@ void StatusBar::refresh()
     updateConnectionStatus();
     updateDHTNodesNumber();
     updateSpeedLabels();
+    updateStartupProgress();
+}
+
+void StatusBar::updateStartupProgress()
+{
+    const BitTorrent::Session *session = BitTorrent::Session::instance();
+    if (session->isStartupFinished())
+        return;
+
+    showMessage(tr("Loading torrents: %1/%2")
+        .arg(QString::number(session->startupLoadedTorrentsCount()), QString::number(session->startupTorrentsCount())));
 }
 
 void StatusBar::updateAltSpeedsBtn(bool alternative)
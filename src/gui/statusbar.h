@@ -63,6 +63,7 @@ private:
     void updateConnectionStatus();
     void updateDHTNodesNumber();
     void updateSpeedLabels();
+    void updateStartupProgress();
 
     QPushButton *m_dlSpeedLbl;
     QPushButton *m_upSpeedLbl;
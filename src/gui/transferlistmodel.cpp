@@ -38,6 +38,7 @@
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrent.h"
 #include "base/global.h"
+#include "base/latencystats.h"
 #include "base/preferences.h"
 #include "base/unicodestrings.h"
 #include "base/utils/fs.h"
@@ -618,6 +619,9 @@ void TransferListModel::handleTorrentStatusUpdated(BitTorrent::Torrent *const to
 
 void TransferListModel::handleTorrentsUpdated(const QVector<BitTorrent::Torrent *> &torrents)
 {
+    // Includes the filtering and sorting done by the proxy model
+    QBT_MEASURE_LATENCY("gui/transferListRefresh");
+
     const int columns = (columnCount() - 1);
 
     if (torrents.size() <= (m_torrentList.size() * 0.5))
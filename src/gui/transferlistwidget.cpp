@@ -1172,7 +1172,7 @@ void TransferListWidget::applyTrackerFilter(const QSet<BitTorrent::TorrentID> &t
 
 void TransferListWidget::applyNameFilter(const QString &name)
 {
-    const QString pattern = (Preferences::instance()->getRegexAsFilteringPatternForTransferList()
+    const QString pattern = (Preferences::instance()->snapshot().regexAsFilteringPatternForTransferList
                 ? name : Utils::String::wildcardToRegexPattern(name));
     m_sortFilterModel->setFilterRegularExpression(QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption));
 }
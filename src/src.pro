@@ -35,6 +35,10 @@ nowebui {
     DEFINES += DISABLE_WEBUI
 }
 
+latencystats {
+    DEFINES += QBT_LATENCY_STATS
+}
+
 stacktrace {
     DEFINES += STACKTRACE
     win32 {
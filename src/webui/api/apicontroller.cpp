@@ -43,9 +43,9 @@ APIController::APIController(ISessionManager *sessionManager, QObject *parent)
 {
 }
 
-QVariant APIController::run(const QString &action, const StringMap &params, const DataMap &data)
+APIResult APIController::run(const QString &action, const StringMap &params, const DataMap &data)
 {
-    m_result.clear(); // clear result
+    m_result = {}; // clear result
     m_params = params;
     m_data = data;
 
@@ -85,15 +85,21 @@ void APIController::requireParams(const QVector<QString> &requiredParams) const
 
 void APIController::setResult(const QString &result)
 {
-    m_result = result;
+    m_result.data = result;
+}
+
+void APIController::setResult(const QByteArray &result, const QString &mimeType)
+{
+    m_result.data = result;
+    m_result.mimeType = mimeType;
 }
 
 void APIController::setResult(const QJsonArray &result)
 {
-    m_result = QJsonDocument(result);
+    m_result.data = QJsonDocument(result);
 }
 
 void APIController::setResult(const QJsonObject &result)
 {
-    m_result = QJsonDocument(result);
+    m_result.data = QJsonDocument(result);
 }
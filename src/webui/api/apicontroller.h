@@ -29,16 +29,22 @@
 #pragma once
 
 #include <QObject>
+#include <QString>
 #include <QVariant>
 #include <QtContainerFwd>
 
-class QString;
-
 struct ISessionManager;
 
 using DataMap = QHash<QString, QByteArray>;
 using StringMap = QHash<QString, QString>;
 
+struct APIResult
+{
+    QVariant data;
+    // content type of binary data
+    QString mimeType;
+};
+
 class APIController : public QObject
 {
     Q_OBJECT
@@ -52,7 +58,7 @@ class APIController : public QObject
 public:
     explicit APIController(ISessionManager *sessionManager, QObject *parent = nullptr);
 
-    QVariant run(const QString &action, const StringMap &params, const DataMap &data = {});
+    APIResult run(const QString &action, const StringMap &params, const DataMap &data = {});
 
     ISessionManager *sessionManager() const;
 
@@ -62,6 +68,7 @@ protected:
     void requireParams(const QVector<QString> &requiredParams) const;
 
     void setResult(const QString &result);
+    void setResult(const QByteArray &result, const QString &mimeType);
     void setResult(const QJsonArray &result);
     void setResult(const QJsonObject &result);
 
@@ -69,5 +76,5 @@ private:
     ISessionManager *m_sessionManager;
     StringMap m_params;
     DataMap m_data;
-    QVariant m_result;
+    APIResult m_result;
 };
@@ -47,6 +47,8 @@
 #include "base/bittorrent/scheduler/bandwidthscheduler.h"
 #include "base/bittorrent/session.h"
 #include "base/global.h"
+#include "base/latencystats.h"
+#include "base/memorystats.h"
 #include "base/net/portforwarder.h"
 #include "base/net/proxyconfigurationmanager.h"
 #include "base/preferences.h"
@@ -69,7 +71,7 @@ void AppController::webapiVersionAction()
 
 void AppController::versionAction()
 {
-    setResult(QBT_VERSION);
+    setResult(QLatin1String(QBT_VERSION));
 }
 
 void AppController::buildInfoAction()
@@ -81,7 +83,8 @@ void AppController::buildInfoAction()
         {"boost", Utils::Misc::boostVersionString()},
         {"openssl", Utils::Misc::opensslVersionString()},
         {"zlib", Utils::Misc::zlibVersionString()},
-        {"bitness", (QT_POINTER_SIZE * 8)}
+        {"bitness", (QT_POINTER_SIZE * 8)},
+        {"latency_stats", LatencyStats::isEnabled()}
     };
     setResult(versions);
 }
@@ -262,6 +265,9 @@ void AppController::preferencesAction()
     // Reverse proxy
     data["web_ui_reverse_proxy_enabled"] = pref->isWebUIReverseProxySupportEnabled();
     data["web_ui_reverse_proxies_list"] = pref->getWebUITrustedReverseProxiesList();
+    // OpenMetrics endpoint
+    data["web_ui_metrics_enabled"] = pref->isWebUIMetricsEnabled();
+    data["web_ui_metrics_auth_enabled"] = pref->isWebUIMetricsAuthEnabled();
     // Update my dynamic domain name
     data["dyndns_enabled"] = pref->isDynDNSEnabled();
     data["dyndns_service"] = pref->getDynDNSService();
@@ -285,12 +291,19 @@ void AppController::preferencesAction()
     data["current_interface_address"] = BitTorrent::Session::instance()->networkInterfaceAddress();
     // Save resume data interval
     data["save_resume_data_interval"] = session->saveResumeDataInterval();
+    data["shutdown_timeout"] = session->shutdownTimeout();
+    data["memory_budget"] = session->memoryBudget();
+    data["metadata_unload_delay"] = session->metadataUnloadDelay();
     // Recheck completed torrents
     data["recheck_completed_torrents"] = pref->recheckTorrentsOnCompletion();
     // Resolve peer countries
     data["resolve_peer_countries"] = pref->resolvePeerCountries();
     // Reannounce to all trackers when ip/port changed
     data["reannounce_when_address_changed"] = session->isReannounceWhenAddressChangedEnabled();
+    // Concurrent storage moves per device
+    data["max_concurrent_moves_per_device"] = session->maxConcurrentMovesPerDevice();
+    // Concurrent rechecks per device
+    data["max_concurrent_checks_per_device"] = session->maxConcurrentChecksPerDevice();
 
     // libtorrent preferences
     // Async IO threads
@@ -690,6 +703,11 @@ void AppController::setPreferencesAction()
         pref->setWebUIReverseProxySupportEnabled(it.value().toBool());
     if (hasKey("web_ui_reverse_proxies_list"))
         pref->setWebUITrustedReverseProxiesList(it.value().toString());
+    // OpenMetrics endpoint
+    if (hasKey("web_ui_metrics_enabled"))
+        pref->setWebUIMetricsEnabled(it.value().toBool());
+    if (hasKey("web_ui_metrics_auth_enabled"))
+        pref->setWebUIMetricsAuthEnabled(it.value().toBool());
     // Update my dynamic domain name
     if (hasKey("dyndns_enabled"))
         pref->setDynDNSEnabled(it.value().toBool());
@@ -741,6 +759,12 @@ void AppController::setPreferencesAction()
     // Save resume data interval
     if (hasKey("save_resume_data_interval"))
         session->setSaveResumeDataInterval(it.value().toInt());
+    if (hasKey("shutdown_timeout"))
+        session->setShutdownTimeout(it.value().toInt());
+    if (hasKey("memory_budget"))
+        session->setMemoryBudget(it.value().toInt());
+    if (hasKey("metadata_unload_delay"))
+        session->setMetadataUnloadDelay(it.value().toInt());
     // Recheck completed torrents
     if (hasKey("recheck_completed_torrents"))
         pref->recheckTorrentsOnCompletion(it.value().toBool());
@@ -750,6 +774,12 @@ void AppController::setPreferencesAction()
     // Reannounce to all trackers when ip/port changed
     if (hasKey("reannounce_when_address_changed"))
         session->setReannounceWhenAddressChangedEnabled(it.value().toBool());
+    // Concurrent storage moves per device
+    if (hasKey("max_concurrent_moves_per_device"))
+        session->setMaxConcurrentMovesPerDevice(it.value().toInt());
+    // Concurrent rechecks per device
+    if (hasKey("max_concurrent_checks_per_device"))
+        session->setMaxConcurrentChecksPerDevice(it.value().toInt());
 
     // libtorrent preferences
     // Async IO threads
@@ -912,3 +942,76 @@ void AppController::networkInterfaceAddressListAction()
 
     setResult(addressList);
 }
+
+// Returns the latency histograms of the instrumented code paths.
+// The list is empty unless the program was built with latency statistics.
+// Durations are in microseconds.
+void AppController::latencyStatsAction()
+{
+    QJsonArray result;
+    for (const LatencyStats::HistogramSnapshot &snapshot : asConst(LatencyStats::snapshots()))
+    {
+        result.append(QJsonObject {
+            {"name", snapshot.name},
+            {"count", static_cast<qint64>(snapshot.count)},
+            {"mean", static_cast<qint64>(snapshot.mean)},
+            {"p50", static_cast<qint64>(snapshot.p50)},
+            {"p90", static_cast<qint64>(snapshot.p90)},
+            {"p99", static_cast<qint64>(snapshot.p99)},
+            {"max", static_cast<qint64>(snapshot.max)}
+        });
+    }
+
+    setResult(result);
+}
+
+void AppController::resetLatencyStatsAction()
+{
+    LatencyStats::reset();
+}
+
+// Returns the approximate memory usage in JSON format.
+// The dictionary keys are:
+//   - "process_resident": Resident memory size of the process (-1 if unknown)
+//   - "process_private": Private memory size of the process, checked against the budget (-1 if unknown)
+//   - "total": Sum of the sizes of the accounted data structures
+//   - "budget": Memory budget (0 if not set)
+//   - "subsystems": List of the accounted data structures ("id", "name", "size")
+// All the sizes are in bytes.
+void AppController::memoryUsageAction()
+{
+    const QVector<MemoryStats::Entry> entries = MemoryStats::snapshot();
+
+    QJsonArray subsystems;
+    for (const MemoryStats::Entry &entry : entries)
+    {
+        subsystems.append(QJsonObject {
+            {"id", entry.id},
+            {"name", entry.name},
+            {"size", entry.size}
+        });
+    }
+
+    setResult(QJsonObject {
+        {"process_resident", MemoryStats::processResidentSize()},
+        {"process_private", MemoryStats::processPrivateSize()},
+        {"total", MemoryStats::totalSize(entries)},
+        {"budget", (static_cast<qint64>(BitTorrent::Session::instance()->memoryBudget()) * 1024 * 1024)},
+        {"subsystems", subsystems}
+    });
+}
+
+// Returns the state of loading the torrents of the previous session in JSON format.
+// The dictionary keys are:
+//   - "finished": Whether all the torrents are loaded
+//   - "loaded": Number of processed torrents
+//   - "total": Number of torrents to load
+void AppController::startupStatusAction()
+{
+    const BitTorrent::Session *session = BitTorrent::Session::instance();
+    setResult(QJsonObject {
+        {"finished", session->isStartupFinished()},
+        {"loaded", session->startupLoadedTorrentsCount()},
+        {"total", session->startupTorrentsCount()}
+    });
+}
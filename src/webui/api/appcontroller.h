@@ -44,6 +44,7 @@ private slots:
     void webapiVersionAction();
     void versionAction();
     void buildInfoAction();
+    void startupStatusAction();
     void shutdownAction();
     void preferencesAction();
     void setPreferencesAction();
@@ -51,4 +52,8 @@ private slots:
 
     void networkInterfaceListAction();
     void networkInterfaceAddressListAction();
+
+    void latencyStatsAction();
+    void resetLatencyStatsAction();
+    void memoryUsageAction();
 };
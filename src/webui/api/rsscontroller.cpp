@@ -186,7 +186,7 @@ void RSSController::matchingArticlesAction()
         QJsonArray matchingArticles;
         for (const RSS::Article *article : feed->articles())
         {
-            if (rule.matches(article->data()))
+            if (rule.matches(article->header()))
                 matchingArticles << article->title();
         }
         if (!matchingArticles.isEmpty())
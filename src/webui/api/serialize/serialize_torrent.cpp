@@ -37,51 +37,48 @@
 #include "base/tagset.h"
 #include "base/utils/fs.h"
 
-namespace
+QString torrentStateToString(const BitTorrent::TorrentState state)
 {
-    QString torrentStateToString(const BitTorrent::TorrentState state)
+    switch (state)
     {
-        switch (state)
-        {
-        case BitTorrent::TorrentState::Error:
-            return QLatin1String("error");
-        case BitTorrent::TorrentState::MissingFiles:
-            return QLatin1String("missingFiles");
-        case BitTorrent::TorrentState::Uploading:
-            return QLatin1String("uploading");
-        case BitTorrent::TorrentState::PausedUploading:
-            return QLatin1String("pausedUP");
-        case BitTorrent::TorrentState::QueuedUploading:
-            return QLatin1String("queuedUP");
-        case BitTorrent::TorrentState::StalledUploading:
-            return QLatin1String("stalledUP");
-        case BitTorrent::TorrentState::CheckingUploading:
-            return QLatin1String("checkingUP");
-        case BitTorrent::TorrentState::ForcedUploading:
-            return QLatin1String("forcedUP");
-        case BitTorrent::TorrentState::Downloading:
-            return QLatin1String("downloading");
-        case BitTorrent::TorrentState::DownloadingMetadata:
-            return QLatin1String("metaDL");
-        case BitTorrent::TorrentState::ForcedDownloadingMetadata:
-            return QLatin1String("forcedMetaDL");
-        case BitTorrent::TorrentState::PausedDownloading:
-            return QLatin1String("pausedDL");
-        case BitTorrent::TorrentState::QueuedDownloading:
-            return QLatin1String("queuedDL");
-        case BitTorrent::TorrentState::StalledDownloading:
-            return QLatin1String("stalledDL");
-        case BitTorrent::TorrentState::CheckingDownloading:
-            return QLatin1String("checkingDL");
-        case BitTorrent::TorrentState::ForcedDownloading:
-            return QLatin1String("forcedDL");
-        case BitTorrent::TorrentState::CheckingResumeData:
-            return QLatin1String("checkingResumeData");
-        case BitTorrent::TorrentState::Moving:
-            return QLatin1String("moving");
-        default:
-            return QLatin1String("unknown");
-        }
+    case BitTorrent::TorrentState::Error:
+        return QLatin1String("error");
+    case BitTorrent::TorrentState::MissingFiles:
+        return QLatin1String("missingFiles");
+    case BitTorrent::TorrentState::Uploading:
+        return QLatin1String("uploading");
+    case BitTorrent::TorrentState::PausedUploading:
+        return QLatin1String("pausedUP");
+    case BitTorrent::TorrentState::QueuedUploading:
+        return QLatin1String("queuedUP");
+    case BitTorrent::TorrentState::StalledUploading:
+        return QLatin1String("stalledUP");
+    case BitTorrent::TorrentState::CheckingUploading:
+        return QLatin1String("checkingUP");
+    case BitTorrent::TorrentState::ForcedUploading:
+        return QLatin1String("forcedUP");
+    case BitTorrent::TorrentState::Downloading:
+        return QLatin1String("downloading");
+    case BitTorrent::TorrentState::DownloadingMetadata:
+        return QLatin1String("metaDL");
+    case BitTorrent::TorrentState::ForcedDownloadingMetadata:
+        return QLatin1String("forcedMetaDL");
+    case BitTorrent::TorrentState::PausedDownloading:
+        return QLatin1String("pausedDL");
+    case BitTorrent::TorrentState::QueuedDownloading:
+        return QLatin1String("queuedDL");
+    case BitTorrent::TorrentState::StalledDownloading:
+        return QLatin1String("stalledDL");
+    case BitTorrent::TorrentState::CheckingDownloading:
+        return QLatin1String("checkingDL");
+    case BitTorrent::TorrentState::ForcedDownloading:
+        return QLatin1String("forcedDL");
+    case BitTorrent::TorrentState::CheckingResumeData:
+        return QLatin1String("checkingResumeData");
+    case BitTorrent::TorrentState::Moving:
+        return QLatin1String("moving");
+    default:
+        return QLatin1String("unknown");
     }
 }
 
@@ -33,6 +33,7 @@
 namespace BitTorrent
 {
     class Torrent;
+    enum class TorrentState;
 }
 
 // Torrent keys
@@ -86,4 +87,5 @@ inline const char KEY_TORRENT_TIME_ACTIVE[] = "time_active";
 inline const char KEY_TORRENT_SEEDING_TIME[] = "seeding_time";
 inline const char KEY_TORRENT_AVAILABILITY[] = "availability";
 
+QString torrentStateToString(BitTorrent::TorrentState state);
 QVariantMap serialize(const BitTorrent::Torrent &torrent);
@@ -56,6 +56,7 @@ namespace
     // Sync main data keys
     const char KEY_SYNC_MAINDATA_QUEUEING[] = "queueing";
     const char KEY_SYNC_MAINDATA_REFRESH_INTERVAL[] = "refresh_interval";
+    const char KEY_SYNC_MAINDATA_STARTUP_PROGRESS[] = "startup_progress";
     const char KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS[] = "use_alt_speed_limits";
 
     // Sync torrent peers keys
@@ -526,6 +527,8 @@ void SyncController::maindataAction()
     serverState[KEY_SYNC_MAINDATA_QUEUEING] = session->isQueueingSystemEnabled();
     serverState[KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS] = session->isAltGlobalSpeedLimitEnabled();
     serverState[KEY_SYNC_MAINDATA_REFRESH_INTERVAL] = session->refreshInterval();
+    serverState[KEY_SYNC_MAINDATA_STARTUP_PROGRESS] = (session->isStartupFinished() || (session->startupTorrentsCount() == 0))
+        ? 1.0 : (static_cast<qreal>(session->startupLoadedTorrentsCount()) / session->startupTorrentsCount());
     data["server_state"] = serverState;
 
     const int acceptedResponseId {params()["rid"].toInt()};
@@ -553,7 +556,7 @@ void SyncController::torrentPeersAction()
 
     const QVector<BitTorrent::PeerInfo> peersList = torrent->peers();
 
-    bool resolvePeerCountries = Preferences::instance()->resolvePeerCountries();
+    const bool resolvePeerCountries = Preferences::instance()->snapshot().resolvePeerCountries;
 
     data[KEY_SYNC_TORRENT_PEERS_SHOW_FLAGS] = resolvePeerCountries;
 
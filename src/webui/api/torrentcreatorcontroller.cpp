@@ -0,0 +1,235 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentcreatorcontroller.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QVector>
+
+#include "base/bittorrent/torrentcreationmanager.h"
+#include "base/http/types.h"
+#include "base/global.h"
+#include "base/utils/fs.h"
+#include "base/utils/string.h"
+#include "apierror.h"
+
+const char KEY_TASK_ID[] = "taskID";
+const char KEY_SOURCE_PATH[] = "sourcePath";
+const char KEY_TORRENT_FILE_PATH[] = "torrentFilePath";
+const char KEY_PIECE_SIZE[] = "pieceSize";
+const char KEY_PRIVATE[] = "private";
+const char KEY_STATUS[] = "status";
+const char KEY_PROGRESS[] = "progress";
+const char KEY_TIME_ADDED[] = "timeAdded";
+const char KEY_TIME_STARTED[] = "timeStarted";
+const char KEY_TIME_FINISHED[] = "timeFinished";
+const char KEY_ERROR_MESSAGE[] = "errorMessage";
+
+namespace
+{
+    using BitTorrent::TorrentCreationTask;
+
+    QString taskStateToString(const TorrentCreationTask::State state)
+    {
+        switch (state)
+        {
+        case TorrentCreationTask::State::Queued:
+            return QLatin1String("Queued");
+        case TorrentCreationTask::State::Running:
+            return QLatin1String("Running");
+        case TorrentCreationTask::State::Finished:
+            return QLatin1String("Finished");
+        case TorrentCreationTask::State::Failed:
+            return QLatin1String("Failed");
+        }
+        return {};
+    }
+
+    QJsonObject taskToJson(const TorrentCreationTask *task)
+    {
+        QJsonObject obj
+        {
+            {KEY_TASK_ID, task->id()},
+            {KEY_SOURCE_PATH, Utils::Fs::toNativePath(task->params().inputPath)},
+            {KEY_TORRENT_FILE_PATH, Utils::Fs::toNativePath(task->params().savePath)},
+            {KEY_PIECE_SIZE, task->params().pieceSize},
+            {KEY_PRIVATE, task->params().isPrivate},
+            {KEY_STATUS, taskStateToString(task->state())},
+            {KEY_PROGRESS, task->progress()},
+            {KEY_TIME_ADDED, task->timeAdded().toSecsSinceEpoch()}
+        };
+
+        if (task->timeStarted().isValid())
+            obj[KEY_TIME_STARTED] = task->timeStarted().toSecsSinceEpoch();
+        if (task->timeFinished().isValid())
+            obj[KEY_TIME_FINISHED] = task->timeFinished().toSecsSinceEpoch();
+        if (task->state() == TorrentCreationTask::State::Failed)
+            obj[KEY_ERROR_MESSAGE] = task->errorMessage();
+
+        return obj;
+    }
+
+    TorrentCreationTask *findTask(const QString &id)
+    {
+        TorrentCreationTask *task = BitTorrent::TorrentCreationManager::instance()->task(id);
+        if (!task)
+            throw APIError(APIErrorType::NotFound);
+        return task;
+    }
+}
+
+// Queues a new torrent creation task.
+// Returns {"taskID": <id>}.
+// POST params:
+//   - sourcePath (string): file or folder to create the torrent from
+//   - torrentFilePath (string): where to store the torrent file (default: temporary file)
+//   - pieceSize (int): piece size in bytes (default 0 = automatic)
+//   - private (bool): default false
+//   - format (string): "v1", "v2" or "hybrid" (libtorrent 2.0 only, default "hybrid")
+//   - optimizeAlignment (bool): libtorrent 1.2 only, default true
+//   - paddedFileSizeLimit (int): libtorrent 1.2 only, default -1
+//   - comment (string)
+//   - source (string)
+//   - trackers (string): tracker URLs separated by '\n', an empty line starts a new tier
+//   - urlSeeds (string): web seed URLs separated by '\n'
+void TorrentCreatorController::addTaskAction()
+{
+    requireParams({KEY_SOURCE_PATH});
+
+    const QString sourcePath = Utils::Fs::toUniformPath(params()[KEY_SOURCE_PATH].trimmed());
+    if (sourcePath.isEmpty() || !QFileInfo::exists(sourcePath))
+        throw APIError(APIErrorType::BadParams, tr("Source path is invalid"));
+
+    const QString torrentFilePath = Utils::Fs::toUniformPath(params()[KEY_TORRENT_FILE_PATH].trimmed());
+    if (!torrentFilePath.isEmpty() && QFileInfo(torrentFilePath).isRelative())
+        throw APIError(APIErrorType::BadParams, tr("Torrent file path must be absolute"));
+
+    const int pieceSize = params()[KEY_PIECE_SIZE].toInt();
+    if (pieceSize < 0)
+        throw APIError(APIErrorType::BadParams, tr("Piece size is invalid"));
+
+#ifdef QBT_USES_LIBTORRENT2
+    const QString formatParam = params()[QLatin1String("format")].toLower();
+    BitTorrent::TorrentFormat torrentFormat = BitTorrent::TorrentFormat::Hybrid;
+    if (formatParam == QLatin1String("v1"))
+        torrentFormat = BitTorrent::TorrentFormat::V1;
+    else if (formatParam == QLatin1String("v2"))
+        torrentFormat = BitTorrent::TorrentFormat::V2;
+    else if (!formatParam.isEmpty() && (formatParam != QLatin1String("hybrid")))
+        throw APIError(APIErrorType::BadParams, tr("Torrent format is invalid"));
+#else
+    const bool isAlignmentOptimized = Utils::String::parseBool(params()[QLatin1String("optimizeAlignment")]).value_or(true);
+    bool ok = false;
+    int paddedFileSizeLimit = params()[QLatin1String("paddedFileSizeLimit")].toInt(&ok);
+    if (!ok)
+        paddedFileSizeLimit = -1;
+#endif
+
+    const QStringList trackers = params()[QLatin1String("trackers")].trimmed().split(QLatin1Char('\n'));
+    const QStringList urlSeeds = params()[QLatin1String("urlSeeds")].split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+
+    const BitTorrent::TorrentCreatorParams creatorParams
+    {
+        Utils::String::parseBool(params()[KEY_PRIVATE]).value_or(false)
+#ifdef QBT_USES_LIBTORRENT2
+        , torrentFormat
+#else
+        , isAlignmentOptimized
+        , paddedFileSizeLimit
+#endif
+        , pieceSize
+        , sourcePath, torrentFilePath
+        , params()[QLatin1String("comment")]
+        , params()[QLatin1String("source")]
+        , (trackers == QStringList {QString()} ? QStringList {} : trackers)
+        , urlSeeds
+    };
+
+    const QString taskID = BitTorrent::TorrentCreationManager::instance()->addTask(creatorParams);
+    setResult(QJsonObject {{KEY_TASK_ID, taskID}});
+}
+
+// Returns the state of torrent creation tasks as an array of dictionaries.
+// The dictionary keys are:
+//   - "taskID", "sourcePath", "torrentFilePath", "pieceSize", "private"
+//   - "status": "Queued", "Running", "Finished" or "Failed"
+//   - "progress": 0-100
+//   - "timeAdded", "timeStarted", "timeFinished": seconds since epoch (only when set)
+//   - "errorMessage": only for failed tasks
+// GET params:
+//   - taskID (string): only return the given task (default: all tasks)
+void TorrentCreatorController::statusAction()
+{
+    const QString id = params()[KEY_TASK_ID];
+
+    QJsonArray result;
+    if (!id.isEmpty())
+    {
+        result.append(taskToJson(findTask(id)));
+    }
+    else
+    {
+        for (const TorrentCreationTask *task : asConst(BitTorrent::TorrentCreationManager::instance()->tasks()))
+            result.append(taskToJson(task));
+    }
+
+    setResult(result);
+}
+
+// Returns the created torrent file.
+// GET params:
+//   - taskID (string)
+void TorrentCreatorController::torrentFileAction()
+{
+    requireParams({KEY_TASK_ID});
+
+    const TorrentCreationTask *task = findTask(params()[KEY_TASK_ID]);
+    if (task->state() != TorrentCreationTask::State::Finished)
+        throw APIError(APIErrorType::Conflict, tr("Torrent creation is still unfinished or it failed"));
+
+    QFile torrentFile {task->params().savePath};
+    if (!torrentFile.open(QIODevice::ReadOnly))
+        throw APIError(APIErrorType::Conflict, tr("Couldn't read torrent file. Reason: %1").arg(torrentFile.errorString()));
+
+    setResult(torrentFile.readAll(), QLatin1String(Http::CONTENT_TYPE_BITTORRENT));
+}
+
+// Removes a task, interrupting it if it is running.
+// Torrent files stored in the temporary folder are removed as well.
+// POST params:
+//   - taskID (string)
+void TorrentCreatorController::deleteTaskAction()
+{
+    requireParams({KEY_TASK_ID});
+
+    if (!BitTorrent::TorrentCreationManager::instance()->deleteTask(params()[KEY_TASK_ID]))
+        throw APIError(APIErrorType::NotFound);
+}
@@ -115,6 +115,16 @@ const char KEY_FILE_IS_SEED[] = "is_seed";
 const char KEY_FILE_PIECE_RANGE[] = "piece_range";
 const char KEY_FILE_AVAILABILITY[] = "availability";
 
+// Storage move job keys
+const char KEY_MOVE_JOB_HASH[] = "hash";
+const char KEY_MOVE_JOB_NAME[] = "name";
+const char KEY_MOVE_JOB_SOURCE_PATH[] = "source_path";
+const char KEY_MOVE_JOB_DESTINATION_PATH[] = "destination_path";
+const char KEY_MOVE_JOB_TOTAL_SIZE[] = "total_size";
+const char KEY_MOVE_JOB_MOVED_SIZE[] = "moved_size";
+const char KEY_MOVE_JOB_PROGRESS[] = "progress";
+const char KEY_MOVE_JOB_IS_ACTIVE[] = "active";
+
 namespace
 {
     using Utils::String::parseBool;
@@ -516,10 +526,12 @@ void TorrentsController::filesAction()
     requireParams({"hash"});
 
     const auto id = BitTorrent::TorrentID::fromString(params()["hash"]);
-    const BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->findTorrent(id);
+    BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->findTorrent(id);
     if (!torrent)
         throw APIError(APIErrorType::NotFound);
 
+    torrent->loadMetadata();
+
     const int filesCount = torrent->filesCount();
     QVector<int> fileIndexes;
     const auto idxIt = params().constFind(QLatin1String("indexes"));
@@ -593,6 +605,8 @@ void TorrentsController::pieceHashesAction()
     if (!torrent)
         throw APIError(APIErrorType::NotFound);
 
+    torrent->loadMetadata();
+
     QJsonArray pieceHashes;
     const QVector<QByteArray> hashes = torrent->info().pieceHashes();
     for (const QByteArray &hash : hashes)
@@ -615,16 +629,20 @@ void TorrentsController::pieceStatesAction()
     if (!torrent)
         throw APIError(APIErrorType::NotFound);
 
-    QJsonArray pieceStates;
-    const QBitArray states = torrent->pieces();
-    for (int i = 0; i < states.size(); ++i)
-        pieceStates.append(static_cast<int>(states[i]) * 2);
+    torrent->loadMetadata();
 
+    const QBitArray states = torrent->pieces();
     const QBitArray dlstates = torrent->downloadingPieces();
+
+    // build the array in a single pass instead of patching downloading
+    // pieces into an already populated QJsonArray
+    QJsonArray pieceStates;
     for (int i = 0; i < states.size(); ++i)
     {
-        if (dlstates[i])
-            pieceStates[i] = 1;
+        if ((i < dlstates.size()) && dlstates.testBit(i))
+            pieceStates.append(1);
+        else
+            pieceStates.append(states.testBit(i) ? 2 : 0);
     }
 
     setResult(pieceStates);
@@ -879,6 +897,8 @@ void TorrentsController::filePrioAction()
     if (!torrent->hasMetadata())
         throw APIError(APIErrorType::Conflict, tr("Torrent's metadata has not yet downloaded"));
 
+    torrent->loadMetadata();
+
     const int filesCount = torrent->filesCount();
     QVector<BitTorrent::DownloadPriority> priorities = torrent->filePriorities();
     bool priorityChanged = false;
@@ -1096,6 +1116,36 @@ void TorrentsController::setLocationAction()
     });
 }
 
+// Returns the queued and active storage move jobs.
+// The return value is an array of dictionaries, one per job in queue order.
+// The dictionary keys are:
+//   - "hash": torrent hash
+//   - "name": torrent name
+//   - "source_path", "destination_path"
+//   - "total_size": bytes to move
+//   - "moved_size": bytes already present in the destination folder
+//   - "progress": moved_size / total_size (0 for queued jobs)
+//   - "active": true if the job is running
+void TorrentsController::moveJobsAction()
+{
+    QJsonArray result;
+    for (const BitTorrent::MoveStorageJobStatus &job : asConst(BitTorrent::Session::instance()->moveStorageJobs()))
+    {
+        result.append(QJsonObject {
+            {KEY_MOVE_JOB_HASH, job.torrentID.toString()},
+            {KEY_MOVE_JOB_NAME, job.name},
+            {KEY_MOVE_JOB_SOURCE_PATH, Utils::Fs::toNativePath(job.sourcePath)},
+            {KEY_MOVE_JOB_DESTINATION_PATH, Utils::Fs::toNativePath(job.destinationPath)},
+            {KEY_MOVE_JOB_TOTAL_SIZE, job.totalSize},
+            {KEY_MOVE_JOB_MOVED_SIZE, job.movedSize},
+            {KEY_MOVE_JOB_PROGRESS, ((job.totalSize > 0) ? (static_cast<double>(job.movedSize) / job.totalSize) : 0.)},
+            {KEY_MOVE_JOB_IS_ACTIVE, job.isActive}
+        });
+    }
+
+    setResult(result);
+}
+
 void TorrentsController::renameAction()
 {
     requireParams({"hash", "name"});
@@ -1295,6 +1345,8 @@ void TorrentsController::renameFileAction()
     const QString oldPath = params()["oldPath"];
     const QString newPath = params()["newPath"];
 
+    torrent->loadMetadata();
+
     try
     {
         torrent->renameFile(oldPath, newPath);
@@ -1317,6 +1369,8 @@ void TorrentsController::renameFolderAction()
     const QString oldPath = params()["oldPath"];
     const QString newPath = params()["newPath"];
 
+    torrent->loadMetadata();
+
     try
     {
         torrent->renameFolder(oldPath, newPath);
@@ -78,6 +78,7 @@ private slots:
     void topPrioAction();
     void bottomPrioAction();
     void setLocationAction();
+    void moveJobsAction();
     void setAutoManagementAction();
     void setSuperSeedingAction();
     void setForceStartAction();
@@ -28,12 +28,19 @@
 
 #include "transfercontroller.h"
 
+#include <algorithm>
+#include <chrono>
+
+#include <QDateTime>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QVector>
 
 #include "base/bittorrent/peeraddress.h"
 #include "base/bittorrent/peerinfo.h"
+#include "base/bittorrent/recheckscheduler.h"
 #include "base/bittorrent/session.h"
+#include "base/bittorrent/transferhistory.h"
 #include "base/global.h"
 #include "apierror.h"
 
@@ -46,6 +53,18 @@ const char KEY_TRANSFER_UPRATELIMIT[] = "up_rate_limit";
 const char KEY_TRANSFER_DHT_NODES[] = "dht_nodes";
 const char KEY_TRANSFER_CONNECTION_STATUS[] = "connection_status";
 
+const char KEY_RECHECK_QUEUED[] = "queued";
+const char KEY_RECHECK_RUNNING[] = "running";
+const char KEY_RECHECK_FINISHED[] = "finished";
+const char KEY_RECHECK_TOTAL_SIZE[] = "total_size";
+const char KEY_RECHECK_CHECKED_SIZE[] = "checked_size";
+const char KEY_RECHECK_SPEED[] = "speed";
+const char KEY_RECHECK_ETA[] = "eta";
+
+const char KEY_HISTORY_RESOLUTION[] = "resolution";
+const char KEY_HISTORY_SAMPLES[] = "samples";
+const char KEY_HISTORY_TORRENTS[] = "torrents";
+
 // Returns the global transfer information in JSON format.
 // The return value is a JSON-formatted dictionary.
 // The dictionary keys are:
@@ -122,10 +141,118 @@ void TransferController::banPeersAction()
     requireParams({"peers"});
 
     const QStringList peers = params()["peers"].split('|');
+    QStringList ips;
+    ips.reserve(peers.size());
     for (const QString &peer : peers)
     {
         const BitTorrent::PeerAddress addr = BitTorrent::PeerAddress::parse(peer.trimmed());
         if (!addr.ip.isNull())
-            BitTorrent::Session::instance()->banIP(addr.ip.toString());
+            ips.append(addr.ip.toString());
+    }
+
+    BitTorrent::Session::instance()->banIPs(ips);
+}
+
+void TransferController::unbanPeersAction()
+{
+    requireParams({"ips"});
+
+    const QStringList ips = params()["ips"].split('|', Qt::SkipEmptyParts);
+    BitTorrent::Session::instance()->unbanIPs(ips);
+}
+
+// Returns the progress of the current batch of forced rechecks in JSON format.
+// The dictionary keys are:
+//   - "queued": Number of rechecks waiting for their storage device
+//   - "running": Number of running rechecks
+//   - "finished": Number of finished rechecks
+//   - "total_size": Size of all the torrents of the batch
+//   - "checked_size": Checked bytes
+//   - "speed": Bytes checked per second
+//   - "eta": Estimated seconds until the batch is finished, -1 if unknown
+void TransferController::recheckStatusAction()
+{
+    const BitTorrent::RecheckStatus status = BitTorrent::Session::instance()->recheckStatus();
+
+    setResult(QJsonObject {
+        {KEY_RECHECK_QUEUED, status.queuedCount},
+        {KEY_RECHECK_RUNNING, status.runningCount},
+        {KEY_RECHECK_FINISHED, status.finishedCount},
+        {KEY_RECHECK_TOTAL_SIZE, status.totalSize},
+        {KEY_RECHECK_CHECKED_SIZE, status.checkedSize},
+        {KEY_RECHECK_SPEED, status.speed},
+        {KEY_RECHECK_ETA, status.eta}
+    });
+}
+
+// Returns the transfer rate history of the session in JSON format.
+// GET param:
+//   - period (int): number of seconds to return the history for, defaults to 300
+//     The history is returned with the resolution of the shortest kept span covering the period.
+// The dictionary keys are:
+//   - "resolution": Averaging interval of the samples in milliseconds
+//   - "samples": Array of samples, oldest first. Each sample is an array of
+//     the end time (milliseconds since epoch), the averaging interval (milliseconds) and
+//     the rates in bytes per second: upload, download, payload upload, payload download,
+//     overhead upload, overhead download, DHT upload, DHT download, tracker upload, tracker download
+//   - "torrents": Dictionary of the recent payload rates of the most active torrents
+//     by torrent hash. Each sample is an array of the time, upload and download rates.
+void TransferController::historyAction()
+{
+    using BitTorrent::TransferHistory;
+
+    std::chrono::seconds period = std::chrono::minutes {5};
+    const QString periodParam = params()["period"];
+    if (!periodParam.isEmpty())
+    {
+        bool ok = false;
+        period = std::chrono::seconds {periodParam.toLongLong(&ok)};
+        if (!ok || (period.count() <= 0))
+            throw APIError(APIErrorType::BadParams, tr("'period' must be a positive number of seconds"));
+
+        // No history is kept beyond the longest span
+        period = std::min(period, std::chrono::duration_cast<std::chrono::seconds>(
+            TransferHistory::spanDuration(TransferHistory::Span24Hour)));
+    }
+
+    auto span = TransferHistory::Span5Min;
+    while ((span < TransferHistory::Span24Hour) && (TransferHistory::spanDuration(span) < period))
+        span = static_cast<TransferHistory::Span>(span + 1);
+
+    const TransferHistory *history = BitTorrent::Session::instance()->transferHistory();
+    const qint64 startTime = QDateTime::currentMSecsSinceEpoch()
+        - std::chrono::duration_cast<std::chrono::milliseconds>(period).count();
+
+    QJsonArray samples;
+    for (const TransferHistory::Sample &sample : history->samples(span))
+    {
+        if (sample.timestamp < startTime)
+            continue;
+
+        QJsonArray sampleArray {sample.timestamp, sample.duration};
+        for (const quint64 rate : sample.rates)
+            sampleArray.append(static_cast<qint64>(rate));
+        samples.append(sampleArray);
+    }
+
+    QJsonObject torrents;
+    const QHash<BitTorrent::TorrentID, TransferHistory::TorrentSampleBuffer> &torrentSamples = history->torrentSamples();
+    for (auto it = torrentSamples.cbegin(); it != torrentSamples.cend(); ++it)
+    {
+        QJsonArray torrentArray;
+        for (const TransferHistory::TorrentSample &sample : it.value())
+        {
+            if (sample.timestamp >= startTime)
+                torrentArray.append(QJsonArray {sample.timestamp, static_cast<qint64>(sample.upload), static_cast<qint64>(sample.download)});
+        }
+
+        if (!torrentArray.isEmpty())
+            torrents[it.key().toString()] = torrentArray;
     }
+
+    setResult(QJsonObject {
+        {KEY_HISTORY_RESOLUTION, static_cast<qint64>(TransferHistory::spanResolution(span).count())},
+        {KEY_HISTORY_SAMPLES, samples},
+        {KEY_HISTORY_TORRENTS, torrents}
+    });
 }
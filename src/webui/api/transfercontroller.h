@@ -47,4 +47,7 @@ private slots:
     void setUploadLimitAction();
     void setDownloadLimitAction();
     void banPeersAction();
+    void unbanPeersAction();
+    void recheckStatusAction();
+    void historyAction();
 };
@@ -0,0 +1,123 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "metricsexporter.h"
+
+#include <algorithm>
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/torrent.h"
+#include "base/global.h"
+#include "api/serialize/serialize_torrent.h"
+
+namespace
+{
+    void writeType(QByteArray &out, const QByteArray &name, const bool isGauge)
+    {
+        out.append("# TYPE ").append(name).append(isGauge ? " gauge\n" : " counter\n");
+    }
+
+    void writeSample(QByteArray &out, const QByteArray &name, const bool isGauge, const qint64 value, const QByteArray &labels = {})
+    {
+        out.append(name);
+        if (!isGauge)
+            out.append("_total");
+        if (!labels.isEmpty())
+            out.append('{').append(labels).append('}');
+        out.append(' ').append(QByteArray::number(value)).append('\n');
+    }
+
+    void writeMetric(QByteArray &out, const QByteArray &name, const bool isGauge, const qint64 value)
+    {
+        writeType(out, name, isGauge);
+        writeSample(out, name, isGauge, value);
+    }
+}
+
+void MetricsExporter::countAPIRequest(const QString &scope, const QString &action)
+{
+    ++m_apiRequestCounts[scope + QLatin1Char('/') + action];
+}
+
+QByteArray MetricsExporter::render() const
+{
+    const auto *session = BitTorrent::Session::instance();
+
+    QByteArray out;
+    out.reserve(64 * 1024);
+
+    // libtorrent counters, e.g. "net.sent_bytes" is exported as "libtorrent_net_sent_bytes"
+    const QVector<BitTorrent::SessionStatsMetric> &metrics = session->sessionStatsMetrics();
+    const QVector<qint64> &counters = session->sessionStatsCounters();
+    QByteArray name;
+    for (int i = 0; i < std::min(metrics.size(), counters.size()); ++i)
+    {
+        const BitTorrent::SessionStatsMetric &metric = metrics[i];
+        if (metric.name.isEmpty())
+            continue;
+
+        name = "libtorrent_" + metric.name;
+        name.replace('.', '_');
+        writeMetric(out, name, metric.isGauge, counters[i]);
+    }
+
+    // Torrents by state
+    QHash<BitTorrent::TorrentState, int> torrentCounts;
+    for (const BitTorrent::Torrent *torrent : asConst(session->torrents()))
+        ++torrentCounts[torrent->state()];
+
+    const QByteArray torrentsName = "qbittorrent_torrents";
+    writeType(out, torrentsName, true);
+    for (int state = static_cast<int>(BitTorrent::TorrentState::Unknown); state <= static_cast<int>(BitTorrent::TorrentState::Error); ++state)
+    {
+        const auto torrentState = static_cast<BitTorrent::TorrentState>(state);
+        writeSample(out, torrentsName, true, torrentCounts.value(torrentState)
+            , "state=\"" + torrentStateToString(torrentState).toLatin1() + '"');
+    }
+
+    writeMetric(out, "qbittorrent_resume_data_pending", true, session->pendingResumeDataCount());
+    writeMetric(out, "qbittorrent_alert_queue_overflows", false, static_cast<qint64>(session->droppedAlertsCount()));
+
+    // WebAPI requests. Scopes and actions are restricted to [A-Za-z_0-9] so they need no escaping.
+    const QByteArray apiRequestsName = "qbittorrent_api_requests";
+    writeType(out, apiRequestsName, false);
+    for (auto it = m_apiRequestCounts.cbegin(); it != m_apiRequestCounts.cend(); ++it)
+    {
+        const int separatorPos = it.key().indexOf(QLatin1Char('/'));
+        const QByteArray labels = "scope=\"" + it.key().left(separatorPos).toLatin1()
+            + "\",action=\"" + it.key().mid(separatorPos + 1).toLatin1() + '"';
+        writeSample(out, apiRequestsName, false, static_cast<qint64>(it.value()), labels);
+    }
+
+    out.append("# EOF\n");
+    return out;
+}
@@ -44,7 +44,9 @@
 #include "base/algorithm.h"
 #include "base/global.h"
 #include "base/http/httperror.h"
+#include "base/latencystats.h"
 #include "base/logger.h"
+#include "base/memorystats.h"
 #include "base/preferences.h"
 #include "base/types.h"
 #include "base/utils/bytearray.h"
@@ -60,6 +62,7 @@
 #include "api/schedulecontroller.h"
 #include "api/searchcontroller.h"
 #include "api/synccontroller.h"
+#include "api/torrentcreatorcontroller.h"
 #include "api/torrentscontroller.h"
 #include "api/transfercontroller.h"
 
@@ -70,6 +73,7 @@ const QString PATH_PREFIX_ICONS {QStringLiteral("/icons/")};
 const QString WWW_FOLDER {QStringLiteral(":/www")};
 const QString PUBLIC_FOLDER {QStringLiteral("/public")};
 const QString PRIVATE_FOLDER {QStringLiteral("/private")};
+const QString PATH_METRICS {QStringLiteral("/metrics")};
 
 namespace
 {
@@ -128,6 +132,7 @@ WebApplication::WebApplication(QObject *parent)
     registerAPIController(QLatin1String("schedule"), new ScheduleController(this, this));
     registerAPIController(QLatin1String("search"), new SearchController(this, this));
     registerAPIController(QLatin1String("sync"), new SyncController(this, this));
+    registerAPIController(QLatin1String("torrentcreator"), new TorrentCreatorController(this, this));
     registerAPIController(QLatin1String("torrents"), new TorrentsController(this, this));
     registerAPIController(QLatin1String("transfer"), new TransferController(this, this));
 
@@ -135,10 +140,20 @@ WebApplication::WebApplication(QObject *parent)
 
     configure();
     connect(Preferences::instance(), &Preferences::changed, this, &WebApplication::configure);
+
+    MemoryStats::registerProvider(QLatin1String("webui/sessions"), tr("Web UI sessions"), [this]()
+    {
+        qint64 size = 0;
+        for (const WebSession *session : asConst(m_sessions))
+            size += session->memoryUsage();
+        return size;
+    });
 }
 
 WebApplication::~WebApplication()
 {
+    MemoryStats::unregisterProvider(QLatin1String("webui/sessions"));
+
     // cleanup sessions data
     qDeleteAll(m_sessions);
 }
@@ -205,6 +220,17 @@ void WebApplication::sendWebUIFile()
     sendFile(localPath);
 }
 
+void WebApplication::sendMetrics()
+{
+    if (!m_isMetricsEnabled)
+        throw NotFoundHTTPError();
+    // Scrapers usually can't log in, so they should be whitelisted or the authentication be disabled
+    if (m_isMetricsAuthEnabled && !session())
+        throw ForbiddenHTTPError();
+
+    print(m_metricsExporter.render(), Http::CONTENT_TYPE_OPENMETRICS);
+}
+
 void WebApplication::translateDocument(QString &data) const
 {
     const QRegularExpression regex("QBT_TR\\((([^\\)]|\\)(?!QBT_TR))+)\\)QBT_TR\\[CONTEXT=([a-zA-Z_][a-zA-Z0-9_]*)\\]");
@@ -261,6 +287,12 @@ const Http::Environment &WebApplication::env() const
 
 void WebApplication::doProcessRequest()
 {
+    if (request().path == PATH_METRICS)
+    {
+        sendMetrics();
+        return;
+    }
+
     const QRegularExpressionMatch match = m_apiPathPattern.match(request().path);
     if (!match.hasMatch())
     {
@@ -278,21 +310,33 @@ void WebApplication::doProcessRequest()
     if (!session() && !isPublicAPI(scope, action))
         throw ForbiddenHTTPError();
 
+    // Count only the existing actions, so that the metrics can't be flooded with made up ones
+    const QByteArray slotSignature = action.toLatin1() + "Action()";
+    const bool isExistingAction = (controller->metaObject()->indexOfSlot(slotSignature.constData()) >= 0);
+    if (isExistingAction)
+        m_metricsExporter.countAPIRequest(scope, action);
+
     DataMap data;
     for (const Http::UploadedFile &torrent : request().files)
         data[torrent.filename] = torrent.data;
 
     try
     {
-        const QVariant result = controller->run(action, m_params, data);
-        switch (result.userType())
+        QBT_MEASURE_LATENCY_OF(LatencyStats::histogram(isExistingAction
+            ? QString(QLatin1String("api/") + scope + QLatin1Char('/') + action)
+            : QStringLiteral("api/unknown")));
+        const APIResult result = controller->run(action, m_params, data);
+        switch (result.data.userType())
         {
         case QMetaType::QJsonDocument:
-            print(result.toJsonDocument().toJson(QJsonDocument::Compact), Http::CONTENT_TYPE_JSON);
+            print(result.data.toJsonDocument().toJson(QJsonDocument::Compact), Http::CONTENT_TYPE_JSON);
+            break;
+        case QMetaType::QByteArray:
+            print(result.data.toByteArray(), result.mimeType);
             break;
         case QMetaType::QString:
         default:
-            print(result.toString(), Http::CONTENT_TYPE_TXT);
+            print(result.data.toString(), Http::CONTENT_TYPE_TXT);
             break;
         }
     }
@@ -358,6 +402,9 @@ void WebApplication::configure()
     m_authSubnetWhitelist = pref->getWebUiAuthSubnetWhitelist();
     m_sessionTimeout = pref->getWebUISessionTimeout();
 
+    m_isMetricsEnabled = pref->isWebUIMetricsEnabled();
+    m_isMetricsAuthEnabled = pref->isWebUIMetricsAuthEnabled();
+
     m_domainList = pref->getServerDomains().split(';', Qt::SkipEmptyParts);
     std::for_each(m_domainList.begin(), m_domainList.end(), [](QString &entry) { entry = entry.trimmed(); });
 
@@ -796,3 +843,12 @@ void WebSession::setData(const QString &id, const QVariant &data)
 {
     m_data[id] = data;
 }
+
+qint64 WebSession::memoryUsage() const
+{
+    // The sync snapshots share a lot of their data, so this overestimates
+    qint64 size = sizeof(WebSession);
+    for (auto i = m_data.cbegin(); i != m_data.cend(); ++i)
+        size += MemoryStats::estimateSize(i.key()) + MemoryStats::estimateSize(i.value());
+    return size;
+}
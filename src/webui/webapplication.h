@@ -42,8 +42,9 @@
 #include "base/http/types.h"
 #include "base/utils/net.h"
 #include "base/utils/version.h"
+#include "metricsexporter.h"
 
-inline const Utils::Version<int, 3, 2> API_VERSION {2, 8, 3};
+inline const Utils::Version<int, 3, 2> API_VERSION {2, 9, 9};
 
 class APIController;
 class WebApplication;
@@ -61,6 +62,9 @@ public:
     QVariant getData(const QString &id) const override;
     void setData(const QString &id, const QVariant &data) override;
 
+    // Approximate size of the session data in bytes
+    qint64 memoryUsage() const;
+
 private:
     const QString m_sid;
     QElapsedTimer m_timer;  // timestamp
@@ -102,6 +106,7 @@ private:
 
     void sendFile(const QString &path);
     void sendWebUIFile();
+    void sendMetrics();
 
     void translateDocument(QString &data) const;
 
@@ -129,6 +134,9 @@ private:
     const QRegularExpression m_apiPathPattern {QLatin1String("^/api/v2/(?<scope>[A-Za-z_][A-Za-z_0-9]*)/(?<action>[A-Za-z_][A-Za-z_0-9]*)$")};
 
     QHash<QString, APIController *> m_apiControllers;
+    MetricsExporter m_metricsExporter;
+    bool m_isMetricsEnabled = false;
+    bool m_isMetricsAuthEnabled = true;
     QSet<QString> m_publicAPIs;
     bool m_isAltUIUsed = false;
     QString m_rootFolder;
@@ -10,9 +10,11 @@ HEADERS += \
     $$PWD/api/schedulecontroller.h \
     $$PWD/api/searchcontroller.h \
     $$PWD/api/synccontroller.h \
+    $$PWD/api/torrentcreatorcontroller.h \
     $$PWD/api/torrentscontroller.h \
     $$PWD/api/transfercontroller.h \
     $$PWD/api/serialize/serialize_torrent.h \
+    $$PWD/metricsexporter.h \
     $$PWD/webapplication.h \
     $$PWD/webui.h
 
@@ -27,9 +29,11 @@ SOURCES += \
     $$PWD/api/schedulecontroller.cpp \
     $$PWD/api/searchcontroller.cpp \
     $$PWD/api/synccontroller.cpp \
+    $$PWD/api/torrentcreatorcontroller.cpp \
     $$PWD/api/torrentscontroller.cpp \
     $$PWD/api/transfercontroller.cpp \
     $$PWD/api/serialize/serialize_torrent.cpp \
+    $$PWD/metricsexporter.cpp \
     $$PWD/webapplication.cpp \
     $$PWD/webui.cpp
 